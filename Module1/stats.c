@@ -14,7 +14,13 @@
  *
  * This file contains functions to analyze unsigned char arrays:
  * - Calculate statistics (min, max, mean, median)
- * - Sort arrays in descending order
+ * - Accumulate arbitrarily long sample streams in a 256-bin histogram
+ *   (binary blocks or decimal text) and report the same statistics, with
+ *   an exact median, in constant memory
+ * - main(): a CLI reading samples from stdin (see usage), or the original
+ *   40-sample demo
+ * - Sort arrays in descending order (insertion sort, introsort or counting
+ *   sort depending on the size)
  * - Print formatted results
  * All statistics are rounded down to nearest integer.
  *
@@ -26,15 +32,42 @@
  *
  *****************************************************************************/
 
+#define _POSIX_C_SOURCE 200809L   /* clock_gettime, isatty, fileno */
+
 #include <stdio.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
 #include "stats.h"
 
 /* ========== Size of the Data Set ========== */
 
 #define SIZE (40)
 
-void main() {
+/* Bytes read from stdin per block; the only buffer, whatever the input */
+#define STREAM_BLOCK (1u << 20)
+
+/* Default --bench volume in MiB */
+#define BENCH_MIB (256u)
+
+static unsigned char block[STREAM_BLOCK];
+
+static double seconds_now(void) {
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return (double)ts.tv_sec + (double)ts.tv_nsec * 1e-9;
+}
+
+static void print_rate(const char *what, uint64_t bytes, double seconds) {
+  if (seconds <= 0.0) seconds = 1e-9;
+  fprintf(stderr, "%s: %llu bytes in %.3f s, %.1f MB/s\n", what,
+          (unsigned long long)bytes, seconds, (double)bytes / seconds / 1e6);
+}
 
+/* The original demo on the hard-coded data set */
+static void run_demo(void) {
   unsigned char test[SIZE] = { 34, 201, 190, 154,   8, 194,   2,   6,
                               114, 88,   45,  76, 123,  87,  25,  23,
                               200, 122, 150, 90,   92,  87, 177, 244,
@@ -53,6 +86,123 @@ void main() {
   print_statistics(test, SIZE);
 }
 
+/**
+ * @brief Feed stdin through the histogram one block at a time
+ * @return 0 on success, 1 on a read or parse error
+ */
+static int run_stream(int text, int rate) {
+  stats_hist_t hist;
+  stats_text_t parser;
+  uint64_t bytes = 0;
+  double start = seconds_now();
+  size_t got;
+
+  stats_hist_init(&hist);
+  stats_text_init(&parser);
+  setvbuf(stdin, NULL, _IONBF, 0);   /* fread straight into block */
+  while ((got = fread(block, 1, STREAM_BLOCK, stdin)) > 0) {
+    bytes += got;
+    if (!text) {
+      stats_hist_add(&hist, block, got);
+    } else if (stats_text_parse(&parser, &hist, (const char *)block,
+                                got) != 0) {
+      fprintf(stderr, "stats: bad sample near byte %llu (values are "
+              "0-255, separated by spaces, commas or newlines)\n",
+              (unsigned long long)parser.offset);
+      return 1;
+    }
+  }
+  if (ferror(stdin)) {
+    perror("stats: stdin");
+    return 1;
+  }
+  if (text && stats_text_finish(&parser, &hist) != 0) {
+    fprintf(stderr, "stats: bad sample at end of input\n");
+    return 1;
+  }
+
+  print_stats_hist(&hist);
+  if (rate) print_rate("Read", bytes, seconds_now() - start);
+  return 0;
+}
+
+/* In-memory throughput of the binary and text paths, no I/O */
+static void run_bench(unsigned int mib) {
+  stats_hist_t hist;
+  stats_text_t parser;
+  unsigned int rounds = mib ? mib : BENCH_MIB;
+  uint32_t seed = 1;
+  size_t len = 0;
+  double start;
+
+  for (size_t i = 0; i < STREAM_BLOCK; i++) {
+    seed = seed * 1103515245u + 12345u;
+    block[i] = (unsigned char)(seed >> 16);
+  }
+  stats_hist_init(&hist);
+  start = seconds_now();
+  for (unsigned int r = 0; r < rounds; r++) {
+    stats_hist_add(&hist, block, STREAM_BLOCK);
+  }
+  print_rate("binary", (uint64_t)rounds * STREAM_BLOCK, seconds_now() - start);
+
+  /* The same block as text, one sample per line; sprintf also writes a
+     NUL, so each step needs room for "255\n" plus one byte */
+  while (len + 5 <= STREAM_BLOCK) {
+    seed = seed * 1103515245u + 12345u;
+    len += (size_t)sprintf((char *)block + len, "%u\n", (seed >> 16) & 0xFF);
+  }
+  stats_hist_init(&hist);
+  stats_text_init(&parser);
+  start = seconds_now();
+  for (unsigned int r = 0; r < rounds; r++) {
+    stats_text_parse(&parser, &hist, (const char *)block, len);
+  }
+  stats_text_finish(&parser, &hist);
+  print_rate("text", (uint64_t)rounds * len, seconds_now() - start);
+}
+
+static void usage(void) {
+  fprintf(stderr,
+          "usage: stats [-b | -t] [-r]   samples from stdin\n"
+          "       stats --bench [MiB]    in-memory throughput\n"
+          "       stats --demo           the built-in 40-sample set\n"
+          "  -b  binary: every byte is a sample (default)\n"
+          "  -t  text: decimal 0-255, separated by spaces, commas or "
+          "newlines\n"
+          "  -r  report throughput in MB/s on stderr\n"
+          "Run on a terminal with no arguments, stats shows the demo.\n");
+}
+
+int main(int argc, char **argv) {
+  int text = 0, rate = 0;
+
+  if (argc == 1 && isatty(fileno(stdin))) {
+    run_demo();
+    return 0;
+  }
+  for (int i = 1; i < argc; i++) {
+    if (strcmp(argv[i], "-b") == 0) {
+      text = 0;
+    } else if (strcmp(argv[i], "-t") == 0) {
+      text = 1;
+    } else if (strcmp(argv[i], "-r") == 0) {
+      rate = 1;
+    } else if (strcmp(argv[i], "--demo") == 0) {
+      run_demo();
+      return 0;
+    } else if (strcmp(argv[i], "--bench") == 0) {
+      run_bench(i + 1 < argc ? (unsigned int)strtoul(argv[i + 1], NULL, 10)
+                             : 0);
+      return 0;
+    } else {
+      usage();
+      return 2;
+    }
+  }
+  return run_stream(text, rate);
+}
+
 /* ========== Function Implementations ========== */
 
 void print_statistics(unsigned char *data, unsigned int size) {
@@ -63,6 +213,124 @@ void print_statistics(unsigned char *data, unsigned int size) {
   printf("Median: %d\n", find_median(data, size));
 }
 
+void stats_hist_init(stats_hist_t *hist) {
+  memset(hist, 0, sizeof(*hist));
+}
+
+void stats_hist_add(stats_hist_t *hist, const unsigned char *data,
+                    size_t size) {
+  while (size > 0) {
+    /* Four tables so runs of one value do not queue on one counter; 32-bit
+       counts are safe for up to 2^32 - 1 bytes per round */
+    uint32_t lanes[4][256];
+    size_t n = size < 0xFFFFFFFFu ? size : 0xFFFFFFFFu;
+    size_t i = 0;
+
+    memset(lanes, 0, sizeof(lanes));
+    for (; i + 4 <= n; i += 4) {
+      lanes[0][data[i]]++;
+      lanes[1][data[i + 1]]++;
+      lanes[2][data[i + 2]]++;
+      lanes[3][data[i + 3]]++;
+    }
+    for (; i < n; i++) lanes[0][data[i]]++;
+    for (unsigned int v = 0; v < 256; v++) {
+      uint32_t c = lanes[0][v] + lanes[1][v] + lanes[2][v] + lanes[3][v];
+      hist->histogram[v] += c;
+      hist->sum += (uint64_t)c * v;
+    }
+    hist->count += n;
+    data += n;
+    size -= n;
+  }
+}
+
+unsigned char hist_maximum(const stats_hist_t *hist) {
+  int value = 255;
+  if (hist->count == 0) return 0;
+  while (hist->histogram[value] == 0) value--;
+  return (unsigned char)value;
+}
+
+unsigned char hist_minimum(const stats_hist_t *hist) {
+  int value = 0;
+  if (hist->count == 0) return 0;
+  while (hist->histogram[value] == 0) value++;
+  return (unsigned char)value;
+}
+
+unsigned char hist_mean(const stats_hist_t *hist) {
+  if (hist->count == 0) return 0;
+  return (unsigned char)(hist->sum / hist->count);
+}
+
+unsigned char hist_median(const stats_hist_t *hist) {
+  /* The value a descending sort would leave at index count / 2 */
+  uint64_t k = hist->count / 2, seen = 0;
+  int value;
+
+  if (hist->count == 0) return 0;
+  for (value = 255; value > 0; value--) {
+    seen += hist->histogram[value];
+    if (seen > k) break;
+  }
+  return (unsigned char)value;
+}
+
+void print_stats_hist(const stats_hist_t *hist) {
+  printf("\nStatistics:\n");
+  printf("Samples: %llu\n", (unsigned long long)hist->count);
+  if (hist->count == 0) return;
+  printf("Maximum: %d\n", hist_maximum(hist));
+  printf("Minimum: %d\n", hist_minimum(hist));
+  printf("Mean: %d\n", hist_mean(hist));
+  printf("Median: %d\n", hist_median(hist));
+}
+
+void stats_text_init(stats_text_t *parser) {
+  memset(parser, 0, sizeof(*parser));
+}
+
+int stats_text_parse(stats_text_t *parser, stats_hist_t *hist,
+                     const char *text, size_t size) {
+  unsigned int value = parser->value;
+  unsigned int digits = parser->digits;
+
+  for (size_t i = 0; i < size; i++) {
+    unsigned int c = (unsigned char)text[i];
+
+    if (c - '0' <= 9) {
+      value = value * 10 + (c - '0');
+      /* Three digits reach 999 at most, so value cannot overflow */
+      if (++digits > 3 || value > 255) {
+        parser->offset += i;
+        return -1;
+      }
+    } else if (c == ' ' || c == '\n' || c == ',' || c == '\t' ||
+               c == '\r') {
+      if (digits) {
+        hist->histogram[value]++;
+        hist->sum += value;
+        hist->count++;
+        value = 0;
+        digits = 0;
+      }
+    } else {
+      parser->offset += i;
+      return -1;
+    }
+  }
+  parser->value = value;
+  parser->digits = digits;
+  parser->offset += size;
+  return 0;
+}
+
+int stats_text_finish(stats_text_t *parser, stats_hist_t *hist) {
+  /* A last number without a trailing separator */
+  return stats_text_parse(parser, hist, " ", 1);
+}
+
 void print_array(unsigned char *data, unsigned int size) {
   for (unsigned int i = 0; i < size; i++) {
     printf("%3d ", data[i]);
@@ -95,16 +363,120 @@ unsigned char find_minimum(unsigned char *data, unsigned int size) {
   return min;
 }
 
-void sort_array(unsigned char *data, unsigned int size) {
-  // Bubble sort in descending order
-  for (unsigned int i = 0; i < size - 1; i++) {
-    for (unsigned int j = 0; j < size - i - 1; j++) {
-      if (data[j] < data[j + 1]) {
-        unsigned char temp = data[j];
-        data[j] = data[j + 1];
-        data[j + 1] = temp;
-      }
+static inline void swap_bytes(unsigned char *a, unsigned char *b) {
+  unsigned char temp = *a;
+  *a = *b;
+  *b = temp;
+}
+
+void sort_array_insertion(unsigned char *data, unsigned int size) {
+  for (unsigned int i = 1; i < size; i++) {
+    unsigned char value = data[i];
+    unsigned int j = i;
+    while (j > 0 && data[j - 1] < value) {
+      data[j] = data[j - 1];
+      j--;
+    }
+    data[j] = value;
+  }
+}
+
+/* Min-heap sift: leaves the smallest value at the root */
+static void sift_down_min(unsigned char *data, unsigned int root,
+                          unsigned int size) {
+  unsigned char value = data[root];
+
+  for (;;) {
+    unsigned int child = 2 * root + 1;
+    if (child >= size) break;
+    if (child + 1 < size && data[child + 1] < data[child]) child++;
+    if (data[child] >= value) break;
+    data[root] = data[child];
+    root = child;
+  }
+  data[root] = value;
+}
+
+/* Heapsort fallback: repeatedly move the minimum to the end */
+static void heap_sort_desc(unsigned char *data, unsigned int size) {
+  for (unsigned int i = size / 2; i > 0; i--) {
+    sift_down_min(data, i - 1, size);
+  }
+  for (unsigned int end = size - 1; end > 0; end--) {
+    swap_bytes(&data[0], &data[end]);
+    sift_down_min(data, 0, end);
+  }
+}
+
+static void intro_sort_desc(unsigned char *data, unsigned int size,
+                            unsigned int depth) {
+  while (size > SORT_INSERTION_MAX) {
+    unsigned int mid = (size - 1) / 2;
+    unsigned int i, j;
+    unsigned char pivot;
+
+    if (depth == 0) {
+      heap_sort_desc(data, size);
+      return;
+    }
+    depth--;
+
+    /* Median of three, ordered so the ends act as sentinels */
+    if (data[mid] > data[0]) swap_bytes(&data[mid], &data[0]);
+    if (data[size - 1] > data[0]) swap_bytes(&data[size - 1], &data[0]);
+    if (data[size - 1] > data[mid]) swap_bytes(&data[size - 1], &data[mid]);
+    pivot = data[mid];
+
+    /* Hoare partition: [0, j] >= pivot >= [j + 1, size) */
+    i = 0;
+    j = size - 1;
+    for (;;) {
+      while (data[i] > pivot) i++;
+      while (data[j] < pivot) j--;
+      if (i >= j) break;
+      swap_bytes(&data[i], &data[j]);
+      i++;
+      j--;
     }
+
+    /* Recurse into the smaller half, loop on the larger */
+    if (j + 1 < size - j - 1) {
+      intro_sort_desc(data, j + 1, depth);
+      data += j + 1;
+      size -= j + 1;
+    } else {
+      intro_sort_desc(data + j + 1, size - j - 1, depth);
+      size = j + 1;
+    }
+  }
+  sort_array_insertion(data, size);
+}
+
+void sort_array_intro(unsigned char *data, unsigned int size) {
+  unsigned int depth = 0;
+
+  for (unsigned int n = size; n > 1; n >>= 1) depth += 2;
+  intro_sort_desc(data, size, depth);
+}
+
+void sort_array_counting(unsigned char *data, unsigned int size) {
+  unsigned int counts[256] = {0};
+  unsigned int pos = 0;
+
+  for (unsigned int i = 0; i < size; i++) counts[data[i]]++;
+  for (int value = 255; value >= 0; value--) {
+    memset(data + pos, value, counts[value]);
+    pos += counts[value];
   }
 }
 
+void sort_array(unsigned char *data, unsigned int size) {
+  // Descending order; the algorithm is picked by size
+  if (size <= SORT_INSERTION_MAX) {
+    sort_array_insertion(data, size);
+  } else if (size < SORT_COUNTING_MIN) {
+    sort_array_intro(data, size);
+  } else {
+    sort_array_counting(data, size);
+  }
+}
@@ -28,6 +28,19 @@
 #ifndef __STATS_H__
 #define __STATS_H__
 
+#include <stddef.h>
+#include <stdint.h>
+
+/* sort_array: insertion sort up to this many elements */
+#ifndef SORT_INSERTION_MAX
+#define SORT_INSERTION_MAX (16)
+#endif
+
+/* sort_array: counting sort from this many elements on, introsort below */
+#ifndef SORT_COUNTING_MIN
+#define SORT_COUNTING_MIN  (128)
+#endif
+
 /**
  * @brief Prints statistics (min, max, mean, median) of an array
  * @param data Pointer to the data array
@@ -76,10 +89,123 @@ unsigned char find_minimum(unsigned char *data, unsigned int size);
 
 /**
  * @brief Sorts the array from largest to smallest
+ *
+ * Uses insertion sort up to SORT_INSERTION_MAX elements, introsort below
+ * SORT_COUNTING_MIN elements and a 256-bucket counting sort, O(n + 256),
+ * above that.
+ *
  * @param data Pointer to the data array
  * @param size Size of the array
  */
 void sort_array(unsigned char *data, unsigned int size);
 
+/**
+ * @brief Insertion sort, largest to smallest (best for tiny arrays)
+ * @param data Pointer to the data array
+ * @param size Size of the array
+ */
+void sort_array_insertion(unsigned char *data, unsigned int size);
+
+/**
+ * @brief Introsort, largest to smallest: median-of-three quicksort with a
+ *        heapsort fallback past 2*log2(size) levels, insertion sort for
+ *        short partitions
+ * @param data Pointer to the data array
+ * @param size Size of the array
+ */
+void sort_array_intro(unsigned char *data, unsigned int size);
+
+/**
+ * @brief Counting sort, largest to smallest, O(size + 256)
+ * @param data Pointer to the data array
+ * @param size Size of the array
+ */
+void sort_array_counting(unsigned char *data, unsigned int size);
+
+/**
+ * @brief Running statistics of a byte stream of any length
+ *
+ * Only the 256-bin histogram, the sample count and the sum are kept, so
+ * memory stays constant however much data goes through, and the median is
+ * still exact.
+ */
+typedef struct {
+  uint64_t histogram[256];   /* Occurrences of each value */
+  uint64_t count;            /* Samples seen */
+  uint64_t sum;              /* Sum of all samples */
+} stats_hist_t;
+
+/**
+ * @brief Decimal text parser state carried across block boundaries
+ */
+typedef struct {
+  unsigned int value;        /* Number being read */
+  unsigned int digits;       /* Its digits so far, 0 between numbers */
+  uint64_t offset;           /* Bytes consumed; the error position on -1 */
+} stats_text_t;
+
+/**
+ * @brief Empties a histogram
+ * @param hist Histogram to reset
+ */
+void stats_hist_init(stats_hist_t *hist);
+
+/**
+ * @brief Adds a block of byte samples to a histogram
+ * @param hist Histogram to update
+ * @param data Pointer to the samples
+ * @param size Number of samples
+ */
+void stats_hist_add(stats_hist_t *hist, const unsigned char *data,
+                    size_t size);
+
+/**
+ * @brief Maximum, minimum, mean (rounded down) and median of a histogram
+ *
+ * The median is the same value find_median returns for the whole stream.
+ * All four return 0 for an empty histogram.
+ *
+ * @param hist Histogram to read
+ */
+unsigned char hist_maximum(const stats_hist_t *hist);
+unsigned char hist_minimum(const stats_hist_t *hist);
+unsigned char hist_mean(const stats_hist_t *hist);
+unsigned char hist_median(const stats_hist_t *hist);
+
+/**
+ * @brief Prints the sample count and statistics of a histogram
+ * @param hist Histogram to print
+ */
+void print_stats_hist(const stats_hist_t *hist);
+
+/**
+ * @brief Resets a text parser
+ * @param parser Parser to reset
+ */
+void stats_text_init(stats_text_t *parser);
+
+/**
+ * @brief Parses a block of decimal samples (0-255) into a histogram
+ *
+ * Samples are separated by spaces, tabs, commas or line breaks. A number
+ * split across two blocks is carried over in parser.
+ *
+ * @param parser Parser state
+ * @param hist Histogram to update
+ * @param text Pointer to the block
+ * @param size Bytes in the block
+ * @return 0 on success, -1 on a value over 255 or any other character
+ */
+int stats_text_parse(stats_text_t *parser, stats_hist_t *hist,
+                     const char *text, size_t size);
+
+/**
+ * @brief Adds a number still pending at the end of the input
+ * @param parser Parser state
+ * @param hist Histogram to update
+ * @return 0 on success, -1 if the parser is in an error state
+ */
+int stats_text_finish(stats_text_t *parser, stats_hist_t *hist);
+
 #endif /* __STATS_H__ */
 
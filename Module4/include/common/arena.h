@@ -0,0 +1,75 @@
+/*****************************************************************************
+ * @file arena.h
+ * @brief Scoped bump (arena) allocator for short-lived scratch buffers
+ *
+ * An arena hands out memory from one caller-provided buffer by bumping an
+ * offset. Nothing is freed individually: take a mark before a batch of
+ * scratch allocations and reset to it to release the whole batch at once.
+ *
+ * This code was written as part of the Introduction to Embedded Systems
+ * Software and Development Environments course (University of Colorado Boulder).
+ *
+ * @author Timofei Alekseenko
+ * @date October 17, 2026
+ *
+ *****************************************************************************/
+
+#ifndef __ARENA_H__
+#define __ARENA_H__
+
+#include <stdint.h>
+#include <stddef.h>
+
+/* Alignment used when arena_alloc is called with align == 0 */
+#define ARENA_DEFAULT_ALIGN (sizeof(int32_t))
+
+typedef struct {
+  uint8_t * base;     /* Start of the backing buffer */
+  size_t size;        /* Size of the backing buffer in bytes */
+  size_t used;        /* Current bump offset */
+  size_t high_water;  /* Largest offset ever reached */
+} arena_t;
+
+/* Position to roll an arena back to */
+typedef size_t arena_mark_t;
+
+/**
+ * @brief Set up an arena over a caller-provided buffer
+ * @param arena  Arena to initialize
+ * @param buffer Backing storage (static array, stack buffer, pool block...)
+ * @param size   Size of buffer in bytes
+ */
+void arena_init(arena_t * arena, void * buffer, size_t size);
+
+/**
+ * @brief Allocate size bytes by bumping the arena offset
+ * @param arena Arena to allocate from
+ * @param size  Number of bytes
+ * @param align Power-of-two alignment, or 0 for ARENA_DEFAULT_ALIGN
+ * @return Pointer to the allocation, or NULL if the arena is full
+ */
+void * arena_alloc(arena_t * arena, size_t size, size_t align);
+
+/**
+ * @brief Allocate length 32-bit words (arena counterpart of reserve_words)
+ * @param arena  Arena to allocate from
+ * @param length Number of 32-bit words
+ * @return Pointer to the words, or NULL if the arena is full
+ */
+int32_t * arena_reserve_words(arena_t * arena, size_t length);
+
+/**
+ * @brief Remember the current arena position
+ * @param arena Arena to mark
+ * @return Mark to pass to arena_reset
+ */
+arena_mark_t arena_mark(const arena_t * arena);
+
+/**
+ * @brief Release everything allocated since mark in one step
+ * @param arena Arena to roll back
+ * @param mark  Value returned by arena_mark (0 releases everything)
+ */
+void arena_reset(arena_t * arena, arena_mark_t mark);
+
+#endif /* __ARENA_H__ */
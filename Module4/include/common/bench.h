@@ -0,0 +1,190 @@
+/*****************************************************************************
+ * @file bench.h
+ * @brief Micro-benchmarks for the memory and statistics kernels
+ *
+ * Compiled in with BENCH=1. Times are taken with clock_gettime() on HOST
+ * (nanoseconds) and with the DWT cycle counter on MSP432 (CPU cycles).
+ *
+ * This code was written as part of the Introduction to Embedded Systems
+ * Software and Development Environments course (University of Colorado Boulder).
+ *
+ * @author Timofei Alekseenko
+ * @date October 17, 2026
+ *
+ *****************************************************************************/
+
+#ifndef __BENCH_H__
+#define __BENCH_H__
+
+#include <stdint.h>
+#include <stddef.h>
+
+/**
+ * @brief Run every benchmark and print the results
+ */
+void bench(void);
+
+/**
+ * @brief Compare my_memcopy against the byte loop and the C library memcpy
+ */
+void bench_memcopy(void);
+
+/**
+ * @brief Compare overlapping my_memmove against the byte loop and memmove
+ */
+void bench_memmove(void);
+
+/**
+ * @brief Compare my_memset/my_memset16 against the byte loop and memset, and
+ *        (HOST) streaming against cached clears of a buffer past the LLC
+ */
+void bench_memset(void);
+
+/**
+ * @brief Compare my_reverse (and the 16/32-bit element variants) against
+ *        the byte-pair loop
+ */
+void bench_reverse(void);
+
+/**
+ * @brief Compare pool-backed reserve_words/free_words against malloc/free
+ */
+void bench_pool(void);
+
+/**
+ * @brief Compare arena alloc + reset-to-mark against malloc/free batches
+ */
+void bench_arena(void);
+
+/**
+ * @brief Compare TLSF and malloc latency (mean and worst case) under random
+ *        variable-size alloc/free churn
+ */
+void bench_tlsf(void);
+
+/**
+ * @brief Scale the thread-safe pool against malloc from 1 to N threads
+ *        (HOST only)
+ */
+void bench_mtpool(void);
+
+/**
+ * @brief Compare blocking my_memcopy with the async copy engine: submit
+ *        latency, submit+wait, and a copy overlapped with CPU work
+ */
+void bench_dma(void);
+
+/**
+ * @brief Compare single-bit stores, popcount and first-set scans with
+ *        bit-by-bit loops
+ */
+void bench_bits(void);
+
+/**
+ * @brief Sweep sort_array and its engines against the old bubble sort from
+ *        n = 40 up to millions of samples (HOST)
+ */
+void bench_sort(void);
+
+/**
+ * @brief Time the sorting networks against insertion sort and introsort
+ *        at 8, 16, 32 and 40 elements on random, ascending and descending
+ *        input
+ */
+void bench_sort_network(void);
+
+/**
+ * @brief Compare the histogram median and introselect with the old
+ *        sort-based median (copy + sort)
+ */
+void bench_median(void);
+
+/**
+ * @brief Compare the single-pass compute_statistics with one pass per
+ *        statistic
+ */
+void bench_statistics(void);
+
+/**
+ * @brief Compare the SIMD min, max and sum kernels with scalar loops
+ *        (cycles on MSP432)
+ */
+void bench_stats_kernels(void);
+
+/**
+ * @brief Compare the streaming window median with recomputing the median
+ *        of the window after every sample
+ */
+void bench_stats_stream(void);
+
+/**
+ * @brief Compare the 16-bit, 32-bit and float max and sum kernels with
+ *        scalar loops
+ */
+void bench_stats_typed(void);
+
+/**
+ * @brief Compare the integer variance, standard deviation, isqrt,
+ *        percentile and histogram functions with float references
+ */
+void bench_variance(void);
+
+/**
+ * @brief Compare find_top_k and sort_array_partial with a full sort_array
+ *        for small and large k
+ */
+void bench_top_k(void);
+
+/**
+ * @brief Compare the u16/u32 radix sorts (and on HOST their multithreaded
+ *        variants) with the typed introsort
+ */
+void bench_radix(void);
+
+/**
+ * @brief Scale compute_statistics over a large buffer from 1 to N pool
+ *        threads (HOST only)
+ */
+void bench_stats_parallel(void);
+
+/**
+ * @brief Scale sort_array and sort_array_i32 on large arrays from 1 to N
+ *        pool threads (HOST only)
+ */
+void bench_sort_parallel(void);
+
+/**
+ * @brief Compare reading a capture file into a buffer with the mmap view
+ *        and the streaming window mode (HOST only)
+ */
+void bench_capture(void);
+
+/**
+ * @brief Time extsort_file on a capture file several times its memory
+ *        budget and print each phase's throughput (HOST only)
+ */
+void bench_extsort(void);
+
+/**
+ * @brief Read the benchmark clock
+ *
+ * On MSP432 the 32-bit DWT cycle counter is extended to 64 bits in
+ * software, which needs a call at least once per counter period (about
+ * 89 s at 48 MHz); a longer gap between two calls loses whole periods.
+ *
+ * @return Nanoseconds on HOST, CPU cycles on MSP432
+ */
+uint64_t bench_ticks(void);
+
+/**
+ * @brief Print one benchmark line: name, bytes per call, ticks per call
+ *        and throughput (MB/s on HOST, bytes per kilocycle on MSP432)
+ * @param name  Label of the measured kernel
+ * @param bytes Bytes processed per call
+ * @param calls Number of calls measured
+ * @param ticks Total ticks spent in those calls
+ */
+void bench_report(const char * name, size_t bytes, uint32_t calls,
+                  uint64_t ticks);
+
+#endif /* __BENCH_H__ */
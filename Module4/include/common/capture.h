@@ -0,0 +1,119 @@
+/*****************************************************************************
+ * @file capture.h
+ * @brief Memory-mapped loader for raw sample capture files (HOST)
+ *
+ * A capture file is a headerless array of little-endian samples in one of
+ * the formats below. capture_open maps the whole file and exposes it as a
+ * typed view that goes straight into the stats and sort functions, without
+ * reading it into a buffer first. capture_stream maps a file window by
+ * window instead, for files larger than memory.
+ *
+ * Mappings are advised MADV_SEQUENTIAL (and MADV_HUGEPAGE where the kernel
+ * offers it). A trailing partial sample is ignored. The stats and sort
+ * functions take unsigned int sizes, so capture_open refuses files of more
+ * than UINT_MAX samples; stream those with capture_stream.
+ *
+ * HOST only (POSIX mmap).
+ *
+ * This code was written as part of the Introduction to Embedded Systems
+ * Software and Development Environments course (University of Colorado Boulder).
+ *
+ * @author Timofei Alekseenko
+ * @date October 17, 2026
+ *
+ *****************************************************************************/
+
+#ifndef __CAPTURE_H__
+#define __CAPTURE_H__
+
+#include <stdint.h>
+#include <stddef.h>
+
+/* capture_stream window when chunk_bytes is 0 (override with -D) */
+#ifndef CAPTURE_CHUNK_BYTES
+#define CAPTURE_CHUNK_BYTES (64UL << 20)
+#endif
+
+/* capture_open flags */
+#define CAPTURE_READ_ONLY  (0x00)
+#define CAPTURE_WRITABLE   (0x01)   /* Private copy-on-write map, e.g. for
+                                       sort_array; the file never changes */
+
+/**
+ * @brief Sample formats
+ */
+typedef enum {
+  CAPTURE_U8 = 0,
+  CAPTURE_U16,
+  CAPTURE_I32
+} capture_format_t;
+
+/**
+ * @brief An open capture file
+ */
+typedef struct {
+  void * data;               /* First sample (NULL for an empty file) */
+  size_t count;              /* Number of whole samples (<= UINT_MAX) */
+  size_t map_bytes;          /* Bytes mapped */
+  capture_format_t format;
+} capture_t;
+
+/**
+ * @brief Called by capture_stream once per window
+ * @param samples First sample of the window (read only)
+ * @param count Number of samples in the window
+ * @param ctx Context given to capture_stream
+ * @return 0 to continue, anything else to stop
+ */
+typedef int (*capture_chunk_fn)(const void * samples, size_t count,
+                                void * ctx);
+
+/**
+ * @brief Bytes per sample of a format (0 for an unknown format)
+ */
+size_t capture_sample_bytes(capture_format_t format);
+
+/**
+ * @brief Map a whole capture file
+ * @param cap Filled on success
+ * @param path File to map
+ * @param format Sample format
+ * @param flags CAPTURE_READ_ONLY or CAPTURE_WRITABLE
+ * @return 0 on success, -1 if the file cannot be opened or mapped or
+ *         holds more than UINT_MAX samples
+ */
+int8_t capture_open(capture_t * cap, const char * path,
+                    capture_format_t format, uint8_t flags);
+
+/**
+ * @brief Unmap a capture opened by capture_open
+ */
+void capture_close(capture_t * cap);
+
+/**
+ * @brief Typed zero-copy views; NULL when the capture has another format
+ */
+uint8_t * capture_u8(const capture_t * cap);
+uint16_t * capture_u16(const capture_t * cap);
+int32_t * capture_i32(const capture_t * cap);
+
+/**
+ * @brief Stream a capture file through fn one mapped window at a time
+ *
+ * Only one window is mapped at a time. The next window is prefetched
+ * (POSIX_FADV_WILLNEED) while fn runs, and finished windows are dropped
+ * from the page cache, so files larger than memory stream at disk speed.
+ * Windows hold whole samples.
+ *
+ * @param path File to read
+ * @param format Sample format
+ * @param chunk_bytes Window size, rounded up to whole pages;
+ *                    0 for CAPTURE_CHUNK_BYTES
+ * @param fn Called for every window in file order
+ * @param ctx Passed to fn
+ * @return 0 when the whole file (or up to fn's stop) was read, -1 on error
+ */
+int8_t capture_stream(const char * path, capture_format_t format,
+                      size_t chunk_bytes, capture_chunk_fn fn, void * ctx);
+
+#endif /* __CAPTURE_H__ */
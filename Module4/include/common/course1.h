@@ -28,11 +28,24 @@
 #define MEM_SET_SIZE_B  (32)
 #define MEM_SET_SIZE_W  (8)
 #define MEM_ZERO_LENGTH (16)
+#define MEM_BULK_SIZE_B (512)   /* Room for lengths past the 128-byte */
+#define MEM_BULK_SIZE_W (128)   /* AVX2 block loops, plus offsets */
+#define ARENA_SIZE_B    (256)
+#define MT_TEST_THREADS (4)
+#define SORT_TEST_SIZE  (1000)
+
+/* Elements in the 16/32-bit test arrays: MSP432 has 64 KB of SRAM for all
+   data, the pools and the stack, so they stay small there */
+#if defined (MSP432)
+#define WIDE_TEST_SIZE  (256)
+#else
+#define WIDE_TEST_SIZE  SORT_TEST_SIZE
+#endif
 
 #define TEST_MEMMOVE_LENGTH (16)
 #define TEST_ERROR          (1)
 #define TEST_NO_ERROR       (0)
-#define TESTCOUNT           (8)
+#define TESTCOUNT           (32)
 
 #define BASE_10 10
 #define BASE_16 16
@@ -113,6 +126,31 @@ int8_t test_memmove3();
  */
 int8_t test_memcopy();
 
+/**
+ * @brief function to test the block-wise memmove in both overlap directions
+ * 
+ * This function moves windows of several lengths by small positive and
+ * negative distances inside one buffer, so both the forward and backward
+ * block loops (128 bytes per step with AVX2) run with overlapping source
+ * and destination, as well as the disjoint fall-through to memcopy.
+ *
+ * @return void
+ */
+int8_t test_memmove_bulk();
+
+/**
+ * @brief function to test the memcopy fast paths
+ * 
+ * This function runs my_memcopy over a range of lengths and source and
+ * destination misalignments so the byte, word and block paths (and their
+ * head/tail handling) are all exercised, including lengths past the
+ * 128-byte blocks of the AVX2 build. Bytes outside the destination
+ * range must stay untouched.
+ *
+ * @return void
+ */
+int8_t test_memcopy_bulk();
+
 /**
  * @brief function to test the memset and memzero functionality
  * 
@@ -123,6 +161,17 @@ int8_t test_memcopy();
  */
 int8_t test_memset();
 
+/**
+ * @brief function to test the wide-store memset variants
+ * 
+ * This function checks my_memset over several lengths and misalignments,
+ * my_memset16 and my_memset32 pattern fills, and the streaming fill (on HOST
+ * with a buffer past MEM_STREAM_THRESHOLD so the non-temporal path runs).
+ *
+ * @return void
+ */
+int8_t test_memset_bulk();
+
 /**
  * @brief function to test the reverse functionality
  * 
@@ -133,5 +182,258 @@ int8_t test_memset();
  */
 int8_t test_reverse();
 
+/**
+ * @brief function to test the word/vector reverse kernels
+ * 
+ * This function reverses byte, 16-bit and 32-bit arrays of every length from
+ * zero up past the vector block size, at several offsets, and checks that
+ * nothing outside the reversed range changes.
+ *
+ * @return void
+ */
+int8_t test_reverse_bulk();
+
+/**
+ * @brief function to test the reserve_words block pool
+ * 
+ * This function drains the pool through reserve_words, checks that further
+ * requests (and oversized ones) fall back to the heap, that freed blocks are
+ * reused and that the high-water mark tracks the peak.
+ *
+ * @return void
+ */
+int8_t test_pool();
+
+/**
+ * @brief function to test the scoped arena allocator
+ * 
+ * This function allocates scratch buffers with different alignments from an
+ * arena, checks that they are aligned and disjoint, that a full arena returns
+ * NULL, and that resetting to a mark releases the whole batch at once.
+ *
+ * @return void
+ */
+int8_t test_arena();
+
+/**
+ * @brief function to test the TLSF heap
+ * 
+ * This function allocates variable-size buffers from the TLSF heap, checks
+ * alignment and that no two buffers overlap, frees them in an interleaved
+ * order and verifies that coalescing returns the heap to one free block.
+ *
+ * @return void
+ */
+int8_t test_tlsf();
+
+/**
+ * @brief function to test the thread-safe block pool (HOST only)
+ * 
+ * This function runs several threads that allocate, stamp, verify and free
+ * blocks concurrently, passing some blocks between threads, and checks that
+ * every block is back in the pool after the threads exit, including blocks
+ * freed by a thread that never allocated. On MSP432 the test
+ * is skipped and passes.
+ *
+ * @return void
+ */
+int8_t test_mtpool();
+
+/**
+ * @brief function to test the asynchronous copy engine
+ * 
+ * This function gathers several pieces of a buffer with one descriptor chain
+ * (including an empty descriptor), waits for it and checks the callback,
+ * then fills the whole transfer queue with small unaligned copies and polls
+ * them to completion.
+ *
+ * @return void
+ */
+int8_t test_dma();
+
+/**
+ * @brief function to test the single-bit and bitset operations
+ * 
+ * This function sets, clears, tests and toggles single bits, compares
+ * count_bits and find_first_bit with a bit-by-bit scan for many lengths and
+ * start alignments, and on HOST has several threads flip interleaved bits of
+ * the same bytes to check that no update is lost.
+ *
+ * @return void
+ */
+int8_t test_bits();
+
+/**
+ * @brief function to test sort_array and its insertion, intro and counting
+ *        sort engines
+ * 
+ * This function sorts random, ascending, descending, constant, few-valued
+ * and organ-pipe inputs of sizes around every algorithm switch point and
+ * checks that the output is descending and a permutation of the input.
+ *
+ * @return void
+ */
+int8_t test_sort();
+
+/**
+ * @brief function to test the selection-based median, k-th and percentile
+ * 
+ * This function checks find_median, find_kth and find_percentile on bytes
+ * and find_kth_i32 on 32-bit samples against a sorted copy, for several
+ * sizes and input patterns, and that the inputs are left unchanged.
+ *
+ * @return void
+ */
+int8_t test_median();
+
+/**
+ * @brief function to test the single-pass statistics kernel
+ * 
+ * This function compares every field of compute_statistics with the
+ * separate find_* functions and a plain sum, for several sizes including
+ * an empty array.
+ *
+ * @return void
+ */
+int8_t test_statistics();
+
+/**
+ * @brief function to test the SIMD min, max and sum kernels
+ * 
+ * This function checks find_maximum, find_minimum, find_sum and find_mean
+ * against scalar loops for every start alignment and many sizes, with the
+ * extremes placed at the head, middle and tail of the buffer.
+ *
+ * @return void
+ */
+int8_t test_stats_kernels();
+
+/**
+ * @brief function to test the streaming statistics accumulator
+ * 
+ * This function pushes a drifting sample stream through windows of several
+ * sizes, compares the window median after every sample with find_median of
+ * the same samples, and checks the running min, max, mean and variance
+ * against batch results.
+ *
+ * @return void
+ */
+int8_t test_stats_stream();
+
+/**
+ * @brief function to test the 16-bit, 32-bit and float statistics
+ * 
+ * This function checks every stats_typed.h function for uint16_t, int16_t,
+ * int32_t and float samples against scalar loops, for many sizes, every
+ * start offset and random, repeated and ascending data, plus sums that
+ * overflow 32 bits.
+ *
+ * @return void
+ */
+int8_t test_stats_typed();
+
+/**
+ * @brief function to test variance, standard deviation, isqrt, percentiles
+ *        and binned histograms
+ * 
+ * This function checks isqrt at the 32/64-bit edges and on random values,
+ * compares the integer and Q8 variance and standard deviation with exact
+ * rational references, and checks find_percentiles and find_histogram
+ * against find_percentile and a direct count.
+ *
+ * @return void
+ */
+int8_t test_variance();
+
+/**
+ * @brief function to test the thread pool and parallel statistics (HOST)
+ * 
+ * This function checks that tpool_run calls every task index exactly once,
+ * including nested jobs, and that compute_statistics, find_median and
+ * find_percentile give identical results on a multi-megabyte buffer with
+ * MT_TEST_THREADS threads and with the pool reduced to one thread. It also
+ * calls find_median on that buffer from inside pool tasks, where it must
+ * run serially instead of deadlocking on the busy pool.
+ *
+ * @return void
+ */
+int8_t test_stats_parallel();
+
+/**
+ * @brief function to test the memory-mapped capture loader (HOST)
+ * 
+ * This function writes a temporary capture file and checks that u8, u16
+ * and i32 views give the same statistics as the bytes in memory, that a
+ * writable view can be sorted without changing the file, that streaming
+ * visits every sample in page-rounded windows and can stop early, that
+ * views of more than UINT_MAX samples are refused, and that empty and
+ * missing files are handled.
+ *
+ * @return void
+ */
+int8_t test_capture();
+
+/**
+ * @brief function to test top-k extraction and partial sorting
+ * 
+ * This function checks find_top_k and sort_array_partial against the
+ * prefix of a full sort_array for random, ascending, constant and
+ * few-valued arrays, for k from 0 past the size on both the heap and the
+ * histogram path, and that sort_array_partial keeps every value.
+ *
+ * @return void
+ */
+int8_t test_top_k();
+
+/**
+ * @brief function to test the fixed-size sorting networks
+ * 
+ * This function runs every 0-1 input through the 8 and 16 element
+ * networks, compares all four sizes with introsort on random, ascending,
+ * descending and constant arrays, and checks that other sizes are
+ * rejected untouched and that sort_array picks the networks.
+ *
+ * @return void
+ */
+int8_t test_sort_network();
+
+/**
+ * @brief function to test the u16/u32 radix sorts
+ * 
+ * This function compares radix_sort_u16 and radix_sort_u32 with the
+ * typed introsort on random, narrow, constant and presorted arrays around
+ * the insertion sort cutoff, and on HOST checks that the multithreaded
+ * variants give the same result on multi-megabyte arrays, including ones
+ * whose keys share their top bits.
+ *
+ * @return void
+ */
+int8_t test_radix();
+
+/**
+ * @brief function to test the external merge sort
+ *
+ * This function sorts u8, u16 and i32 capture files of a few megabytes
+ * with extsort_file under a 1 MiB budget, so that the wide formats spill
+ * several runs that are merged through partial buffers, and again under
+ * the default budget in place. The output must equal the in-memory sorts.
+ * An empty file and a missing one are checked too. HOST only.
+ *
+ * @return void
+ */
+int8_t test_extsort();
+
+/**
+ * @brief function to test the parallel sorts behind sort_array
+ *
+ * This function sorts byte, i32, u16 and f32 arrays past
+ * SORT_PARALLEL_MIN on a one-thread pool and on MT_TEST_THREADS threads
+ * and checks that both give the same bytes, for random data, a few
+ * distinct values, all-equal and presorted arrays. HOST only.
+ *
+ * @return void
+ */
+int8_t test_sort_parallel();
+
 #endif /* __COURSE1_H__ */
 
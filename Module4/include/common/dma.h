@@ -0,0 +1,103 @@
+/*****************************************************************************
+ * @file dma.h
+ * @brief Asynchronous memory copy engine (µDMA on MSP432, worker thread on
+ *        HOST)
+ *
+ * A transfer is a chain of scatter-gather descriptors. Submitting it returns
+ * a handle right away; completion can be observed with a callback (run from
+ * the DMA_INT0 ISR on MSP432, from the worker thread on HOST), by polling, or
+ * by waiting. dma_wait/dma_poll only report completion after the callback
+ * has returned. Descriptors and buffers must stay valid until then.
+ *
+ * This code was written as part of the Introduction to Embedded Systems
+ * Software and Development Environments course (University of Colorado Boulder).
+ *
+ * @author Timofei Alekseenko
+ * @date October 17, 2026
+ *
+ *****************************************************************************/
+
+#ifndef __DMA_H__
+#define __DMA_H__
+
+#include <stdint.h>
+#include <stddef.h>
+
+/* Transfers that can be queued or in flight at once */
+#ifndef DMA_MAX_TRANSFERS
+#define DMA_MAX_TRANSFERS (8)
+#endif
+
+/* µDMA channel used for memory-to-memory copies (MSP432) */
+#ifndef DMA_COPY_CHANNEL
+#define DMA_COPY_CHANNEL  (0)
+#endif
+
+#define DMA_INVALID_HANDLE (-1)
+
+#define DMA_STATUS_DONE    (0)
+#define DMA_STATUS_BUSY    (1)
+
+typedef int32_t dma_handle_t;
+
+/**
+ * @brief One scatter-gather element: copy length bytes from src to dst,
+ *        then continue with next (NULL ends the chain)
+ */
+typedef struct dma_desc {
+  const uint8_t * src;
+  uint8_t * dst;
+  size_t length;
+  struct dma_desc * next;
+} dma_desc_t;
+
+/**
+ * @brief Completion callback
+ * @param handle Handle of the finished transfer
+ * @param ctx    Context pointer given at submission
+ */
+typedef void (*dma_callback_t)(dma_handle_t handle, void * ctx);
+
+/**
+ * @brief Set up the copy engine (also done on the first submission)
+ */
+void dma_init(void);
+
+/**
+ * @brief Queue a descriptor chain for asynchronous copying
+ * @param chain    First descriptor
+ * @param callback Completion callback, or NULL
+ * @param ctx      Passed to callback
+ * @return Handle, or DMA_INVALID_HANDLE if the queue is full or chain is NULL
+ */
+dma_handle_t dma_copy_async(dma_desc_t * chain, dma_callback_t callback,
+                            void * ctx);
+
+/**
+ * @brief Queue a single asynchronous copy (same argument order as my_memcopy)
+ * @param src      Source pointer
+ * @param dst      Destination pointer (regions must not overlap)
+ * @param length   Number of bytes
+ * @param callback Completion callback, or NULL
+ * @param ctx      Passed to callback
+ * @return Handle, or DMA_INVALID_HANDLE if the queue is full
+ */
+dma_handle_t dma_memcopy_async(const uint8_t * src, uint8_t * dst,
+                               size_t length, dma_callback_t callback,
+                               void * ctx);
+
+/**
+ * @brief Check a transfer without blocking
+ * @param handle Handle from dma_copy_async/dma_memcopy_async
+ * @return DMA_STATUS_BUSY while queued or running, DMA_STATUS_DONE after
+ *         the callback has run (or for an invalid/recycled handle)
+ */
+uint8_t dma_poll(dma_handle_t handle);
+
+/**
+ * @brief Block until a transfer is done
+ * @param handle Handle from dma_copy_async/dma_memcopy_async
+ */
+void dma_wait(dma_handle_t handle);
+
+#endif /* __DMA_H__ */
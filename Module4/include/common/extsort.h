@@ -0,0 +1,82 @@
+/*****************************************************************************
+ * @file extsort.h
+ * @brief External merge sort for capture files larger than memory (HOST)
+ *
+ * extsort_file sorts a raw capture file (see capture.h) into a new file,
+ * largest sample first like sort_array, within a fixed memory budget:
+ *
+ *   1. Run formation: the input is read in budget-sized blocks with large
+ *      sequential reads. Each block is cut into one piece per tpool thread,
+ *      and the pieces are sorted in parallel by the in-memory engine
+ *      (sort_array for u8, radix sorts for u16 and i32) and appended to
+ *      one temporary spill file as sorted runs.
+ *   2. Merge: all runs are merged in one pass through a loser tree, each
+ *      run read through its own buffer and the output written through
+ *      another, the budget shared between them.
+ *
+ * An input that fits in one block is sorted and written directly, without
+ * a spill file. The spill file is unlinked as soon as it is created, so
+ * nothing is left behind on failure. The time and bytes of each phase are
+ * reported in extsort_stats_t.
+ *
+ * HOST only (POSIX I/O).
+ *
+ * This code was written as part of the Introduction to Embedded Systems
+ * Software and Development Environments course (University of Colorado Boulder).
+ *
+ * @author Timofei Alekseenko
+ * @date October 17, 2026
+ *
+ *****************************************************************************/
+
+#ifndef __EXTSORT_H__
+#define __EXTSORT_H__
+
+#include <stdint.h>
+#include <stddef.h>
+#include "capture.h"
+
+/* Memory budget when extsort_file is given 0 (override with -D) */
+#ifndef EXTSORT_MEMORY_BYTES
+#define EXTSORT_MEMORY_BYTES (256UL << 20)
+#endif
+
+/* Smallest merge buffer per run; more runs than the budget allows at this
+   size go over the budget rather than thrash the disk */
+#ifndef EXTSORT_MIN_BUFFER
+#define EXTSORT_MIN_BUFFER (64UL << 10)
+#endif
+
+/**
+ * @brief What extsort_file did, and how long each phase took
+ */
+typedef struct {
+  uint64_t samples;           /* Samples sorted */
+  uint64_t bytes;             /* Input bytes (whole samples) */
+  uint32_t runs;              /* Sorted runs spilled (0: sorted in memory) */
+  uint64_t read_ns;           /* Run formation: reading the input */
+  uint64_t sort_ns;           /* Run formation: sorting the blocks */
+  uint64_t spill_ns;          /* Run formation: writing runs or output */
+  uint64_t merge_ns;          /* Merge: reading runs, merging, writing */
+} extsort_stats_t;
+
+/**
+ * @brief Sort a capture file into another file, largest sample first
+ * @param in_path File to sort (a trailing partial sample is dropped)
+ * @param out_path File to create or replace; may be in_path
+ * @param format Sample format
+ * @param memory_bytes Memory budget, 0 for EXTSORT_MEMORY_BYTES
+ * @param tmp_dir Directory for the spill file, NULL for $TMPDIR or /tmp
+ * @param stats Filled with the phase times, may be NULL
+ * @return 0 on success, -1 on an I/O or allocation error
+ */
+int8_t extsort_file(const char * in_path, const char * out_path,
+                    capture_format_t format, size_t memory_bytes,
+                    const char * tmp_dir, extsort_stats_t * stats);
+
+/**
+ * @brief Print the throughput of each phase in MB/s
+ */
+void print_extsort_stats(const extsort_stats_t * stats);
+
+#endif /* __EXTSORT_H__ */
@@ -29,6 +29,24 @@
 #include <stdint.h>
 #include <stddef.h>
 
+/* ===== Copy engine tuning (override with -D at build time) ===== */
+
+/* Below this many bytes the copy loops stay byte-wise */
+#ifndef MEM_WORD_THRESHOLD
+#define MEM_WORD_THRESHOLD   (16)
+#endif
+
+/* From this many bytes on the copy loops use burst/vector blocks */
+#ifndef MEM_BLOCK_THRESHOLD
+#define MEM_BLOCK_THRESHOLD  (64)
+#endif
+
+/* Fills of at least this many bytes go non-temporal in my_memset_stream
+ * (HOST); pick something above the last-level cache size */
+#ifndef MEM_STREAM_THRESHOLD
+#define MEM_STREAM_THRESHOLD (8UL << 20)
+#endif
+
 /* ===== Existing simple operations ===== */
 
 /**
@@ -99,10 +117,82 @@ void set_all(char * ptr, char value, unsigned int size);
  */
 void clear_all(char * ptr, unsigned int size);
 
+/* ===== Single-bit and bitset operations ===== */
+
+/*
+ * Bit n of a bitset lives in byte n / 8 at position n % 8 (LSB first).
+ * set_bit, clear_bit, test_bit and toggle_bit are atomic with respect to
+ * interrupts (MSP432) and other threads (HOST): they never disturb the
+ * neighbouring bits of the same byte.
+ */
+
+/**
+ * @brief Set one bit of a bitset.
+ *
+ * MSP432 writes the SRAM bit-band alias (a single store, no read-modify-
+ * write); HOST uses an atomic OR.
+ *
+ * @param base Pointer to the bitset
+ * @param bit  Bit index
+ */
+void set_bit(uint8_t * base, size_t bit);
+
+/**
+ * @brief Clear one bit of a bitset (bit-band store / atomic AND).
+ * @param base Pointer to the bitset
+ * @param bit  Bit index
+ */
+void clear_bit(uint8_t * base, size_t bit);
+
+/**
+ * @brief Read one bit of a bitset.
+ * @param base Pointer to the bitset
+ * @param bit  Bit index
+ * @return 1 if the bit is set, 0 otherwise
+ */
+uint8_t test_bit(const uint8_t * base, size_t bit);
+
+/**
+ * @brief Invert one bit of a bitset.
+ *
+ * The bit-band alias has no exclusive toggle, so MSP432 reads and writes the
+ * alias with interrupts masked; HOST uses an atomic XOR.
+ *
+ * @param base Pointer to the bitset
+ * @param bit  Bit index
+ * @return Previous value of the bit
+ */
+uint8_t toggle_bit(uint8_t * base, size_t bit);
+
+/**
+ * @brief Count the set bits among the first nbits of a bitset.
+ * @param base  Pointer to the bitset
+ * @param nbits Number of bits to examine
+ * @return Number of set bits
+ */
+size_t count_bits(const uint8_t * base, size_t nbits);
+
+/**
+ * @brief Find the lowest set bit among the first nbits of a bitset.
+ *
+ * Scans a 32-bit word at a time and locates the bit with RBIT + CLZ on
+ * MSP432 (count-trailing-zeros on HOST).
+ *
+ * @param base  Pointer to the bitset
+ * @param nbits Number of bits to examine
+ * @return Index of the first set bit, or -1 if none is set
+ */
+int32_t find_first_bit(const uint8_t * base, size_t nbits);
+
 /* ===== New memory-manipulation functions ===== */
 
 /**
  * @brief Move length bytes from src to dst, safe for overlapping regions.
+ *
+ * Disjoint regions go straight to my_memcopy. Overlapping moves use the same
+ * word/block engine, walking forward when dst is below src and backward when
+ * dst is above src.
+ *
  * @param src Source byte pointer
  * @param dst Destination byte pointer
  * @param length Number of bytes to move
@@ -112,6 +202,12 @@ uint8_t * my_memmove(uint8_t * src, uint8_t * dst, size_t length);
 
 /**
  * @brief Copy length bytes from src to dst (overlap undefined).
+ *
+ * Copies below MEM_WORD_THRESHOLD bytes are done byte by byte. Larger copies
+ * align the destination, move 32-bit words (LDM/STM bursts on MSP432,
+ * SSE2/AVX2 vectors on HOST once MEM_BLOCK_THRESHOLD is reached) and finish
+ * the tail byte by byte.
+ *
  * @param src Source byte pointer
  * @param dst Destination byte pointer
  * @param length Number of bytes to copy
@@ -121,6 +217,10 @@ uint8_t * my_memcopy(uint8_t * src, uint8_t * dst, size_t length);
 
 /**
  * @brief Set length bytes at src to given value.
+ *
+ * The value is replicated into a 32-bit word and stored a word (MSP432
+ * STM bursts, HOST SSE2/AVX2 vectors) at a time past MEM_WORD_THRESHOLD.
+ *
  * @param src Byte pointer
  * @param length Number of bytes to set
  * @param value Byte value to set
@@ -136,16 +236,80 @@ uint8_t * my_memset(uint8_t * src, size_t length, uint8_t value);
  */
 uint8_t * my_memzero(uint8_t * src, size_t length);
 
+/**
+ * @brief Fill count 16-bit elements at dst with value.
+ * @param dst Pointer to a (naturally aligned) uint16_t array
+ * @param count Number of elements to set
+ * @param value Element value
+ * @return Pointer to dst
+ */
+uint16_t * my_memset16(uint16_t * dst, size_t count, uint16_t value);
+
+/**
+ * @brief Fill count 32-bit elements at dst with value.
+ * @param dst Pointer to a (naturally aligned) uint32_t array
+ * @param count Number of elements to set
+ * @param value Element value
+ * @return Pointer to dst
+ */
+uint32_t * my_memset32(uint32_t * dst, size_t count, uint32_t value);
+
+/**
+ * @brief Set length bytes at src to value with non-temporal stores.
+ *
+ * Streaming mode for large capture buffers: from MEM_STREAM_THRESHOLD bytes
+ * on, HOST writes bypass the cache so the working set is not evicted.
+ * Otherwise (and always on MSP432) behaves like my_memset.
+ *
+ * @param src Byte pointer
+ * @param length Number of bytes to set
+ * @param value Byte value to set
+ * @return Pointer to src
+ */
+uint8_t * my_memset_stream(uint8_t * src, size_t length, uint8_t value);
+
+/**
+ * @brief Zero out length bytes at src with non-temporal stores.
+ * @param src Byte pointer
+ * @param length Number of bytes to zero
+ * @return Pointer to src
+ */
+uint8_t * my_memzero_stream(uint8_t * src, size_t length);
+
 /**
  * @brief Reverse the order of length bytes at src.
+ *
+ * Swaps byte-reversed 32-bit words (REV on MSP432, bswap on HOST) and, on
+ * HOST, 16-byte vectors from both ends. Valid for every length, including 0.
+ *
  * @param src Byte pointer
  * @param length Number of bytes to reverse
  * @return Pointer to src
  */
 uint8_t * my_reverse(uint8_t * src, size_t length);
 
+/**
+ * @brief Reverse the order of count 16-bit elements at src.
+ * @param src Pointer to a (naturally aligned) uint16_t array
+ * @param count Number of elements to reverse
+ * @return Pointer to src
+ */
+uint16_t * my_reverse16(uint16_t * src, size_t count);
+
+/**
+ * @brief Reverse the order of count 32-bit elements at src.
+ * @param src Pointer to a (naturally aligned) uint32_t array
+ * @param count Number of elements to reverse
+ * @return Pointer to src
+ */
+uint32_t * my_reverse32(uint32_t * src, size_t count);
+
 /**
  * @brief Dynamically allocate a buffer of length 32-bit words.
+ *
+ * Uses the O(1) block pool (pool.h) when the request fits a block and falls
+ * back to malloc otherwise.
+ *
  * @param length Number of 32-bit words
  * @return Pointer to allocated buffer, or NULL on failure
  */
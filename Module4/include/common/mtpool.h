@@ -0,0 +1,86 @@
+/*****************************************************************************
+ * @file mtpool.h
+ * @brief Thread-safe fixed-size block pool for the HOST build
+ *
+ * Multi-threaded counterpart of the reserve_words/free_words pool. Each
+ * thread keeps a small cache of free blocks; caches refill from and spill to
+ * a global lock-free free list (Treiber stack) whose head carries a tag that
+ * is bumped on every update, which protects it against ABA. Requests that do
+ * not fit a block, or arrive while the pool is exhausted, fall back to malloc.
+ *
+ * HOST only (POSIX threads).
+ *
+ * This code was written as part of the Introduction to Embedded Systems
+ * Software and Development Environments course (University of Colorado Boulder).
+ *
+ * @author Timofei Alekseenko
+ * @date October 17, 2026
+ *
+ *****************************************************************************/
+
+#ifndef __MTPOOL_H__
+#define __MTPOOL_H__
+
+#include <stdint.h>
+#include <stddef.h>
+
+/* Pool geometry (override with -D at build time) */
+#ifndef MTPOOL_BLOCK_WORDS
+#define MTPOOL_BLOCK_WORDS (16)
+#endif
+
+#ifndef MTPOOL_BLOCK_COUNT
+#define MTPOOL_BLOCK_COUNT (4096)
+#endif
+
+/* Free blocks a thread may hold before spilling half to the global list */
+#ifndef MTPOOL_CACHE_SIZE
+#define MTPOOL_CACHE_SIZE  (32)
+#endif
+
+/**
+ * @brief Pool usage counters
+ */
+typedef struct {
+  uint32_t block_words;  /* Words per block */
+  uint32_t block_count;  /* Blocks in the pool */
+  uint32_t outstanding;  /* Blocks allocated or parked in thread caches */
+  uint32_t high_water;   /* Most blocks ever outstanding at once */
+  uint32_t misses;       /* Requests served by the malloc fallback */
+} mtpool_stats_t;
+
+/**
+ * @brief Allocate length 32-bit words (thread-safe reserve_words)
+ * @param length Number of 32-bit words
+ * @return Pointer to a pool block, a malloc'ed buffer if the request is too
+ *         big or the pool is exhausted, or NULL on failure
+ */
+int32_t * mtpool_reserve_words(size_t length);
+
+/**
+ * @brief Free words from mtpool_reserve_words, from any thread
+ * @param src Pointer returned by mtpool_reserve_words
+ */
+void mtpool_free_words(int32_t * src);
+
+/**
+ * @brief Check whether a pointer is a block of the pool
+ * @param src Pointer to check
+ * @return 1 if src is a pool block, 0 otherwise
+ */
+uint8_t mtpool_owns(const int32_t * src);
+
+/**
+ * @brief Return the calling thread's cached blocks to the global list
+ *
+ * Runs automatically when a thread created with pthread_create exits.
+ */
+void mtpool_thread_flush(void);
+
+/**
+ * @brief Copy the pool counters
+ * @param stats Destination for the counters
+ */
+void mtpool_get_stats(mtpool_stats_t * stats);
+
+#endif /* __MTPOOL_H__ */
@@ -0,0 +1,76 @@
+/*****************************************************************************
+ * @file pool.h
+ * @brief Fixed-size block pool behind reserve_words/free_words
+ *
+ * POOL_BLOCK_COUNT blocks of POOL_BLOCK_WORDS 32-bit words each. Allocation
+ * and free are O(1) and the pool cannot fragment. On MSP432 the storage lives
+ * in the .pool section of msp432p401r.lds instead of the sbrk heap.
+ *
+ * This code was written as part of the Introduction to Embedded Systems
+ * Software and Development Environments course (University of Colorado Boulder).
+ *
+ * @author Timofei Alekseenko
+ * @date October 17, 2026
+ *
+ *****************************************************************************/
+
+#ifndef __POOL_H__
+#define __POOL_H__
+
+#include <stdint.h>
+#include <stddef.h>
+
+/* Pool geometry (override with -D at build time) */
+#ifndef POOL_BLOCK_WORDS
+#define POOL_BLOCK_WORDS (16)
+#endif
+
+#ifndef POOL_BLOCK_COUNT
+#define POOL_BLOCK_COUNT (32)
+#endif
+
+/**
+ * @brief Pool usage counters
+ */
+typedef struct {
+  uint32_t block_words;  /* Words per block */
+  uint32_t block_count;  /* Blocks in the pool */
+  uint32_t in_use;       /* Blocks currently allocated */
+  uint32_t high_water;   /* Most blocks ever allocated at once */
+  uint32_t allocs;       /* Requests served from the pool */
+  uint32_t misses;       /* Requests too big or made while exhausted */
+} pool_stats_t;
+
+/**
+ * @brief Take one block from the pool.
+ * @param length Number of 32-bit words needed
+ * @return Pointer to a block, or NULL if length exceeds POOL_BLOCK_WORDS or
+ *         the pool is exhausted
+ */
+int32_t * pool_alloc(size_t length);
+
+/**
+ * @brief Return a block to the pool.
+ * @param src Pointer returned by pool_alloc
+ */
+void pool_free(int32_t * src);
+
+/**
+ * @brief Check whether a pointer is a block of the pool.
+ * @param src Pointer to check
+ * @return 1 if src was handed out by pool_alloc, 0 otherwise
+ */
+uint8_t pool_owns(const int32_t * src);
+
+/**
+ * @brief Copy the pool counters.
+ * @param stats Destination for the counters
+ */
+void pool_get_stats(pool_stats_t * stats);
+
+/**
+ * @brief Prints the pool counters (when VERBOSE is enabled)
+ */
+void print_pool_stats(void);
+
+#endif /* __POOL_H__ */
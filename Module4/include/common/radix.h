@@ -0,0 +1,87 @@
+/*****************************************************************************
+ * @file radix.h
+ * @brief Stable LSD radix sort for 16-bit and 32-bit unsigned samples
+ *
+ * Sorts in the same descending order as sort_array, in O(passes * size)
+ * instead of O(size log size) comparisons. Samples with equal keys keep
+ * their input order. The digit histograms of all passes are counted in one
+ * read of the input before the first scatter, and a pass whose digit is
+ * the same for every sample is skipped, so narrow data (e.g. 14-bit ADC
+ * results) costs fewer passes.
+ *
+ * The caller provides a scratch array of size samples; it holds garbage
+ * afterwards. Up to SORT_INSERTION_MAX samples are insertion sorted.
+ *
+ * On HOST, the _mt variants split the array on its most significant
+ * differing digit first: the tpool workers count and scatter chunks into
+ * 256 buckets, then sort each bucket's low bits with the LSD passes, one
+ * bucket per task.
+ *
+ * This code was written as part of the Introduction to Embedded Systems
+ * Software and Development Environments course (University of Colorado Boulder).
+ *
+ * @author Timofei Alekseenko
+ * @date October 17, 2026
+ *
+ *****************************************************************************/
+
+#ifndef __RADIX_H__
+#define __RADIX_H__
+
+#include <stdint.h>
+
+/* Digit width for 32-bit keys from RADIX_WIDE_MIN samples on: 11 bits is
+   3 passes with 8 KiB tables instead of 4; MSP432 stays at 8 bits to keep
+   the tables to 4 KiB of stack */
+#ifndef RADIX_DIGIT_BITS_U32
+#if defined (MSP432)
+#define RADIX_DIGIT_BITS_U32 (8)
+#else
+#define RADIX_DIGIT_BITS_U32 (11)
+#endif
+#endif
+
+/* Smaller arrays always use 8-bit digits: clearing and scanning wider
+   tables would cost more than the pass they save */
+#ifndef RADIX_WIDE_MIN
+#define RADIX_WIDE_MIN (1u << 14)
+#endif
+
+/* HOST: the _mt variants go parallel from this many samples */
+#ifndef RADIX_PARALLEL_MIN
+#define RADIX_PARALLEL_MIN (1u << 18)
+#endif
+
+/**
+ * @brief Stable radix sort, largest to smallest, two 8-bit passes
+ * @param data Pointer to the data array
+ * @param size Size of the array
+ * @param scratch Work array of size samples (not data)
+ */
+void radix_sort_u16(uint16_t *data, unsigned int size, uint16_t *scratch);
+
+/**
+ * @brief Stable radix sort, largest to smallest, four 8-bit passes or
+ *        (from RADIX_WIDE_MIN samples) RADIX_DIGIT_BITS_U32-bit passes
+ * @param data Pointer to the data array
+ * @param size Size of the array
+ * @param scratch Work array of size samples (not data)
+ */
+void radix_sort_u32(uint32_t *data, unsigned int size, uint32_t *scratch);
+
+#if defined (HOST)
+/**
+ * @brief Same result as radix_sort_u16/u32, spread over the tpool threads
+ *
+ * Falls back to the serial sort below RADIX_PARALLEL_MIN samples, with a
+ * single thread, or if the partition tables cannot be allocated.
+ *
+ * @param data Pointer to the data array
+ * @param size Size of the array
+ * @param scratch Work array of size samples (not data)
+ */
+void radix_sort_u16_mt(uint16_t *data, unsigned int size, uint16_t *scratch);
+void radix_sort_u32_mt(uint32_t *data, unsigned int size, uint32_t *scratch);
+#endif
+
+#endif /* __RADIX_H__ */
@@ -0,0 +1,269 @@
+/*****************************************************************************
+ * @file radix_template.h
+ * @brief Type-generic body of the radix.h sorts
+ *
+ * Included by radix.c once per key type, with these defined:
+ *
+ *   RADIX_SFX        name suffix (u16, u32)
+ *   RADIX_T          unsigned key type
+ *   RADIX_KEY_BITS   bits in RADIX_T
+ *   RADIX_WIDE_BITS  digit width of the LSD passes from RADIX_WIDE_MIN
+ *                    samples on (8 below that)
+ *
+ * The parameters are undefined again at the end of this file.
+ *
+ * This code was written as part of the Introduction to Embedded Systems
+ * Software and Development Environments course (University of Colorado Boulder).
+ *
+ * @author Timofei Alekseenko
+ * @date October 17, 2026
+ *
+ *****************************************************************************/
+
+/* No include guard: meant to be included several times */
+
+#define RADIX_CAT_(a, b) a##b
+#define RADIX_CAT(a, b)  RADIX_CAT_(a, b)
+#define RADIX_FN(name)   RADIX_CAT(name, RADIX_SFX)
+
+/* Digit table entries for all passes, at either width */
+#define RADIX_TABLE_NARROW (((RADIX_KEY_BITS + 7) / 8) * 256)
+#define RADIX_TABLE_WIDE   (((RADIX_KEY_BITS + RADIX_WIDE_BITS - 1) /       \
+                             RADIX_WIDE_BITS) << RADIX_WIDE_BITS)
+#define RADIX_TABLE        (RADIX_TABLE_NARROW > RADIX_TABLE_WIDE ?         \
+                            RADIX_TABLE_NARROW : RADIX_TABLE_WIDE)
+
+/* Stable insertion sort, descending */
+static void RADIX_FN(insertion_sort_)(RADIX_T *data, unsigned int size) {
+  for (unsigned int i = 1; i < size; i++) {
+    RADIX_T value = data[i];
+    unsigned int j = i;
+    while (j > 0 && data[j - 1] < value) {
+      data[j] = data[j - 1];
+      j--;
+    }
+    data[j] = value;
+  }
+}
+
+/*
+ * Histograms of all passes of one digit width from one read of the input;
+ * called with constant bits and passes so the inner loop unrolls
+ */
+static inline void RADIX_FN(count_digits_)(const RADIX_T *src,
+                                           unsigned int size,
+                                           uint32_t *counts,
+                                           unsigned int bits,
+                                           unsigned int passes) {
+  unsigned int digits = 1u << bits;
+
+  my_memzero((uint8_t *)counts, passes * digits * sizeof(uint32_t));
+  for (unsigned int i = 0; i < size; i++) {
+    RADIX_T key = src[i];
+    for (unsigned int p = 0; p < passes; p++) {
+      counts[p * digits + ((key >> (p * bits)) & (digits - 1))]++;
+    }
+  }
+}
+
+/*
+ * Stable descending sort of src on its key bits below hi, using dst as
+ * the other buffer. Returns whichever of the two holds the result.
+ */
+static RADIX_T *RADIX_FN(lsd_)(RADIX_T *src, RADIX_T *dst, unsigned int size,
+                               unsigned int hi) {
+  uint32_t counts[RADIX_TABLE];
+  /* Wide digits save a pass only once the tables are small next to size */
+  unsigned int bits = size >= RADIX_WIDE_MIN ? RADIX_WIDE_BITS : 8;
+  unsigned int digits = 1u << bits;
+  unsigned int passes = (hi + bits - 1) / bits;
+
+  if (passes == 0) return src;
+  if (bits == 8) {
+    RADIX_FN(count_digits_)(src, size, counts, 8, (RADIX_KEY_BITS + 7) / 8);
+  } else {
+    RADIX_FN(count_digits_)(src, size, counts, RADIX_WIDE_BITS,
+                            (RADIX_KEY_BITS + RADIX_WIDE_BITS - 1) /
+                            RADIX_WIDE_BITS);
+  }
+
+  for (unsigned int p = 0; p < passes; p++) {
+    unsigned int shift = p * bits;
+    uint32_t *offsets = counts + p * digits;
+    uint32_t pos = 0;
+    RADIX_T *swap;
+
+    /* Every key has the same digit: the pass would copy the array */
+    if (offsets[(src[0] >> shift) & (digits - 1)] == size) continue;
+
+    /* Largest digit first */
+    for (unsigned int d = digits; d > 0; d--) {
+      uint32_t count = offsets[d - 1];
+      offsets[d - 1] = pos;
+      pos += count;
+    }
+    for (unsigned int i = 0; i < size; i++) {
+      RADIX_T key = src[i];
+      dst[offsets[(key >> shift) & (digits - 1)]++] = key;
+    }
+    swap = src;
+    src = dst;
+    dst = swap;
+  }
+  return src;
+}
+
+void RADIX_FN(radix_sort_)(RADIX_T *data, unsigned int size,
+                           RADIX_T *scratch) {
+  RADIX_T *sorted;
+
+  if (size <= SORT_INSERTION_MAX) {
+    RADIX_FN(insertion_sort_)(data, size);
+    return;
+  }
+  sorted = RADIX_FN(lsd_)(data, scratch, size, RADIX_KEY_BITS);
+  if (sorted != data) {
+    my_memcopy((uint8_t *)sorted, (uint8_t *)data, size * sizeof(RADIX_T));
+  }
+}
+
+#if defined (HOST)
+typedef struct {
+  RADIX_T *data;
+  RADIX_T *scratch;
+  unsigned int size;
+  unsigned int chunks;
+  unsigned int shift;               /* Low bit of the partition digit */
+  RADIX_T low[RADIX_MAX_CHUNKS];    /* Per-chunk minimum and maximum */
+  RADIX_T high[RADIX_MAX_CHUNKS];
+  uint32_t (*counts)[256];          /* Per chunk: counts, then offsets */
+  uint32_t start[256];              /* Buckets in scratch, largest first */
+  uint32_t length[256];
+} RADIX_FN(mt_job_);
+
+static void RADIX_FN(mt_range_)(void *arg, uint32_t index) {
+  RADIX_FN(mt_job_) *job = (RADIX_FN(mt_job_) *)arg;
+  unsigned int begin, end;
+  RADIX_T low, high;
+
+  chunk_bounds(job->size, job->chunks, index, &begin, &end);
+  low = high = job->data[begin];
+  for (unsigned int i = begin + 1; i < end; i++) {
+    RADIX_T key = job->data[i];
+    if (key < low) low = key;
+    if (key > high) high = key;
+  }
+  job->low[index] = low;
+  job->high[index] = high;
+}
+
+static void RADIX_FN(mt_count_)(void *arg, uint32_t index) {
+  RADIX_FN(mt_job_) *job = (RADIX_FN(mt_job_) *)arg;
+  uint32_t *counts = job->counts[index];
+  unsigned int begin, end;
+
+  chunk_bounds(job->size, job->chunks, index, &begin, &end);
+  my_memzero((uint8_t *)counts, 256 * sizeof(uint32_t));
+  for (unsigned int i = begin; i < end; i++) {
+    counts[(job->data[i] >> job->shift) & 0xFF]++;
+  }
+}
+
+/* Chunks scatter in order, so each bucket keeps the input order */
+static void RADIX_FN(mt_scatter_)(void *arg, uint32_t index) {
+  RADIX_FN(mt_job_) *job = (RADIX_FN(mt_job_) *)arg;
+  uint32_t *offsets = job->counts[index];
+  unsigned int begin, end;
+
+  chunk_bounds(job->size, job->chunks, index, &begin, &end);
+  for (unsigned int i = begin; i < end; i++) {
+    RADIX_T key = job->data[i];
+    job->scratch[offsets[(key >> job->shift) & 0xFF]++] = key;
+  }
+}
+
+/* Sort one bucket's low bits; the result goes back to data */
+static void RADIX_FN(mt_bucket_)(void *arg, uint32_t index) {
+  RADIX_FN(mt_job_) *job = (RADIX_FN(mt_job_) *)arg;
+  RADIX_T *src = job->scratch + job->start[index];
+  RADIX_T *dst = job->data + job->start[index];
+  unsigned int size = job->length[index];
+  RADIX_T *sorted;
+
+  if (size == 0) return;
+  if (size <= SORT_INSERTION_MAX) {
+    RADIX_FN(insertion_sort_)(src, size);
+    sorted = src;
+  } else {
+    sorted = RADIX_FN(lsd_)(src, dst, size, job->shift);
+  }
+  if (sorted != dst) {
+    my_memcopy((uint8_t *)sorted, (uint8_t *)dst, size * sizeof(RADIX_T));
+  }
+}
+
+void RADIX_CAT(RADIX_FN(radix_sort_), _mt)(RADIX_T *data, unsigned int size,
+                                           RADIX_T *scratch) {
+  RADIX_FN(mt_job_) *job;
+  uint32_t threads = size >= RADIX_PARALLEL_MIN ? tpool_threads() : 1;
+  RADIX_T low, high, diff;
+  unsigned int top = 0;
+  uint32_t pos = 0;
+
+  job = threads > 1 ? (RADIX_FN(mt_job_) *)malloc(sizeof(*job)) : NULL;
+  if (job != NULL) {
+    job->counts = (uint32_t (*)[256])malloc(2 * threads *
+                                            sizeof(job->counts[0]));
+  }
+  if (job == NULL || job->counts == NULL) {
+    free(job);
+    RADIX_FN(radix_sort_)(data, size, scratch);
+    return;
+  }
+  job->data = data;
+  job->scratch = scratch;
+  job->size = size;
+  job->chunks = 2 * threads < RADIX_MAX_CHUNKS ? 2 * threads
+                                               : RADIX_MAX_CHUNKS;
+
+  /* Partition on the top 8 bits that differ anywhere in the array */
+  tpool_run(RADIX_FN(mt_range_), job, job->chunks);
+  low = job->low[0];
+  high = job->high[0];
+  for (unsigned int c = 1; c < job->chunks; c++) {
+    if (job->low[c] < low) low = job->low[c];
+    if (job->high[c] > high) high = job->high[c];
+  }
+  diff = low ^ high;
+  while (diff >> top > 1) top++;
+  job->shift = top >= 8 ? top - 7 : 0;
+
+  if (diff != 0) {
+    tpool_run(RADIX_FN(mt_count_), job, job->chunks);
+    for (unsigned int d = 256; d > 0; d--) {
+      job->start[d - 1] = pos;
+      for (unsigned int c = 0; c < job->chunks; c++) {
+        uint32_t count = job->counts[c][d - 1];
+        job->counts[c][d - 1] = pos;
+        pos += count;
+      }
+      job->length[d - 1] = pos - job->start[d - 1];
+    }
+    tpool_run(RADIX_FN(mt_scatter_), job, job->chunks);
+    tpool_run(RADIX_FN(mt_bucket_), job, 256);
+  }
+  free(job->counts);
+  free(job);
+}
+#endif
+
+#undef RADIX_TABLE
+#undef RADIX_TABLE_WIDE
+#undef RADIX_TABLE_NARROW
+#undef RADIX_FN
+#undef RADIX_CAT
+#undef RADIX_CAT_
+#undef RADIX_SFX
+#undef RADIX_T
+#undef RADIX_KEY_BITS
+#undef RADIX_WIDE_BITS
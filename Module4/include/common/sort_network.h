@@ -0,0 +1,138 @@
+/*****************************************************************************
+ * @file sort_network.h
+ * @brief Comparator lists of fixed-size sorting networks
+ *
+ * Each SORT_NETWORK_<n>(CMP) expands to CMP(i, j) for every comparator of
+ * Batcher's odd-even merge sort on n inputs, in order, with i < j. The
+ * user defines CMP to order one pair, so the whole network becomes
+ * straight-line code at compile time: a fixed sequence of comparisons
+ * whatever the data.
+ *
+ * The lists follow Knuth's formulation (TAOCP vol. 3, 5.3.4, exercise 32)
+ * for p = 1, 2, 4, ... and k = p, p / 2, ... 1, a comparator (i + j,
+ * i + j + k) for j = k mod p, k mod p + 2k, ... below n - k and i below
+ * min(k, n - j - k), kept when (i + j) / 2p == (i + j + k) / 2p. That
+ * sorts any n, including 40, which is not a power of two. The 8 and 16
+ * lists were also checked against every 0-1 input (enough by the 0-1
+ * principle), the 32 and 40 lists against random ones.
+ *
+ * This code was written as part of the Introduction to Embedded Systems
+ * Software and Development Environments course (University of Colorado Boulder).
+ *
+ * @author Timofei Alekseenko
+ * @date October 17, 2026
+ *
+ *****************************************************************************/
+
+#ifndef __SORT_NETWORK_H__
+#define __SORT_NETWORK_H__
+
+/* 8 inputs: 19 comparators, depth 6 */
+#define SORT_NETWORK_8(CMP) \
+  CMP(0, 1) CMP(2, 3) CMP(4, 5) CMP(6, 7) CMP(0, 2) CMP(1, 3) CMP(4, 6) \
+  CMP(5, 7) CMP(1, 2) CMP(5, 6) CMP(0, 4) CMP(1, 5) CMP(2, 6) CMP(3, 7) \
+  CMP(2, 4) CMP(3, 5) CMP(1, 2) CMP(3, 4) CMP(5, 6)
+
+/* 16 inputs: 63 comparators, depth 10 */
+#define SORT_NETWORK_16(CMP) \
+  CMP(0, 1) CMP(2, 3) CMP(4, 5) CMP(6, 7) CMP(8, 9) CMP(10, 11) CMP(12, 13) \
+  CMP(14, 15) CMP(0, 2) CMP(1, 3) CMP(4, 6) CMP(5, 7) CMP(8, 10) CMP(9, 11) \
+  CMP(12, 14) CMP(13, 15) CMP(1, 2) CMP(5, 6) CMP(9, 10) CMP(13, 14) \
+  CMP(0, 4) CMP(1, 5) CMP(2, 6) CMP(3, 7) CMP(8, 12) CMP(9, 13) CMP(10, 14) \
+  CMP(11, 15) CMP(2, 4) CMP(3, 5) CMP(10, 12) CMP(11, 13) CMP(1, 2) \
+  CMP(3, 4) CMP(5, 6) CMP(9, 10) CMP(11, 12) CMP(13, 14) CMP(0, 8) \
+  CMP(1, 9) CMP(2, 10) CMP(3, 11) CMP(4, 12) CMP(5, 13) CMP(6, 14) \
+  CMP(7, 15) CMP(4, 8) CMP(5, 9) CMP(6, 10) CMP(7, 11) CMP(2, 4) CMP(3, 5) \
+  CMP(6, 8) CMP(7, 9) CMP(10, 12) CMP(11, 13) CMP(1, 2) CMP(3, 4) CMP(5, 6) \
+  CMP(7, 8) CMP(9, 10) CMP(11, 12) CMP(13, 14)
+
+/* 32 inputs: 191 comparators, depth 15 */
+#define SORT_NETWORK_32(CMP) \
+  CMP(0, 1) CMP(2, 3) CMP(4, 5) CMP(6, 7) CMP(8, 9) CMP(10, 11) CMP(12, 13) \
+  CMP(14, 15) CMP(16, 17) CMP(18, 19) CMP(20, 21) CMP(22, 23) CMP(24, 25) \
+  CMP(26, 27) CMP(28, 29) CMP(30, 31) CMP(0, 2) CMP(1, 3) CMP(4, 6) \
+  CMP(5, 7) CMP(8, 10) CMP(9, 11) CMP(12, 14) CMP(13, 15) CMP(16, 18) \
+  CMP(17, 19) CMP(20, 22) CMP(21, 23) CMP(24, 26) CMP(25, 27) CMP(28, 30) \
+  CMP(29, 31) CMP(1, 2) CMP(5, 6) CMP(9, 10) CMP(13, 14) CMP(17, 18) \
+  CMP(21, 22) CMP(25, 26) CMP(29, 30) CMP(0, 4) CMP(1, 5) CMP(2, 6) \
+  CMP(3, 7) CMP(8, 12) CMP(9, 13) CMP(10, 14) CMP(11, 15) CMP(16, 20) \
+  CMP(17, 21) CMP(18, 22) CMP(19, 23) CMP(24, 28) CMP(25, 29) CMP(26, 30) \
+  CMP(27, 31) CMP(2, 4) CMP(3, 5) CMP(10, 12) CMP(11, 13) CMP(18, 20) \
+  CMP(19, 21) CMP(26, 28) CMP(27, 29) CMP(1, 2) CMP(3, 4) CMP(5, 6) \
+  CMP(9, 10) CMP(11, 12) CMP(13, 14) CMP(17, 18) CMP(19, 20) CMP(21, 22) \
+  CMP(25, 26) CMP(27, 28) CMP(29, 30) CMP(0, 8) CMP(1, 9) CMP(2, 10) \
+  CMP(3, 11) CMP(4, 12) CMP(5, 13) CMP(6, 14) CMP(7, 15) CMP(16, 24) \
+  CMP(17, 25) CMP(18, 26) CMP(19, 27) CMP(20, 28) CMP(21, 29) CMP(22, 30) \
+  CMP(23, 31) CMP(4, 8) CMP(5, 9) CMP(6, 10) CMP(7, 11) CMP(20, 24) \
+  CMP(21, 25) CMP(22, 26) CMP(23, 27) CMP(2, 4) CMP(3, 5) CMP(6, 8) \
+  CMP(7, 9) CMP(10, 12) CMP(11, 13) CMP(18, 20) CMP(19, 21) CMP(22, 24) \
+  CMP(23, 25) CMP(26, 28) CMP(27, 29) CMP(1, 2) CMP(3, 4) CMP(5, 6) \
+  CMP(7, 8) CMP(9, 10) CMP(11, 12) CMP(13, 14) CMP(17, 18) CMP(19, 20) \
+  CMP(21, 22) CMP(23, 24) CMP(25, 26) CMP(27, 28) CMP(29, 30) CMP(0, 16) \
+  CMP(1, 17) CMP(2, 18) CMP(3, 19) CMP(4, 20) CMP(5, 21) CMP(6, 22) \
+  CMP(7, 23) CMP(8, 24) CMP(9, 25) CMP(10, 26) CMP(11, 27) CMP(12, 28) \
+  CMP(13, 29) CMP(14, 30) CMP(15, 31) CMP(8, 16) CMP(9, 17) CMP(10, 18) \
+  CMP(11, 19) CMP(12, 20) CMP(13, 21) CMP(14, 22) CMP(15, 23) CMP(4, 8) \
+  CMP(5, 9) CMP(6, 10) CMP(7, 11) CMP(12, 16) CMP(13, 17) CMP(14, 18) \
+  CMP(15, 19) CMP(20, 24) CMP(21, 25) CMP(22, 26) CMP(23, 27) CMP(2, 4) \
+  CMP(3, 5) CMP(6, 8) CMP(7, 9) CMP(10, 12) CMP(11, 13) CMP(14, 16) \
+  CMP(15, 17) CMP(18, 20) CMP(19, 21) CMP(22, 24) CMP(23, 25) CMP(26, 28) \
+  CMP(27, 29) CMP(1, 2) CMP(3, 4) CMP(5, 6) CMP(7, 8) CMP(9, 10) \
+  CMP(11, 12) CMP(13, 14) CMP(15, 16) CMP(17, 18) CMP(19, 20) CMP(21, 22) \
+  CMP(23, 24) CMP(25, 26) CMP(27, 28) CMP(29, 30)
+
+/* 40 inputs: 305 comparators, depth 21 */
+#define SORT_NETWORK_40(CMP) \
+  CMP(0, 1) CMP(2, 3) CMP(4, 5) CMP(6, 7) CMP(8, 9) CMP(10, 11) CMP(12, 13) \
+  CMP(14, 15) CMP(16, 17) CMP(18, 19) CMP(20, 21) CMP(22, 23) CMP(24, 25) \
+  CMP(26, 27) CMP(28, 29) CMP(30, 31) CMP(32, 33) CMP(34, 35) CMP(36, 37) \
+  CMP(38, 39) CMP(0, 2) CMP(1, 3) CMP(4, 6) CMP(5, 7) CMP(8, 10) CMP(9, 11) \
+  CMP(12, 14) CMP(13, 15) CMP(16, 18) CMP(17, 19) CMP(20, 22) CMP(21, 23) \
+  CMP(24, 26) CMP(25, 27) CMP(28, 30) CMP(29, 31) CMP(32, 34) CMP(33, 35) \
+  CMP(36, 38) CMP(37, 39) CMP(1, 2) CMP(5, 6) CMP(9, 10) CMP(13, 14) \
+  CMP(17, 18) CMP(21, 22) CMP(25, 26) CMP(29, 30) CMP(33, 34) CMP(37, 38) \
+  CMP(0, 4) CMP(1, 5) CMP(2, 6) CMP(3, 7) CMP(8, 12) CMP(9, 13) CMP(10, 14) \
+  CMP(11, 15) CMP(16, 20) CMP(17, 21) CMP(18, 22) CMP(19, 23) CMP(24, 28) \
+  CMP(25, 29) CMP(26, 30) CMP(27, 31) CMP(32, 36) CMP(33, 37) CMP(34, 38) \
+  CMP(35, 39) CMP(2, 4) CMP(3, 5) CMP(10, 12) CMP(11, 13) CMP(18, 20) \
+  CMP(19, 21) CMP(26, 28) CMP(27, 29) CMP(34, 36) CMP(35, 37) CMP(1, 2) \
+  CMP(3, 4) CMP(5, 6) CMP(9, 10) CMP(11, 12) CMP(13, 14) CMP(17, 18) \
+  CMP(19, 20) CMP(21, 22) CMP(25, 26) CMP(27, 28) CMP(29, 30) CMP(33, 34) \
+  CMP(35, 36) CMP(37, 38) CMP(0, 8) CMP(1, 9) CMP(2, 10) CMP(3, 11) \
+  CMP(4, 12) CMP(5, 13) CMP(6, 14) CMP(7, 15) CMP(16, 24) CMP(17, 25) \
+  CMP(18, 26) CMP(19, 27) CMP(20, 28) CMP(21, 29) CMP(22, 30) CMP(23, 31) \
+  CMP(4, 8) CMP(5, 9) CMP(6, 10) CMP(7, 11) CMP(20, 24) CMP(21, 25) \
+  CMP(22, 26) CMP(23, 27) CMP(2, 4) CMP(3, 5) CMP(6, 8) CMP(7, 9) \
+  CMP(10, 12) CMP(11, 13) CMP(18, 20) CMP(19, 21) CMP(22, 24) CMP(23, 25) \
+  CMP(26, 28) CMP(27, 29) CMP(34, 36) CMP(35, 37) CMP(1, 2) CMP(3, 4) \
+  CMP(5, 6) CMP(7, 8) CMP(9, 10) CMP(11, 12) CMP(13, 14) CMP(17, 18) \
+  CMP(19, 20) CMP(21, 22) CMP(23, 24) CMP(25, 26) CMP(27, 28) CMP(29, 30) \
+  CMP(33, 34) CMP(35, 36) CMP(37, 38) CMP(0, 16) CMP(1, 17) CMP(2, 18) \
+  CMP(3, 19) CMP(4, 20) CMP(5, 21) CMP(6, 22) CMP(7, 23) CMP(8, 24) \
+  CMP(9, 25) CMP(10, 26) CMP(11, 27) CMP(12, 28) CMP(13, 29) CMP(14, 30) \
+  CMP(15, 31) CMP(8, 16) CMP(9, 17) CMP(10, 18) CMP(11, 19) CMP(12, 20) \
+  CMP(13, 21) CMP(14, 22) CMP(15, 23) CMP(4, 8) CMP(5, 9) CMP(6, 10) \
+  CMP(7, 11) CMP(12, 16) CMP(13, 17) CMP(14, 18) CMP(15, 19) CMP(20, 24) \
+  CMP(21, 25) CMP(22, 26) CMP(23, 27) CMP(2, 4) CMP(3, 5) CMP(6, 8) \
+  CMP(7, 9) CMP(10, 12) CMP(11, 13) CMP(14, 16) CMP(15, 17) CMP(18, 20) \
+  CMP(19, 21) CMP(22, 24) CMP(23, 25) CMP(26, 28) CMP(27, 29) CMP(34, 36) \
+  CMP(35, 37) CMP(1, 2) CMP(3, 4) CMP(5, 6) CMP(7, 8) CMP(9, 10) \
+  CMP(11, 12) CMP(13, 14) CMP(15, 16) CMP(17, 18) CMP(19, 20) CMP(21, 22) \
+  CMP(23, 24) CMP(25, 26) CMP(27, 28) CMP(29, 30) CMP(33, 34) CMP(35, 36) \
+  CMP(37, 38) CMP(0, 32) CMP(1, 33) CMP(2, 34) CMP(3, 35) CMP(4, 36) \
+  CMP(5, 37) CMP(6, 38) CMP(7, 39) CMP(16, 32) CMP(17, 33) CMP(18, 34) \
+  CMP(19, 35) CMP(20, 36) CMP(21, 37) CMP(22, 38) CMP(23, 39) CMP(8, 16) \
+  CMP(9, 17) CMP(10, 18) CMP(11, 19) CMP(12, 20) CMP(13, 21) CMP(14, 22) \
+  CMP(15, 23) CMP(24, 32) CMP(25, 33) CMP(26, 34) CMP(27, 35) CMP(28, 36) \
+  CMP(29, 37) CMP(30, 38) CMP(31, 39) CMP(4, 8) CMP(5, 9) CMP(6, 10) \
+  CMP(7, 11) CMP(12, 16) CMP(13, 17) CMP(14, 18) CMP(15, 19) CMP(20, 24) \
+  CMP(21, 25) CMP(22, 26) CMP(23, 27) CMP(28, 32) CMP(29, 33) CMP(30, 34) \
+  CMP(31, 35) CMP(2, 4) CMP(3, 5) CMP(6, 8) CMP(7, 9) CMP(10, 12) \
+  CMP(11, 13) CMP(14, 16) CMP(15, 17) CMP(18, 20) CMP(19, 21) CMP(22, 24) \
+  CMP(23, 25) CMP(26, 28) CMP(27, 29) CMP(30, 32) CMP(31, 33) CMP(34, 36) \
+  CMP(35, 37) CMP(1, 2) CMP(3, 4) CMP(5, 6) CMP(7, 8) CMP(9, 10) \
+  CMP(11, 12) CMP(13, 14) CMP(15, 16) CMP(17, 18) CMP(19, 20) CMP(21, 22) \
+  CMP(23, 24) CMP(25, 26) CMP(27, 28) CMP(29, 30) CMP(31, 32) CMP(33, 34) \
+  CMP(35, 36) CMP(37, 38)
+
+#endif /* __SORT_NETWORK_H__ */
@@ -28,13 +28,100 @@
 #ifndef __STATS_H__
 #define __STATS_H__
 
+#include <stdint.h>
+
+/* sort_array: insertion sort up to this many elements */
+#ifndef SORT_INSERTION_MAX
+#define SORT_INSERTION_MAX (16)
+#endif
+
+/* sort_array: counting sort from this many elements on, introsort below */
+#ifndef SORT_COUNTING_MIN
+#define SORT_COUNTING_MIN  (128)
+#endif
+
+/* sort_array: sorting networks for sizes 8, 16, 32 and 40 (0 turns them
+   off, e.g. on HOST where introsort is faster on random data) */
+#ifndef SORT_NETWORKS
+#define SORT_NETWORKS (1)
+#endif
+
+/* find_top_k: bounded heap up to this k, or while size / k is at least
+   TOPK_HEAP_RATIO; 256-bin histogram otherwise */
+#ifndef TOPK_HEAP_MAX
+#define TOPK_HEAP_MAX   (16)
+#endif
+#ifndef TOPK_HEAP_RATIO
+#define TOPK_HEAP_RATIO (1024)
+#endif
+
+/* HOST: histograms of at least this many bytes are built on the tpool
+   worker threads (compute_statistics, find_median, find_kth, ...) */
+#ifndef STATS_PARALLEL_MIN
+#define STATS_PARALLEL_MIN (1u << 20)
+#endif
+
+/* HOST: sort_array and sort_array_<sfx> sort arrays of at least this many
+   elements on the tpool worker threads: a parallel counting sort for
+   bytes, a sample sort for the typed arrays */
+#ifndef SORT_PARALLEL_MIN
+#define SORT_PARALLEL_MIN (1u << 18)
+#endif
+
+/* HOST sample sort: buckets per thread (127 at most in all) and samples
+   drawn per bucket to choose the splitters */
+#ifndef SORT_SAMPLE_BUCKETS
+#define SORT_SAMPLE_BUCKETS (8)
+#endif
+#ifndef SORT_SAMPLE_OVERSAMPLE
+#define SORT_SAMPLE_OVERSAMPLE (32)
+#endif
+
+/**
+ * @brief Result of compute_statistics: everything print_statistics needs
+ */
+typedef struct {
+  unsigned int count;         /* Number of samples */
+  uint64_t sum;               /* Sum of all samples */
+  unsigned char minimum;
+  unsigned char maximum;
+  unsigned char mean;         /* Rounded down */
+  unsigned char median;       /* Same value as find_median */
+  uint32_t histogram[256];    /* Samples per value */
+} stats_result_t;
+
+/**
+ * @brief Computes count, sum, min, max, mean, median and the histogram in
+ *        a single pass over the data
+ *
+ * The pass only builds the histogram; the other fields are derived from its
+ * 256 bins. The array is not modified. An empty array yields all zeros.
+ * On HOST, arrays of STATS_PARALLEL_MIN bytes or more are counted in
+ * chunks on the tpool threads; the result is identical either way.
+ *
+ * @param data Pointer to the data array
+ * @param size Size of the array
+ * @param result Filled with the statistics
+ */
+void compute_statistics(unsigned char *data, unsigned int size,
+                        stats_result_t *result);
+
 /**
  * @brief Prints statistics (min, max, mean, median) of an array
+ *
+ * Equivalent to compute_statistics followed by print_stats_result.
+ *
  * @param data Pointer to the data array
  * @param size Size of the array
  */
 void print_statistics(unsigned char *data, unsigned int size);
 
+/**
+ * @brief Prints statistics previously computed by compute_statistics
+ * @param result Statistics to print
+ */
+void print_stats_result(const stats_result_t *result);
+
 /**
  * @brief Prints the array to the screen
  * @param data Pointer to the data array
@@ -44,12 +131,75 @@ void print_array(unsigned char *data, unsigned int size);
 
 /**
  * @brief Finds the median of the array (rounded down)
+ *
+ * Returns the value sort_array would leave at data[size / 2], read off a
+ * 256-bin histogram in O(size + 256). The array is not modified.
+ *
  * @param data Pointer to the data array
  * @param size Size of the array
  * @return Median value
  */
 unsigned char find_median(unsigned char *data, unsigned int size);
 
+/**
+ * @brief Finds the k-th largest value without modifying the array
+ *
+ * k counts from 0 in descending order, i.e. the value sort_array would
+ * leave at data[k]. Uses a 256-bin histogram, O(size + 256).
+ *
+ * @param data Pointer to the data array
+ * @param size Size of the array
+ * @param k Rank in descending order (clamped to size - 1)
+ * @return k-th largest value (0 for an empty array)
+ */
+unsigned char find_kth(unsigned char *data, unsigned int size,
+                       unsigned int k);
+
+/**
+ * @brief Finds a percentile without modifying the array
+ *
+ * Nearest-rank definition: the smallest value with at least pct percent of
+ * the samples at or below it. find_percentile(data, size, 50) equals
+ * find_median(data, size).
+ *
+ * @param data Pointer to the data array
+ * @param size Size of the array
+ * @param pct Percentile, 0 to 100
+ * @return Percentile value (0 for an empty array)
+ */
+unsigned char find_percentile(unsigned char *data, unsigned int size,
+                              unsigned int pct);
+
+/**
+ * @brief Finds several percentiles from one pass over the array
+ *
+ * Same values as calling find_percentile for each entry of pct, but the
+ * histogram is built once.
+ *
+ * @param data Pointer to the data array
+ * @param size Size of the array
+ * @param pct Percentiles to look up, 0 to 100 each
+ * @param count Number of entries in pct and out
+ * @param out Receives the percentile values (all 0 for an empty array)
+ */
+void find_percentiles(unsigned char *data, unsigned int size,
+                      const unsigned int *pct, unsigned int count,
+                      unsigned char *out);
+
+/**
+ * @brief Counts the samples in equal-width bins over 0..255
+ *
+ * Value v lands in bin (v * bin_count) / 256, so with 256 bins (or more)
+ * each value has its own bin and with 16 bins each covers 16 values.
+ *
+ * @param data Pointer to the data array
+ * @param size Size of the array
+ * @param bins Receives the counts, bin_count entries (256 when larger)
+ * @param bin_count Number of bins
+ */
+void find_histogram(unsigned char *data, unsigned int size, uint32_t *bins,
+                    unsigned int bin_count);
+
 /**
  * @brief Finds the mean of the array (rounded down)
  * @param data Pointer to the data array
@@ -58,8 +208,23 @@ unsigned char find_median(unsigned char *data, unsigned int size);
  */
 unsigned char find_mean(unsigned char *data, unsigned int size);
 
+/**
+ * @brief Sums the array
+ *
+ * Uses USADA8 on MSP432 (4 bytes per instruction) and PSADBW on HOST.
+ *
+ * @param data Pointer to the data array
+ * @param size Size of the array
+ * @return Sum of all elements
+ */
+uint64_t find_sum(unsigned char *data, unsigned int size);
+
 /**
  * @brief Finds the maximum value in the array
+ *
+ * MSP432 compares 4 bytes at a time (USUB8 sets the GE flags, SEL keeps
+ * the larger bytes); HOST uses PMAXUB on SSE2/AVX2 vectors.
+ *
  * @param data Pointer to the data array
  * @param size Size of the array
  * @return Maximum value
@@ -68,18 +233,235 @@ unsigned char find_maximum(unsigned char *data, unsigned int size);
 
 /**
  * @brief Finds the minimum value in the array
+ *
+ * Same scheme as find_maximum (USUB8/SEL on MSP432, PMINUB on HOST).
+ *
  * @param data Pointer to the data array
  * @param size Size of the array
  * @return Minimum value
  */
 unsigned char find_minimum(unsigned char *data, unsigned int size);
 
+/**
+ * @brief Sums the squares of the array
+ *
+ * Uses UXTB16 + SMLAD on MSP432 (two squares per MAC) and PMADDWD on HOST.
+ *
+ * @param data Pointer to the data array
+ * @param size Size of the array
+ * @return Sum of data[i]^2
+ */
+uint64_t find_sum_squares(unsigned char *data, unsigned int size);
+
+/**
+ * @brief Integer square root, floor(sqrt(value))
+ *
+ * Digit-by-digit, one result bit per step from the highest set bit on, in
+ * 32-bit arithmetic when value fits. No floating point and no libm.
+ *
+ * @param value Radicand
+ * @return Largest r with r * r <= value
+ */
+uint32_t isqrt(uint64_t value);
+
+/**
+ * @brief Finds the population variance of the array, rounded down
+ *
+ * Exact: computed from find_sum and find_sum_squares in 64-bit integer
+ * arithmetic, with no floating point.
+ *
+ * @param data Pointer to the data array
+ * @param size Size of the array
+ * @return Variance (0 for an empty array)
+ */
+uint32_t find_variance(unsigned char *data, unsigned int size);
+
+/**
+ * @brief Population variance in Q24.8 fixed point: floor(variance * 256)
+ * @param data Pointer to the data array
+ * @param size Size of the array
+ * @return Variance times 256, rounded down
+ */
+uint32_t find_variance_q8(unsigned char *data, unsigned int size);
+
+/**
+ * @brief Population standard deviation, rounded down
+ * @param data Pointer to the data array
+ * @param size Size of the array
+ * @return floor(sqrt(variance))
+ */
+uint32_t find_stddev(unsigned char *data, unsigned int size);
+
+/**
+ * @brief Population standard deviation in Q8.8 fixed point:
+ *        floor(stddev * 256)
+ * @param data Pointer to the data array
+ * @param size Size of the array
+ * @return Standard deviation times 256, rounded down
+ */
+uint32_t find_stddev_q8(unsigned char *data, unsigned int size);
+
 /**
  * @brief Sorts the array from largest to smallest
+ *
+ * Sizes with a sorting network (8, 16, 32, 40) use sort_array_network
+ * unless SORT_NETWORKS is 0. Otherwise uses insertion sort up to
+ * SORT_INSERTION_MAX elements, introsort below SORT_COUNTING_MIN elements
+ * and a 256-bucket counting sort, O(n + 256), above that. On HOST, from
+ * SORT_PARALLEL_MIN elements the counts and the output are split over
+ * the tpool threads.
+ *
  * @param data Pointer to the data array
  * @param size Size of the array
  */
 void sort_array(unsigned char *data, unsigned int size);
 
+/**
+ * @brief Insertion sort, largest to smallest (best for tiny arrays)
+ * @param data Pointer to the data array
+ * @param size Size of the array
+ */
+void sort_array_insertion(unsigned char *data, unsigned int size);
+
+/**
+ * @brief Introsort, largest to smallest: median-of-three quicksort with a
+ *        heapsort fallback past 2*log2(size) levels, insertion sort for
+ *        short partitions
+ * @param data Pointer to the data array
+ * @param size Size of the array
+ */
+void sort_array_intro(unsigned char *data, unsigned int size);
+
+/**
+ * @brief Sorting network, largest to smallest, for 8, 16, 32 or 40 elements
+ *
+ * Runs the fixed comparator sequence from sort_network.h on 32-bit
+ * locals, each compare-exchange done with a subtract and masks instead of
+ * a branch, so the run time does not depend on the data. sort_array uses
+ * it whenever the size matches (see SORT_NETWORKS).
+ *
+ * @param data Pointer to the data array
+ * @param size Size of the array
+ * @return 0 when sorted, -1 (array untouched) for a size without a network
+ */
+int8_t sort_array_network(unsigned char *data, unsigned int size);
+
+/**
+ * @brief Counting sort, largest to smallest, O(size + 256)
+ * @param data Pointer to the data array
+ * @param size Size of the array
+ */
+void sort_array_counting(unsigned char *data, unsigned int size);
+
+/**
+ * @brief Copies the k largest values, largest first, without sorting
+ *
+ * out receives what sort_array would leave in data[0 .. k - 1]; data is
+ * not modified. Small k (see TOPK_HEAP_MAX) keeps the values in a bounded
+ * min-heap, O(size log k); blocks with nothing above the heap's root are
+ * skipped 16 bytes at a time on HOST, and the scan stops once the root is
+ * 255. Larger k reads them off a 256-bin histogram in O(size + 256).
+ *
+ * @param data Pointer to the data array
+ * @param size Size of the array
+ * @param k Number of values wanted
+ * @param out Receives min(k, size) values
+ * @return Number of values written, min(k, size)
+ */
+unsigned int find_top_k(unsigned char *data, unsigned int size,
+                        unsigned int k, unsigned char *out);
+
+/**
+ * @brief Sorts only the k largest values to the front, largest first
+ *
+ * Afterwards data[0 .. k - 1] equals the first k entries of sort_array and
+ * the rest of the array holds the remaining values in no particular
+ * order. The k largest values come from the find_top_k heap (for k up to
+ * 256) or a histogram, one pass swaps them to the front, and the front is
+ * overwritten in order: O(size log k) or O(size + 256).
+ *
+ * @param data Pointer to the data array
+ * @param size Size of the array
+ * @param k Number of values to put in order (clamped to size)
+ */
+void sort_array_partial(unsigned char *data, unsigned int size,
+                        unsigned int k);
+
+/**
+ * @brief Incremental statistics over an endless sample stream
+ *
+ * Running count, min, max, mean and variance cover every sample pushed
+ * since stats_stream_init (sums are exact up to 2^47 samples). With a
+ * window buffer, the median covers only the last window_size samples: a
+ * ring buffer holds them and a Fenwick tree over the 256 byte values
+ * keeps their ranks, so a push and a median query cost O(log 256) each,
+ * independent of the window size.
+ */
+typedef struct {
+  uint64_t count;
+  uint64_t sum;
+  uint64_t sum_sq;
+  unsigned char minimum;
+  unsigned char maximum;
+  uint8_t *window;            /* Ring buffer of the last samples, or NULL */
+  uint32_t window_size;
+  uint32_t window_fill;
+  uint32_t window_head;       /* Slot the next sample goes to */
+  uint32_t tree[256];         /* Fenwick tree of window counts per value */
+} stats_stream_t;
+
+/**
+ * @brief Starts an empty stream
+ * @param stream Accumulator to initialise
+ * @param window Buffer of window_size bytes for the median window, or NULL
+ * @param window_size Number of samples the median covers (0: no window)
+ */
+void stats_stream_init(stats_stream_t *stream, uint8_t *window,
+                       unsigned int window_size);
+
+/**
+ * @brief Adds one sample (the oldest one leaves a full window)
+ * @param stream Accumulator
+ * @param sample New sample
+ */
+void stats_stream_push(stats_stream_t *stream, unsigned char sample);
+
+/**
+ * @brief Adds a block of samples in order
+ * @param stream Accumulator
+ * @param data Pointer to the samples
+ * @param size Number of samples
+ */
+void stats_stream_push_block(stats_stream_t *stream, unsigned char *data,
+                             unsigned int size);
+
+/**
+ * @brief Smallest sample so far (0 before the first push)
+ */
+unsigned char stats_stream_min(const stats_stream_t *stream);
+
+/**
+ * @brief Largest sample so far (0 before the first push)
+ */
+unsigned char stats_stream_max(const stats_stream_t *stream);
+
+/**
+ * @brief Mean of all samples so far, rounded down
+ */
+unsigned char stats_stream_mean(const stats_stream_t *stream);
+
+/**
+ * @brief Population variance of all samples so far, rounded down
+ */
+uint32_t stats_stream_variance(const stats_stream_t *stream);
+
+/**
+ * @brief Median of the samples in the window
+ *
+ * Same value find_median would return for the window contents; 0 when
+ * there is no window or it is empty.
+ */
+unsigned char stats_stream_median(const stats_stream_t *stream);
+
 #endif /* __STATS_H__ */
 
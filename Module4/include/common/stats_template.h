@@ -0,0 +1,395 @@
+/*****************************************************************************
+ * @file stats_template.h
+ * @brief Type-generic body of the stats_typed.h functions
+ *
+ * Included by stats_typed.c once per sample type, with these defined:
+ *
+ *   STATS_SFX               name suffix (u16, i16, ...)
+ *   STATS_T                 sample type
+ *   STATS_SUM_T             overflow-free sum type
+ *   STATS_MEAN(sum, size)   mean of size samples, rounded down
+ *   STATS_PRINT_FMT         PRINTF conversion for one sample
+ *   STATS_PRINT_T           type a sample is converted to for PRINTF
+ *
+ * and these kernels, which each handle a prefix of the array and return
+ * how many samples they consumed (0 when there is no fast path):
+ *
+ *   unsigned int sum_kernel_<sfx>(const T *data, unsigned int size,
+ *                                 STATS_SUM_T *sum);
+ *   unsigned int max_kernel_<sfx>(const T *data, unsigned int size,
+ *                                 T *best);
+ *   unsigned int min_kernel_<sfx>(const T *data, unsigned int size,
+ *                                 T *best);
+ *
+ * The parameters are undefined again at the end of this file.
+ *
+ * This code was written as part of the Introduction to Embedded Systems
+ * Software and Development Environments course (University of Colorado Boulder).
+ *
+ * @author Timofei Alekseenko
+ * @date October 17, 2026
+ *
+ *****************************************************************************/
+
+/* No include guard: meant to be included several times */
+
+#define STATS_CAT_(a, b) a##b
+#define STATS_CAT(a, b)  STATS_CAT_(a, b)
+#define STATS_FN(name)   STATS_CAT(name, STATS_SFX)
+
+STATS_SUM_T STATS_FN(find_sum_)(const STATS_T *data, unsigned int size) {
+  STATS_SUM_T sum = 0;
+  unsigned int i = STATS_FN(sum_kernel_)(data, size, &sum);
+
+  for (; i < size; i++) sum += data[i];
+  return sum;
+}
+
+STATS_T STATS_FN(find_mean_)(const STATS_T *data, unsigned int size) {
+  if (size == 0) return 0;
+  return STATS_MEAN(STATS_FN(find_sum_)(data, size), size);
+}
+
+STATS_T STATS_FN(find_maximum_)(const STATS_T *data, unsigned int size) {
+  STATS_T best;
+  unsigned int i;
+
+  if (size == 0) return 0;
+  best = data[0];
+  i = STATS_FN(max_kernel_)(data, size, &best);
+  for (; i < size; i++)
+    if (data[i] > best) best = data[i];
+  return best;
+}
+
+STATS_T STATS_FN(find_minimum_)(const STATS_T *data, unsigned int size) {
+  STATS_T best;
+  unsigned int i;
+
+  if (size == 0) return 0;
+  best = data[0];
+  i = STATS_FN(min_kernel_)(data, size, &best);
+  for (; i < size; i++)
+    if (data[i] < best) best = data[i];
+  return best;
+}
+
+static void STATS_FN(insertion_sort_)(STATS_T *data, unsigned int size) {
+  for (unsigned int i = 1; i < size; i++) {
+    STATS_T value = data[i];
+    unsigned int j = i;
+    while (j > 0 && data[j - 1] < value) {
+      data[j] = data[j - 1];
+      j--;
+    }
+    data[j] = value;
+  }
+}
+
+/* Min-heap sift: leaves the smallest value at the root */
+static void STATS_FN(sift_down_min_)(STATS_T *data, unsigned int root,
+                                     unsigned int size) {
+  STATS_T value = data[root];
+
+  for (;;) {
+    unsigned int child = 2 * root + 1;
+    if (child >= size) break;
+    if (child + 1 < size && data[child + 1] < data[child]) child++;
+    if (!(data[child] < value)) break;
+    data[root] = data[child];
+    root = child;
+  }
+  data[root] = value;
+}
+
+/* Heapsort fallback: repeatedly move the minimum to the end */
+static void STATS_FN(heap_sort_desc_)(STATS_T *data, unsigned int size) {
+  for (unsigned int i = size / 2; i > 0; i--) {
+    STATS_FN(sift_down_min_)(data, i - 1, size);
+  }
+  for (unsigned int end = size - 1; end > 0; end--) {
+    STATS_T temp = data[0];
+    data[0] = data[end];
+    data[end] = temp;
+    STATS_FN(sift_down_min_)(data, 0, end);
+  }
+}
+
+/**
+ * @brief Median-of-three Hoare partition, descending
+ * @return j such that [0, j] >= pivot >= [j + 1, size)
+ */
+static unsigned int STATS_FN(partition_desc_)(STATS_T *data,
+                                              unsigned int size) {
+  unsigned int mid = (size - 1) / 2;
+  unsigned int i = 0, j = size - 1;
+  STATS_T pivot, temp;
+
+  /* Order the three so the ends act as sentinels */
+  if (data[mid] > data[0]) {
+    temp = data[mid]; data[mid] = data[0]; data[0] = temp;
+  }
+  if (data[size - 1] > data[0]) {
+    temp = data[size - 1]; data[size - 1] = data[0]; data[0] = temp;
+  }
+  if (data[size - 1] > data[mid]) {
+    temp = data[size - 1]; data[size - 1] = data[mid]; data[mid] = temp;
+  }
+  pivot = data[mid];
+
+  for (;;) {
+    while (data[i] > pivot) i++;
+    while (data[j] < pivot) j--;
+    if (i >= j) return j;
+    temp = data[i]; data[i] = data[j]; data[j] = temp;
+    i++;
+    j--;
+  }
+}
+
+static void STATS_FN(intro_sort_)(STATS_T *data, unsigned int size,
+                                  unsigned int depth) {
+  while (size > SORT_INSERTION_MAX) {
+    unsigned int j;
+
+    if (depth == 0) {
+      STATS_FN(heap_sort_desc_)(data, size);
+      return;
+    }
+    depth--;
+    j = STATS_FN(partition_desc_)(data, size);
+
+    /* Recurse into the smaller half, loop on the larger */
+    if (j + 1 < size - j - 1) {
+      STATS_FN(intro_sort_)(data, j + 1, depth);
+      data += j + 1;
+      size -= j + 1;
+    } else {
+      STATS_FN(intro_sort_)(data + j + 1, size - j - 1, depth);
+      size = j + 1;
+    }
+  }
+  STATS_FN(insertion_sort_)(data, size);
+}
+
+static void STATS_FN(sort_serial_)(STATS_T *data, unsigned int size) {
+  unsigned int depth = 0;
+
+  for (unsigned int n = size; n > 1; n >>= 1) depth += 2;
+  STATS_FN(intro_sort_)(data, size, depth);
+}
+
+#if defined (HOST)
+/*
+ * Parallel sample sort: S splitters cut the values into 2S + 1 buckets,
+ * in output order: above splitter 0, equal to splitter 0, between
+ * splitters 0 and 1, equal to splitter 1, ... Equal buckets need no sort,
+ * so heavy duplicates do not pile up in one bucket.
+ */
+#define STATS_SAMPLE_MAX (127)
+
+typedef struct {
+  STATS_T *data;
+  STATS_T *scratch;
+  uint8_t *oracle;                    /* Bucket of every element */
+  unsigned int size;
+  unsigned int chunks;
+  unsigned int splitters;
+  STATS_T splitter[STATS_SAMPLE_MAX]; /* Descending */
+  uint32_t (*counts)[256];            /* Per chunk: counts, then offsets */
+  uint32_t start[256];                /* Buckets in scratch */
+  uint32_t length[256];
+} STATS_FN(sample_job_);
+
+static void STATS_FN(sample_count_)(void *arg, uint32_t index) {
+  STATS_FN(sample_job_) *job = (STATS_FN(sample_job_) *)arg;
+  uint32_t *counts = job->counts[index];
+  unsigned int begin = (unsigned int)((uint64_t)job->size * index /
+                                      job->chunks);
+  unsigned int end = (unsigned int)((uint64_t)job->size * (index + 1) /
+                                    job->chunks);
+
+  my_memzero((uint8_t *)counts, 256 * sizeof(uint32_t));
+  for (unsigned int i = begin; i < end; i++) {
+    STATS_T value = job->data[i];
+    unsigned int lo = 0, n = job->splitters;
+    unsigned int bucket;
+
+    /* lo = number of splitters above value */
+    while (n > 0) {
+      unsigned int half = n / 2;
+      if (job->splitter[lo + half] > value) {
+        lo += half + 1;
+        n -= half + 1;
+      } else {
+        n = half;
+      }
+    }
+    bucket = 2 * lo + (lo < job->splitters && !(value > job->splitter[lo]));
+    job->oracle[i] = (uint8_t)bucket;
+    counts[bucket]++;
+  }
+}
+
+/* Chunks scatter in order, so each bucket keeps the input order */
+static void STATS_FN(sample_scatter_)(void *arg, uint32_t index) {
+  STATS_FN(sample_job_) *job = (STATS_FN(sample_job_) *)arg;
+  uint32_t *offsets = job->counts[index];
+  unsigned int begin = (unsigned int)((uint64_t)job->size * index /
+                                      job->chunks);
+  unsigned int end = (unsigned int)((uint64_t)job->size * (index + 1) /
+                                    job->chunks);
+
+  for (unsigned int i = begin; i < end; i++) {
+    job->scratch[offsets[job->oracle[i]]++] = job->data[i];
+  }
+}
+
+/* Sort one bucket in scratch and copy it back to its place in data */
+static void STATS_FN(sample_bucket_)(void *arg, uint32_t index) {
+  STATS_FN(sample_job_) *job = (STATS_FN(sample_job_) *)arg;
+  STATS_T *bucket = job->scratch + job->start[index];
+
+  if ((index & 1) == 0) {
+    STATS_FN(sort_serial_)(bucket, job->length[index]);
+  }
+  my_memcopy((uint8_t *)bucket, (uint8_t *)(job->data + job->start[index]),
+             job->length[index] * sizeof(STATS_T));
+}
+
+/* Returns -1 (data untouched) without threads or memory */
+static int8_t STATS_FN(sample_sort_)(STATS_T *data, unsigned int size) {
+  STATS_FN(sample_job_) *job;
+  uint32_t threads = tpool_threads();
+  unsigned int splitters = threads * SORT_SAMPLE_BUCKETS - 1;
+  unsigned int samples, pos = 0;
+
+  if (splitters > STATS_SAMPLE_MAX) splitters = STATS_SAMPLE_MAX;
+  samples = (splitters + 1) * SORT_SAMPLE_OVERSAMPLE;
+  if (threads < 2 || size < samples) return -1;
+
+  job = (STATS_FN(sample_job_) *)malloc(sizeof(*job));
+  if (job == NULL) return -1;
+  job->chunks = 2 * threads;
+  job->scratch = (STATS_T *)malloc(size * sizeof(STATS_T));
+  job->oracle = (uint8_t *)malloc(size);
+  job->counts = (uint32_t (*)[256])malloc(job->chunks *
+                                          sizeof(job->counts[0]));
+  if (job->scratch == NULL || job->oracle == NULL || job->counts == NULL) {
+    free(job->scratch);
+    free(job->oracle);
+    free(job->counts);
+    free(job);
+    return -1;
+  }
+  job->data = data;
+  job->size = size;
+  job->splitters = splitters;
+
+  /* Splitters: every OVERSAMPLE-th of an evenly spaced, sorted sample */
+  for (unsigned int i = 0; i < samples; i++) {
+    job->scratch[i] = data[(uint64_t)(2 * i + 1) * size / (2 * samples)];
+  }
+  STATS_FN(sort_serial_)(job->scratch, samples);
+  for (unsigned int j = 0; j < splitters; j++) {
+    job->splitter[j] = job->scratch[(j + 1) * SORT_SAMPLE_OVERSAMPLE];
+  }
+
+  tpool_run(STATS_FN(sample_count_), job, job->chunks);
+  for (unsigned int b = 0; b < 2 * splitters + 1; b++) {
+    job->start[b] = pos;
+    for (unsigned int c = 0; c < job->chunks; c++) {
+      uint32_t count = job->counts[c][b];
+      job->counts[c][b] = pos;
+      pos += count;
+    }
+    job->length[b] = pos - job->start[b];
+  }
+  tpool_run(STATS_FN(sample_scatter_), job, job->chunks);
+  tpool_run(STATS_FN(sample_bucket_), job, 2 * splitters + 1);
+
+  free(job->scratch);
+  free(job->oracle);
+  free(job->counts);
+  free(job);
+  return 0;
+}
+
+#undef STATS_SAMPLE_MAX
+#endif
+
+void STATS_FN(sort_array_)(STATS_T *data, unsigned int size) {
+#if defined (HOST)
+  if (size >= SORT_PARALLEL_MIN && STATS_FN(sample_sort_)(data, size) == 0) {
+    return;
+  }
+#endif
+  STATS_FN(sort_serial_)(data, size);
+}
+
+STATS_T STATS_FN(find_kth_)(const STATS_T *data, unsigned int size,
+                            unsigned int k, STATS_T *scratch) {
+  unsigned int lo = 0, hi, depth = 0;
+
+  if (size == 0) return 0;
+  if (k >= size) k = size - 1;
+  if (scratch != data) {
+    my_memcopy((uint8_t *)data, (uint8_t *)scratch, size * sizeof(STATS_T));
+  }
+  for (unsigned int n = size; n > 1; n >>= 1) depth += 2;
+
+  /* Quickselect on [lo, hi], narrowing towards index k */
+  hi = size - 1;
+  while (hi - lo > SORT_INSERTION_MAX) {
+    unsigned int j;
+
+    if (depth-- == 0) {
+      STATS_FN(heap_sort_desc_)(scratch + lo, hi - lo + 1);
+      return scratch[k];
+    }
+    j = lo + STATS_FN(partition_desc_)(scratch + lo, hi - lo + 1);
+    if (k <= j) hi = j; else lo = j + 1;
+  }
+  STATS_FN(insertion_sort_)(scratch + lo, hi - lo + 1);
+  return scratch[k];
+}
+
+STATS_T STATS_FN(find_median_)(const STATS_T *data, unsigned int size,
+                               STATS_T *scratch) {
+  return STATS_FN(find_kth_)(data, size, size / 2, scratch);
+}
+
+/* Nearest rank: the ceil(pct * size / 100)-th smallest value */
+STATS_T STATS_FN(find_percentile_)(const STATS_T *data, unsigned int size,
+                                   unsigned int pct, STATS_T *scratch) {
+  unsigned int rank;
+
+  if (size == 0) return 0;
+  if (pct > 100) pct = 100;
+  rank = (unsigned int)(((uint64_t)pct * size + 99) / 100);
+  if (rank == 0) rank = 1;
+  return STATS_FN(find_kth_)(data, size, size - rank, scratch);
+}
+
+void STATS_FN(print_statistics_)(const STATS_T *data, unsigned int size,
+                                 STATS_T *scratch) {
+  PRINTF("\nStatistics:\n");
+  PRINTF("Maximum: " STATS_PRINT_FMT "\n",
+         (STATS_PRINT_T)STATS_FN(find_maximum_)(data, size));
+  PRINTF("Minimum: " STATS_PRINT_FMT "\n",
+         (STATS_PRINT_T)STATS_FN(find_minimum_)(data, size));
+  PRINTF("Mean: " STATS_PRINT_FMT "\n",
+         (STATS_PRINT_T)STATS_FN(find_mean_)(data, size));
+  PRINTF("Median: " STATS_PRINT_FMT "\n",
+         (STATS_PRINT_T)STATS_FN(find_median_)(data, size, scratch));
+}
+
+#undef STATS_FN
+#undef STATS_CAT
+#undef STATS_CAT_
+#undef STATS_SFX
+#undef STATS_T
+#undef STATS_SUM_T
+#undef STATS_MEAN
+#undef STATS_PRINT_FMT
+#undef STATS_PRINT_T
@@ -0,0 +1,83 @@
+/*****************************************************************************
+ * @file stats_typed.h
+ * @brief Statistics and sorting for 16-bit, 32-bit and float samples
+ *
+ * The unsigned char API in stats.h is repeated here for each sample type,
+ * with the suffix naming the type:
+ *
+ *   u16  uint16_t  (ADC14 results)      sums in uint64_t
+ *   i16  int16_t                        sums in int64_t
+ *   i32  int32_t                        sums in int64_t
+ *   f32  float     (no NaNs)            sums in double
+ *
+ * All functions come from one template (stats_template.h, expanded in
+ * stats_typed.c); each type plugs in its own min/max/sum kernels: DSP
+ * instructions on MSP432 (USUB16/SSUB16 + SEL, SMLALD dual MACs) and SSE2
+ * on HOST. Sums never overflow, and means are rounded down (towards minus
+ * infinity).
+ *
+ * Like stats.h, sorting is descending and the k-th element counts from 0 in
+ * descending order. Selection never reorders data: it works on a scratch
+ * copy of size elements (scratch == data selects in place).
+ *
+ * This code was written as part of the Introduction to Embedded Systems
+ * Software and Development Environments course (University of Colorado Boulder).
+ *
+ * @author Timofei Alekseenko
+ * @date October 17, 2026
+ *
+ *****************************************************************************/
+
+#ifndef __STATS_TYPED_H__
+#define __STATS_TYPED_H__
+
+#include <stdint.h>
+
+/**
+ * @brief Declares the statistics API for one sample type
+ *
+ *  SUM_T find_sum_<sfx>(const T *data, unsigned int size);
+ *      Sum of all samples.
+ *  T find_mean_<sfx>(const T *data, unsigned int size);
+ *      Mean, rounded down (0 for an empty array).
+ *  T find_maximum_<sfx>(const T *data, unsigned int size);
+ *  T find_minimum_<sfx>(const T *data, unsigned int size);
+ *      Largest / smallest sample (0 for an empty array).
+ *  void sort_array_<sfx>(T *data, unsigned int size);
+ *      Descending sort: insertion sort up to SORT_INSERTION_MAX elements,
+ *      introsort above. On HOST, from SORT_PARALLEL_MIN elements a sample
+ *      sort on the tpool threads: the array is split into buckets on
+ *      sampled splitters and the buckets are introsorted in parallel
+ *      (same values in the same order; f32 -0.0 and 0.0 compare equal
+ *      and may swap places).
+ *  T find_kth_<sfx>(const T *data, unsigned int size, unsigned int k,
+ *                   T *scratch);
+ *      k-th largest sample by introselect, O(size) on average.
+ *  T find_median_<sfx>(const T *data, unsigned int size, T *scratch);
+ *      Same as find_kth_<sfx>(data, size, size / 2, scratch).
+ *  T find_percentile_<sfx>(const T *data, unsigned int size,
+ *                          unsigned int pct, T *scratch);
+ *      Nearest-rank percentile, 0 to 100.
+ *  void print_statistics_<sfx>(const T *data, unsigned int size,
+ *                              T *scratch);
+ *      Prints max, min, mean and median like print_statistics.
+ */
+#define STATS_TYPED_DECLARE(sfx, T, SUM_T)                                   \
+  SUM_T find_sum_##sfx(const T *data, unsigned int size);                    \
+  T find_mean_##sfx(const T *data, unsigned int size);                       \
+  T find_maximum_##sfx(const T *data, unsigned int size);                    \
+  T find_minimum_##sfx(const T *data, unsigned int size);                    \
+  void sort_array_##sfx(T *data, unsigned int size);                         \
+  T find_kth_##sfx(const T *data, unsigned int size, unsigned int k,         \
+                   T *scratch);                                              \
+  T find_median_##sfx(const T *data, unsigned int size, T *scratch);         \
+  T find_percentile_##sfx(const T *data, unsigned int size,                  \
+                          unsigned int pct, T *scratch);                     \
+  void print_statistics_##sfx(const T *data, unsigned int size, T *scratch);
+
+STATS_TYPED_DECLARE(u16, uint16_t, uint64_t)
+STATS_TYPED_DECLARE(i16, int16_t, int64_t)
+STATS_TYPED_DECLARE(i32, int32_t, int64_t)
+STATS_TYPED_DECLARE(f32, float, double)
+
+#endif /* __STATS_TYPED_H__ */
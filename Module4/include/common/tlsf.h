@@ -0,0 +1,96 @@
+/*****************************************************************************
+ * @file tlsf.h
+ * @brief Two-Level Segregated Fit allocator for bounded-latency allocation
+ *
+ * Manages the heap region between __heap_start__ and __HeapLimit from
+ * msp432p401r.lds (a static array on HOST). Free blocks are binned by a
+ * first level (power of two) and a second level (TLSF_SL_COUNT linear
+ * subranges); two bitmaps find a fitting bin with CLZ/CTZ, so allocation
+ * and free are O(1) with immediate coalescing of neighbours.
+ *
+ * This code was written as part of the Introduction to Embedded Systems
+ * Software and Development Environments course (University of Colorado Boulder).
+ *
+ * @author Timofei Alekseenko
+ * @date October 17, 2026
+ *
+ *****************************************************************************/
+
+#ifndef __TLSF_H__
+#define __TLSF_H__
+
+#include <stdint.h>
+#include <stddef.h>
+
+/* Size of the HOST stand-in for the linker heap region */
+#ifndef TLSF_HOST_HEAP_BYTES
+#define TLSF_HOST_HEAP_BYTES (64UL << 10)
+#endif
+
+/**
+ * @brief Allocator counters
+ */
+typedef struct {
+  uint32_t total_bytes;        /* Bytes managed (payload of the first block) */
+  uint32_t free_bytes;         /* Payload bytes currently free */
+  uint32_t used_bytes;         /* Payload bytes currently allocated */
+  uint32_t high_water;         /* Most payload bytes ever allocated at once */
+  uint32_t largest_free;       /* Largest single free block */
+  uint32_t free_blocks;        /* Number of free blocks */
+  uint32_t fragmentation_pct;  /* 100 * (1 - largest_free / free_bytes) */
+  uint32_t failures;           /* Requests that could not be served */
+} tlsf_stats_t;
+
+/**
+ * @brief Hand a memory region to the allocator (drops any previous state)
+ * @param mem   Start of the region
+ * @param bytes Size of the region in bytes
+ * @return 0 on success, -1 if the region is too small
+ */
+int8_t tlsf_init(void * mem, size_t bytes);
+
+/**
+ * @brief Allocate size bytes (8-byte aligned) from the TLSF heap
+ *
+ * Initializes the allocator over the default heap region on first use.
+ *
+ * @param size Number of bytes
+ * @return Pointer to the allocation, or NULL if no free block fits
+ */
+void * tlsf_alloc(size_t size);
+
+/**
+ * @brief Return an allocation to the TLSF heap, merging free neighbours
+ * @param ptr Pointer returned by tlsf_alloc (NULL is ignored)
+ */
+void tlsf_free(void * ptr);
+
+/**
+ * @brief Allocate length 32-bit words (TLSF counterpart of reserve_words)
+ * @param length Number of 32-bit words
+ * @return Pointer to the words, or NULL if no free block fits
+ */
+int32_t * tlsf_reserve_words(size_t length);
+
+/**
+ * @brief Free words from tlsf_reserve_words (TLSF counterpart of free_words)
+ * @param src Pointer returned by tlsf_reserve_words
+ */
+void tlsf_free_words(int32_t * src);
+
+/**
+ * @brief Collect allocator counters, fragmentation and largest free block
+ *
+ * Not O(1): walks the fullest bin to find the exact largest block. Keep it
+ * out of the control loop.
+ *
+ * @param stats Destination for the counters
+ */
+void tlsf_get_stats(tlsf_stats_t * stats);
+
+/**
+ * @brief Prints the allocator counters (when VERBOSE is enabled)
+ */
+void print_tlsf_stats(void);
+
+#endif /* __TLSF_H__ */
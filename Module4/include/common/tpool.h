@@ -0,0 +1,71 @@
+/*****************************************************************************
+ * @file tpool.h
+ * @brief Fixed worker thread pool running parallel-for jobs (HOST)
+ *
+ * tpool_run(task, arg, count) calls task(arg, i) once for every i below
+ * count, spread over the pool's worker threads and the calling thread, and
+ * returns when all calls have finished. Workers take the next index from a
+ * shared atomic counter, so uneven tasks balance themselves; splitting a
+ * job into a few more tasks than threads helps that.
+ *
+ * The pool starts on first use with one thread per online CPU (the caller
+ * counts as one), or explicitly with tpool_init. Jobs from several threads
+ * run one after another; a tpool_run issued from inside a task runs
+ * serially on that thread.
+ *
+ * HOST only (POSIX threads).
+ *
+ * This code was written as part of the Introduction to Embedded Systems
+ * Software and Development Environments course (University of Colorado Boulder).
+ *
+ * @author Timofei Alekseenko
+ * @date October 17, 2026
+ *
+ *****************************************************************************/
+
+#ifndef __TPOOL_H__
+#define __TPOOL_H__
+
+#include <stdint.h>
+
+/* Upper bound on threads, caller included (override with -D) */
+#ifndef TPOOL_MAX_THREADS
+#define TPOOL_MAX_THREADS (64)
+#endif
+
+/**
+ * @brief One call of a parallel-for job
+ * @param arg Job argument given to tpool_run
+ * @param index Task index, 0 to count - 1
+ */
+typedef void (*tpool_task_t)(void * arg, uint32_t index);
+
+/**
+ * @brief Start the pool, replacing a running one
+ * @param threads Threads including the caller, 0 for one per online CPU;
+ *                clamped to TPOOL_MAX_THREADS. 1 runs every job serially.
+ * @return 0 on success, -1 if no worker could be started (the pool then
+ *         runs jobs serially)
+ */
+int8_t tpool_init(uint32_t threads);
+
+/**
+ * @brief Threads a job is spread over, caller included (starts the pool);
+ *        1 when called from inside a task, where nested jobs run serially
+ */
+uint32_t tpool_threads(void);
+
+/**
+ * @brief Run task(arg, i) for i = 0 .. count - 1 and wait for all of them
+ * @param task Function to call
+ * @param arg Passed to every call
+ * @param count Number of calls
+ */
+void tpool_run(tpool_task_t task, void * arg, uint32_t count);
+
+/**
+ * @brief Stop and join the workers; the next use starts the pool again
+ */
+void tpool_shutdown(void);
+
+#endif /* __TPOOL_H__ */
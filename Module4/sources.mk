@@ -31,9 +31,20 @@ ifeq ($(PLATFORM),HOST)
   SOURCES = \
     src/main.c \
     src/memory.c \
+    src/pool.c \
+    src/arena.c \
+    src/tlsf.c \
     src/stats.c \
+    src/stats_typed.c \
+    src/radix.c \
     src/data.c \
-    src/course1.c
+    src/course1.c \
+    src/bench.c \
+    src/mtpool.c \
+    src/tpool.c \
+    src/capture.c \
+    src/dma.c \
+    src/extsort.c
 
   # Include path for HOST
   INCLUDES = \
@@ -45,9 +56,16 @@ else ifeq ($(PLATFORM),MSP432)
   SOURCES = \
     src/main.c \
     src/memory.c \
+    src/pool.c \
+    src/arena.c \
+    src/tlsf.c \
     src/stats.c \
+    src/stats_typed.c \
+    src/radix.c \
     src/data.c \
     src/course1.c \
+    src/bench.c \
+    src/dma.c \
     src/system_msp432p401r.c \
     src/startup_msp432p401r_gcc.c \
     src/interrupts_msp432p401r_gcc.c
@@ -0,0 +1,65 @@
+/*****************************************************************************
+ * @file arena.c
+ * @brief Implementation of the scoped bump (arena) allocator
+ *
+ * Allocation rounds the current address up to the requested alignment and
+ * bumps the offset; reset just stores an earlier offset back. Both are O(1)
+ * and need no per-allocation header.
+ *
+ * This code was written as part of the Introduction to Embedded Systems
+ * Software and Development Environments course (University of Colorado Boulder).
+ *
+ * @author Timofei Alekseenko
+ * @date October 17, 2026
+ *
+ *****************************************************************************/
+
+#include "arena.h"
+#include <stdint.h>
+#include <stddef.h>
+
+void arena_init(arena_t * arena, void * buffer, size_t size) {
+  arena->base = (uint8_t *)buffer;
+  arena->size = size;
+  arena->used = 0;
+  arena->high_water = 0;
+}
+
+void * arena_alloc(arena_t * arena, size_t size, size_t align) {
+  uintptr_t start;
+  size_t offset;
+
+  if (align == 0) {
+    align = ARENA_DEFAULT_ALIGN;
+  }
+
+  /* Align the absolute address, not the offset, so any buffer works */
+  start = ((uintptr_t)(arena->base + arena->used) + (align - 1)) &
+          ~(uintptr_t)(align - 1);
+  offset = (size_t)(start - (uintptr_t)arena->base);
+
+  if (offset > arena->size || size > arena->size - offset) {
+    return NULL;
+  }
+
+  arena->used = offset + size;
+  if (arena->used > arena->high_water) {
+    arena->high_water = arena->used;
+  }
+  return arena->base + offset;
+}
+
+int32_t * arena_reserve_words(arena_t * arena, size_t length) {
+  return (int32_t *)arena_alloc(arena, length * sizeof(int32_t),
+                                sizeof(int32_t));
+}
+
+arena_mark_t arena_mark(const arena_t * arena) {
+  return arena->used;
+}
+
+void arena_reset(arena_t * arena, arena_mark_t mark) {
+  if (mark <= arena->used) {
+    arena->used = mark;
+  }
+}
@@ -0,0 +1,1788 @@
+/*****************************************************************************
+ * @file bench.c
+ * @brief Micro-benchmarks for the memory and statistics kernels
+ *
+ * Every kernel is compared against the byte loop it replaced and, where one
+ * exists, against the C library routine (glibc on HOST, newlib on MSP432).
+ * On MSP432 PRINTF is compiled out; read the results with a debugger.
+ *
+ * This code was written as part of the Introduction to Embedded Systems
+ * Software and Development Environments course (University of Colorado Boulder).
+ *
+ * @author Timofei Alekseenko
+ * @date October 17, 2026
+ *
+ *****************************************************************************/
+
+#if defined (HOST)
+#define _POSIX_C_SOURCE 200809L   /* clock_gettime, pthreads */
+#endif
+
+#include "bench.h"
+#include "platform.h"
+#include "memory.h"
+#include "pool.h"
+#include "arena.h"
+#include "tlsf.h"
+#include "dma.h"
+#include "stats.h"
+#include "stats_typed.h"
+#include "radix.h"
+#include <stdint.h>
+#include <stddef.h>
+#include <stdlib.h>
+#include <string.h>
+
+#if defined (HOST)
+#include <time.h>
+#include <unistd.h>
+#include <pthread.h>
+#include "mtpool.h"
+#include "tpool.h"
+#include "capture.h"
+#include "extsort.h"
+#include <fcntl.h>
+#define BENCH_TICK_UNIT   "ns"
+#define BENCH_RATE_UNIT   "MB/s"
+#define BENCH_MAX_BYTES   (1UL << 20)
+#define BENCH_WORK_BYTES  (16UL << 20)   /* Bytes moved per measurement */
+#else
+#define BENCH_TICK_UNIT   "cyc"
+#define BENCH_RATE_UNIT   "B/kcyc"
+#define BENCH_MAX_BYTES   (4096UL)
+#define BENCH_WORK_BYTES  (64UL << 10)
+#endif
+
+/* Keeps results alive so the measured loops are not optimized out */
+volatile uint8_t bench_sink;
+
+/* Last reported result, readable from a debugger where PRINTF is empty */
+volatile uint32_t bench_last_ticks;
+volatile uint32_t bench_last_rate;
+
+/**
+ * @brief Reference kernel: the byte loop my_memcopy used to be
+ */
+static uint8_t * ref_memcopy_bytes(uint8_t * src, uint8_t * dst, size_t length) {
+  for (size_t i = 0; i < length; i++) {
+    *(dst + i) = *(src + i);
+  }
+  return dst;
+}
+
+/**
+ * @brief Reference kernel: the byte loop my_memmove used to be
+ */
+static uint8_t * ref_memmove_bytes(uint8_t * src, uint8_t * dst, size_t length) {
+  if (dst < src) {
+    for (size_t i = 0; i < length; i++) {
+      *(dst + i) = *(src + i);
+    }
+  } else if (dst > src) {
+    for (size_t i = length; i > 0; i--) {
+      *(dst + i - 1) = *(src + i - 1);
+    }
+  }
+  return dst;
+}
+
+/**
+ * @brief Reference kernel: the byte loop my_memset used to be
+ */
+static uint8_t * ref_memset_bytes(uint8_t * src, size_t length, uint8_t value) {
+  for (size_t i = 0; i < length; i++) {
+    *(src + i) = value;
+  }
+  return src;
+}
+
+/**
+ * @brief Reference kernel: the byte-pair loop my_reverse used to be
+ *        (length must be non-zero)
+ */
+static uint8_t * ref_reverse_bytes(uint8_t * src, size_t length) {
+  size_t start = 0, end = length - 1;
+  while (start < end) {
+    uint8_t tmp = *(src + start);
+    *(src + start) = *(src + end);
+    *(src + end)   = tmp;
+    start++;
+    end--;
+  }
+  return src;
+}
+
+/**
+ * @brief Reference kernel: the bubble sort sort_array used to be
+ *        (size must be non-zero)
+ */
+static void ref_bubble_sort(unsigned char * data, unsigned int size) {
+  for (unsigned int i = 0; i < size - 1; i++) {
+    for (unsigned int j = 0; j < size - i - 1; j++) {
+      if (data[j] < data[j + 1]) {
+        unsigned char temp = data[j];
+        data[j] = data[j + 1];
+        data[j + 1] = temp;
+      }
+    }
+  }
+}
+
+uint64_t bench_ticks(void) {
+#if defined (HOST)
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return (uint64_t)ts.tv_sec * 1000000000ULL + (uint64_t)ts.tv_nsec;
+#else
+  static uint8_t started = 0;
+  static uint32_t last = 0;
+  static uint64_t high = 0;     /* Wraps of the 32-bit CYCCNT seen so far */
+  uint32_t now;
+
+  if (!started) {
+    CoreDebug->DEMCR |= CoreDebug_DEMCR_TRCENA_Msk;
+    DWT->CYCCNT = 0;
+    DWT->CTRL |= DWT_CTRL_CYCCNTENA_Msk;
+    started = 1;
+  }
+  /* Extend to 64 bits so bench_ticks() - t0 stays right across a wrap */
+  now = DWT->CYCCNT;
+  if (now < last) {
+    high += 1ULL << 32;
+  }
+  last = now;
+  return high | now;
+#endif
+}
+
+void bench_report(const char * name, size_t bytes, uint32_t calls,
+                  uint64_t ticks) {
+  uint64_t rate = ticks ? ((uint64_t)bytes * calls * 1000ULL) / ticks : 0;
+
+  bench_last_ticks = (uint32_t)(ticks / (calls ? calls : 1));
+  bench_last_rate = (uint32_t)rate;
+  PRINTF("  %-26s %8lu B %12lu %s/call %10lu %s\n", name,
+         (unsigned long)bytes, (unsigned long)bench_last_ticks,
+         BENCH_TICK_UNIT, (unsigned long)bench_last_rate, BENCH_RATE_UNIT);
+}
+
+void bench_memcopy(void) {
+  static const size_t sizes[] = {16, 64, 256, 1024, 4096,
+#if defined (HOST)
+                                 65536, 1UL << 20
+#endif
+                                };
+  uint8_t * src = (uint8_t *) malloc(BENCH_MAX_BYTES);
+  uint8_t * dst = (uint8_t *) malloc(BENCH_MAX_BYTES);
+
+  PRINTF("\nbench_memcopy()\n");
+  if (!src || !dst) {
+    free(src);
+    free(dst);
+    return;
+  }
+  for (size_t i = 0; i < BENCH_MAX_BYTES; i++) {
+    src[i] = (uint8_t)i;
+  }
+
+  for (size_t n = 0; n < sizeof(sizes) / sizeof(sizes[0]); n++) {
+    size_t len = sizes[n];
+    uint32_t calls = (uint32_t)(BENCH_WORK_BYTES / len);
+    uint64_t t0;
+
+    t0 = bench_ticks();
+    for (uint32_t c = 0; c < calls; c++) ref_memcopy_bytes(src, dst, len);
+    bench_report("byte loop", len, calls, bench_ticks() - t0);
+
+    t0 = bench_ticks();
+    for (uint32_t c = 0; c < calls; c++) my_memcopy(src, dst, len);
+    bench_report("my_memcopy", len, calls, bench_ticks() - t0);
+
+    /* Misaligned source/destination pair */
+    t0 = bench_ticks();
+    for (uint32_t c = 0; c < calls; c++) my_memcopy(src + 1, dst + 3, len - 3);
+    bench_report("my_memcopy (misaligned)", len - 3, calls, bench_ticks() - t0);
+
+    t0 = bench_ticks();
+    for (uint32_t c = 0; c < calls; c++) memcpy(dst, src, len);
+    bench_report("memcpy", len, calls, bench_ticks() - t0);
+
+    bench_sink = dst[len - 1];
+  }
+
+  free(src);
+  free(dst);
+}
+
+void bench_memmove(void) {
+  static const size_t sizes[] = {64, 256, 1024, 4096,
+#if defined (HOST)
+                                 65536, 1UL << 20
+#endif
+                                };
+  /* Ring-buffer style window slides: a few bytes down and up */
+  static const size_t shift = 5;
+  uint8_t * buf = (uint8_t *) malloc(BENCH_MAX_BYTES + 2 * shift);
+
+  PRINTF("\nbench_memmove()\n");
+  if (!buf) {
+    return;
+  }
+  for (size_t i = 0; i < BENCH_MAX_BYTES + 2 * shift; i++) {
+    buf[i] = (uint8_t)i;
+  }
+
+  for (size_t n = 0; n < sizeof(sizes) / sizeof(sizes[0]); n++) {
+    size_t len = sizes[n];
+    uint32_t calls = (uint32_t)(BENCH_WORK_BYTES / len);
+    uint8_t * mid = buf + shift;
+    uint64_t t0;
+
+    t0 = bench_ticks();
+    for (uint32_t c = 0; c < calls; c++) ref_memmove_bytes(mid, buf, len);
+    bench_report("byte loop (fwd)", len, calls, bench_ticks() - t0);
+
+    t0 = bench_ticks();
+    for (uint32_t c = 0; c < calls; c++) my_memmove(mid, buf, len);
+    bench_report("my_memmove (fwd)", len, calls, bench_ticks() - t0);
+
+    t0 = bench_ticks();
+    for (uint32_t c = 0; c < calls; c++) memmove(buf, mid, len);
+    bench_report("memmove (fwd)", len, calls, bench_ticks() - t0);
+
+    t0 = bench_ticks();
+    for (uint32_t c = 0; c < calls; c++) ref_memmove_bytes(mid, mid + shift, len);
+    bench_report("byte loop (bwd)", len, calls, bench_ticks() - t0);
+
+    t0 = bench_ticks();
+    for (uint32_t c = 0; c < calls; c++) my_memmove(mid, mid + shift, len);
+    bench_report("my_memmove (bwd)", len, calls, bench_ticks() - t0);
+
+    t0 = bench_ticks();
+    for (uint32_t c = 0; c < calls; c++) memmove(mid + shift, mid, len);
+    bench_report("memmove (bwd)", len, calls, bench_ticks() - t0);
+
+    bench_sink = buf[len - 1];
+  }
+
+  free(buf);
+}
+
+void bench_memset(void) {
+  static const size_t sizes[] = {16, 64, 256, 1024, 4096,
+#if defined (HOST)
+                                 65536, 1UL << 20
+#endif
+                                };
+  uint8_t * buf = (uint8_t *) malloc(BENCH_MAX_BYTES);
+
+  PRINTF("\nbench_memset()\n");
+  if (!buf) {
+    return;
+  }
+
+  for (size_t n = 0; n < sizeof(sizes) / sizeof(sizes[0]); n++) {
+    size_t len = sizes[n];
+    uint32_t calls = (uint32_t)(BENCH_WORK_BYTES / len);
+    uint64_t t0;
+
+    t0 = bench_ticks();
+    for (uint32_t c = 0; c < calls; c++) ref_memset_bytes(buf, len, (uint8_t)c);
+    bench_report("byte loop", len, calls, bench_ticks() - t0);
+
+    t0 = bench_ticks();
+    for (uint32_t c = 0; c < calls; c++) my_memset(buf, len, (uint8_t)c);
+    bench_report("my_memset", len, calls, bench_ticks() - t0);
+
+    t0 = bench_ticks();
+    for (uint32_t c = 0; c < calls; c++) memset(buf, (uint8_t)c, len);
+    bench_report("memset", len, calls, bench_ticks() - t0);
+
+    t0 = bench_ticks();
+    for (uint32_t c = 0; c < calls; c++) {
+      my_memset16((uint16_t *)buf, len / 2, (uint16_t)c);
+    }
+    bench_report("my_memset16", len, calls, bench_ticks() - t0);
+
+    bench_sink = buf[len - 1];
+  }
+  free(buf);
+
+#if defined (HOST)
+  {
+    /* Clear a capture buffer larger than the LLC, then time a pass over a
+     * hot working set to see how much of it the clear evicted. */
+    size_t big = 4 * MEM_STREAM_THRESHOLD;
+    size_t hot_len = BENCH_MAX_BYTES;
+    uint8_t * cap = (uint8_t *) malloc(big);
+    uint8_t * hot = (uint8_t *) malloc(hot_len);
+    uint64_t t0;
+    uint32_t sum = 0;
+
+    if (cap && hot) {
+      my_memset(cap, big, 1);
+      my_memset(hot, hot_len, 1);
+
+      for (int mode = 0; mode < 2; mode++) {
+        for (size_t i = 0; i < hot_len; i += 64) sum += hot[i];
+
+        t0 = bench_ticks();
+        if (mode) {
+          my_memzero_stream(cap, big);
+        } else {
+          my_memzero(cap, big);
+        }
+        bench_report(mode ? "my_memzero_stream" : "my_memzero", big, 1,
+                     bench_ticks() - t0);
+
+        t0 = bench_ticks();
+        for (size_t i = 0; i < hot_len; i += 64) sum += hot[i];
+        bench_report(mode ? "  hot set after stream" : "  hot set after cached",
+                     hot_len, 1, bench_ticks() - t0);
+      }
+      bench_sink = (uint8_t)sum;
+    }
+    free(cap);
+    free(hot);
+  }
+#endif
+}
+
+void bench_reverse(void) {
+  static const size_t sizes[] = {16, 64, 256, 1024, 4096,
+#if defined (HOST)
+                                 65536, 1UL << 20
+#endif
+                                };
+  uint8_t * buf = (uint8_t *) malloc(BENCH_MAX_BYTES);
+
+  PRINTF("\nbench_reverse()\n");
+  if (!buf) {
+    return;
+  }
+  for (size_t i = 0; i < BENCH_MAX_BYTES; i++) {
+    buf[i] = (uint8_t)i;
+  }
+
+  for (size_t n = 0; n < sizeof(sizes) / sizeof(sizes[0]); n++) {
+    size_t len = sizes[n];
+    uint32_t calls = (uint32_t)(BENCH_WORK_BYTES / len);
+    uint64_t t0;
+
+    t0 = bench_ticks();
+    for (uint32_t c = 0; c < calls; c++) ref_reverse_bytes(buf, len);
+    bench_report("byte loop", len, calls, bench_ticks() - t0);
+
+    t0 = bench_ticks();
+    for (uint32_t c = 0; c < calls; c++) my_reverse(buf, len);
+    bench_report("my_reverse", len, calls, bench_ticks() - t0);
+
+    t0 = bench_ticks();
+    for (uint32_t c = 0; c < calls; c++) my_reverse(buf + 1, len - 1);
+    bench_report("my_reverse (odd)", len - 1, calls, bench_ticks() - t0);
+
+    t0 = bench_ticks();
+    for (uint32_t c = 0; c < calls; c++) my_reverse16((uint16_t *)buf, len / 2);
+    bench_report("my_reverse16", len, calls, bench_ticks() - t0);
+
+    t0 = bench_ticks();
+    for (uint32_t c = 0; c < calls; c++) my_reverse32((uint32_t *)buf, len / 4);
+    bench_report("my_reverse32", len, calls, bench_ticks() - t0);
+
+    bench_sink = buf[len - 1];
+  }
+  free(buf);
+}
+
+void bench_pool(void) {
+  enum { LIVE = 8 };
+  uint32_t calls = (uint32_t)(BENCH_WORK_BYTES / 64);
+  int32_t * live[LIVE];
+  uint64_t t0;
+
+  PRINTF("\nbench_pool()\n");
+
+  /* Short-lived scratch buffers, a few alive at a time */
+  t0 = bench_ticks();
+  for (uint32_t c = 0; c < calls; c += LIVE) {
+    for (int i = 0; i < LIVE; i++) live[i] = reserve_words(POOL_BLOCK_WORDS);
+    for (int i = 0; i < LIVE; i++) free_words(live[i]);
+  }
+  bench_report("reserve/free_words (pool)", POOL_BLOCK_WORDS * 4, calls,
+               bench_ticks() - t0);
+
+  t0 = bench_ticks();
+  for (uint32_t c = 0; c < calls; c += LIVE) {
+    for (int i = 0; i < LIVE; i++) {
+      live[i] = (int32_t *) malloc(POOL_BLOCK_WORDS * sizeof(int32_t));
+    }
+    for (int i = 0; i < LIVE; i++) free(live[i]);
+  }
+  bench_report("malloc/free", POOL_BLOCK_WORDS * 4, calls, bench_ticks() - t0);
+  print_pool_stats();
+}
+
+void bench_arena(void) {
+  enum { BATCH = 8, SCRATCH = 48 };
+  static uint8_t backing[BATCH * SCRATCH * 2];
+  uint32_t calls = (uint32_t)(BENCH_WORK_BYTES / SCRATCH);
+  uint8_t * live[BATCH];
+  arena_t arena;
+  uint64_t t0;
+
+  PRINTF("\nbench_arena()\n");
+  arena_init(&arena, backing, sizeof(backing));
+
+  /* A request handler's batch of scratch buffers, released together */
+  t0 = bench_ticks();
+  for (uint32_t c = 0; c < calls; c += BATCH) {
+    arena_mark_t mark = arena_mark(&arena);
+    for (int i = 0; i < BATCH; i++) {
+      live[i] = (uint8_t *) arena_alloc(&arena, SCRATCH, 0);
+    }
+    bench_sink = live[BATCH - 1][0];
+    arena_reset(&arena, mark);
+  }
+  bench_report("arena alloc + reset", SCRATCH, calls, bench_ticks() - t0);
+
+  t0 = bench_ticks();
+  for (uint32_t c = 0; c < calls; c += BATCH) {
+    for (int i = 0; i < BATCH; i++) live[i] = (uint8_t *) malloc(SCRATCH);
+    bench_sink = live[BATCH - 1][0];
+    for (int i = 0; i < BATCH; i++) free(live[i]);
+  }
+  bench_report("malloc/free", SCRATCH, calls, bench_ticks() - t0);
+}
+
+/**
+ * @brief Random alloc/free churn; reports mean and worst-case latency
+ * @param use_tlsf 1 for the TLSF heap, 0 for malloc/free
+ */
+static void bench_heap_churn(uint8_t use_tlsf) {
+  enum { SLOTS = 16, ROUNDS = 20000, MAX_BYTES = 192 };
+  void * slot[SLOTS] = {0};
+  uint32_t seed = 12345;
+  uint64_t worst_alloc = 0, worst_free = 0, total = 0;
+
+  for (uint32_t r = 0; r < ROUNDS; r++) {
+    uint32_t k, size;
+    uint64_t t0, dt;
+
+    seed = seed * 1103515245u + 12345u;
+    k = (seed >> 16) % SLOTS;
+    size = 1 + (seed >> 8) % MAX_BYTES;
+
+    if (slot[k]) {
+      t0 = bench_ticks();
+      if (use_tlsf) tlsf_free(slot[k]); else free(slot[k]);
+      dt = bench_ticks() - t0;
+      total += dt;
+      if (dt > worst_free) worst_free = dt;
+      slot[k] = NULL;
+    } else {
+      t0 = bench_ticks();
+      slot[k] = use_tlsf ? tlsf_alloc(size) : malloc(size);
+      dt = bench_ticks() - t0;
+      total += dt;
+      if (dt > worst_alloc) worst_alloc = dt;
+    }
+  }
+  for (uint32_t k = 0; k < SLOTS; k++) {
+    if (use_tlsf) tlsf_free(slot[k]); else free(slot[k]);
+  }
+
+  bench_report(use_tlsf ? "tlsf alloc/free (mean)" : "malloc/free (mean)",
+               MAX_BYTES / 2, ROUNDS, total);
+  bench_last_ticks = (uint32_t)worst_alloc;
+  bench_last_rate = (uint32_t)worst_free;
+  PRINTF("  %-26s alloc %lu %s, free %lu %s\n", "  worst case",
+         (unsigned long)bench_last_ticks, BENCH_TICK_UNIT,
+         (unsigned long)bench_last_rate, BENCH_TICK_UNIT);
+}
+
+void bench_tlsf(void) {
+  PRINTF("\nbench_tlsf()\n");
+  bench_heap_churn(1);
+  bench_heap_churn(0);
+  print_tlsf_stats();
+}
+
+#if defined (HOST)
+#define BENCH_MT_OPS (1UL << 21)   /* alloc/free pairs per thread */
+
+static void * mt_churn_worker(void * arg) {
+  uint8_t use_pool = *(uint8_t *)arg;
+  int32_t * live[8];
+
+  for (uint32_t c = 0; c < BENCH_MT_OPS; c += 8) {
+    for (int i = 0; i < 8; i++) {
+      live[i] = use_pool ? mtpool_reserve_words(MTPOOL_BLOCK_WORDS)
+                         : (int32_t *) malloc(MTPOOL_BLOCK_WORDS * 4);
+      live[i][0] = i;
+    }
+    for (int i = 0; i < 8; i++) {
+      if (use_pool) mtpool_free_words(live[i]); else free(live[i]);
+    }
+  }
+  return NULL;
+}
+
+/**
+ * @brief Run the churn worker on n threads and report total throughput
+ */
+static void mt_churn(uint8_t use_pool, uint32_t n) {
+  pthread_t threads[64];
+  char name[32];
+  uint64_t t0 = bench_ticks();
+
+  for (uint32_t t = 0; t < n; t++) {
+    pthread_create(&threads[t], NULL, mt_churn_worker, &use_pool);
+  }
+  for (uint32_t t = 0; t < n; t++) {
+    pthread_join(threads[t], NULL);
+  }
+  snprintf(name, sizeof(name), "%s x%u", use_pool ? "mtpool" : "malloc",
+           (unsigned)n);
+  bench_report(name, MTPOOL_BLOCK_WORDS * 4, (uint32_t)(BENCH_MT_OPS * n),
+               bench_ticks() - t0);
+}
+
+void bench_mtpool(void) {
+  long cpus = sysconf(_SC_NPROCESSORS_ONLN);
+  uint32_t max_threads = (uint32_t)(cpus > 4 ? (cpus < 64 ? cpus : 64) : 4);
+  mtpool_stats_t stats;
+
+  PRINTF("\nbench_mtpool() - %u CPUs, ns/call is wall time / total ops\n",
+         (unsigned)cpus);
+  for (uint32_t n = 1; n <= max_threads; n *= 2) {
+    mt_churn(1, n);
+    mt_churn(0, n);
+  }
+  mtpool_get_stats(&stats);
+  PRINTF("  mtpool high-water %u of %u blocks, %u malloc fallbacks\n",
+         (unsigned)stats.high_water, (unsigned)stats.block_count,
+         (unsigned)stats.misses);
+}
+#endif
+
+void bench_dma(void) {
+  static const size_t sizes[] = {64, 256, 1024, 4096,
+#if defined (HOST)
+                                 65536, 1UL << 20
+#endif
+                                };
+  uint8_t * src = (uint8_t *) malloc(BENCH_MAX_BYTES);
+  uint8_t * dst = (uint8_t *) malloc(BENCH_MAX_BYTES);
+  uint8_t * work = (uint8_t *) malloc(BENCH_MAX_BYTES);
+
+  PRINTF("\nbench_dma() - overlap: copy and an equal-size memset\n");
+  if (!src || !dst || !work) {
+    free(src);
+    free(dst);
+    free(work);
+    return;
+  }
+  for (size_t i = 0; i < BENCH_MAX_BYTES; i++) {
+    src[i] = (uint8_t)i;
+  }
+  dma_init();
+
+  for (size_t n = 0; n < sizeof(sizes) / sizeof(sizes[0]); n++) {
+    size_t len = sizes[n];
+    uint32_t calls = (uint32_t)(BENCH_WORK_BYTES / len);
+    uint64_t t0, submit = 0;
+
+    t0 = bench_ticks();
+    for (uint32_t c = 0; c < calls; c++) my_memcopy(src, dst, len);
+    bench_report("my_memcopy", len, calls, bench_ticks() - t0);
+
+    t0 = bench_ticks();
+    for (uint32_t c = 0; c < calls; c++) {
+      uint64_t t1 = bench_ticks();
+      dma_handle_t h = dma_memcopy_async(src, dst, len, NULL, NULL);
+      submit += bench_ticks() - t1;
+      dma_wait(h);
+    }
+    bench_report("dma submit+wait", len, calls, bench_ticks() - t0);
+    bench_report("  submit only", len, calls, submit);
+
+    /* Same work done back to back, then with the copy in the background */
+    t0 = bench_ticks();
+    for (uint32_t c = 0; c < calls; c++) {
+      my_memcopy(src, dst, len);
+      my_memset(work, len, (uint8_t)c);
+    }
+    bench_report("copy then memset", len, calls, bench_ticks() - t0);
+
+    t0 = bench_ticks();
+    for (uint32_t c = 0; c < calls; c++) {
+      dma_handle_t h = dma_memcopy_async(src, dst, len, NULL, NULL);
+      my_memset(work, len, (uint8_t)c);
+      dma_wait(h);
+    }
+    bench_report("dma copy || memset", len, calls, bench_ticks() - t0);
+
+    bench_sink = dst[len - 1] ^ work[0];
+  }
+
+  free(src);
+  free(dst);
+  free(work);
+}
+
+void bench_bits(void) {
+  enum { BITS = 8192 };
+  static uint8_t set[BITS / 8];
+  uint32_t calls = (uint32_t)(BENCH_WORK_BYTES / sizeof(set));
+  size_t total = 0;
+  uint64_t t0;
+
+  PRINTF("\nbench_bits() - %u-bit set, ns/call per full pass\n",
+         (unsigned)BITS);
+
+  t0 = bench_ticks();
+  for (uint32_t c = 0; c < calls / 64; c++) {
+    for (size_t b = 0; b < BITS; b += 3) {
+      set[b >> 3] |= (uint8_t)(1u << (b & 7u));
+    }
+  }
+  bench_report("plain |= (not atomic)", sizeof(set), calls / 64,
+               bench_ticks() - t0);
+
+  t0 = bench_ticks();
+  for (uint32_t c = 0; c < calls / 64; c++) {
+    for (size_t b = 0; b < BITS; b += 3) {
+      set_bit(set, b);
+    }
+  }
+  bench_report("set_bit", sizeof(set), calls / 64, bench_ticks() - t0);
+
+  t0 = bench_ticks();
+  for (uint32_t c = 0; c < calls; c++) {
+    for (size_t b = 0; b < BITS; b++) {
+      total += (set[b >> 3] >> (b & 7u)) & 1u;
+    }
+  }
+  bench_report("bit loop popcount", sizeof(set), calls, bench_ticks() - t0);
+
+  t0 = bench_ticks();
+  for (uint32_t c = 0; c < calls; c++) {
+    total += count_bits(set, BITS);
+  }
+  bench_report("count_bits", sizeof(set), calls, bench_ticks() - t0);
+
+  /* Only the last bit set: worst case for the scan */
+  my_memzero(set, sizeof(set));
+  set_bit(set, BITS - 1);
+  t0 = bench_ticks();
+  for (uint32_t c = 0; c < calls; c++) {
+    size_t b = 0;
+    while (b < BITS && !((set[b >> 3] >> (b & 7u)) & 1u)) {
+      b++;
+    }
+    total += b;
+  }
+  bench_report("bit loop first set", sizeof(set), calls, bench_ticks() - t0);
+
+  t0 = bench_ticks();
+  for (uint32_t c = 0; c < calls; c++) {
+    total += (size_t)find_first_bit(set, BITS);
+  }
+  bench_report("find_first_bit", sizeof(set), calls, bench_ticks() - t0);
+
+  bench_sink = (uint8_t)total;
+}
+
+/**
+ * @brief Time one sort over calls fresh copies of in (copy time included)
+ */
+static void bench_sort_one(const char * name,
+                           void (*sort)(unsigned char *, unsigned int),
+                           uint8_t * in, uint8_t * out, size_t n,
+                           uint32_t calls) {
+  uint64_t t0 = bench_ticks();
+
+  for (uint32_t c = 0; c < calls; c++) {
+    my_memcopy(in, out, n);
+    if (sort) sort(out, (unsigned int)n);
+  }
+  bench_report(name, n, calls, bench_ticks() - t0);
+  bench_sink = out[n / 2];
+}
+
+void bench_sort(void) {
+  static const size_t sizes[] = {40, 256, 1024, 4096,
+#if defined (HOST)
+                                 65536, 1UL << 20, 4UL << 20
+#endif
+                                };
+#if defined (HOST)
+  const size_t max_n = 4UL << 20;
+#else
+  const size_t max_n = 4096;
+#endif
+  uint8_t * in = (uint8_t *) malloc(max_n);
+  uint8_t * out = (uint8_t *) malloc(max_n);
+  uint32_t seed = 2024;
+
+  PRINTF("\nbench_sort() - random bytes, times include a copy of the input\n");
+  if (!in || !out) {
+    free(in);
+    free(out);
+    return;
+  }
+  for (size_t i = 0; i < max_n; i++) {
+    seed = seed * 1103515245u + 12345u;
+    in[i] = (uint8_t)(seed >> 16);
+  }
+
+  for (size_t k = 0; k < sizeof(sizes) / sizeof(sizes[0]); k++) {
+    size_t n = sizes[k];
+    uint32_t calls = (uint32_t)(BENCH_WORK_BYTES / 4 / n);
+
+    if (calls == 0) calls = 1;
+    bench_sort_one("copy only", NULL, in, out, n, calls);
+    /* O(n^2): keep the total comparison count bounded */
+    if (n <= 4096) {
+      uint32_t bubble_calls = (uint32_t)((BENCH_WORK_BYTES * 4) / (n * n));
+      bench_sort_one("bubble sort", ref_bubble_sort, in, out, n,
+                     bubble_calls ? bubble_calls : 1);
+    }
+    if (n <= 4096) {
+      bench_sort_one("insertion sort", sort_array_insertion, in, out, n,
+                     calls / (uint32_t)(n / 40) + 1);
+    }
+    bench_sort_one("introsort", sort_array_intro, in, out, n, calls);
+    bench_sort_one("counting sort", sort_array_counting, in, out, n, calls);
+    bench_sort_one("sort_array", sort_array, in, out, n, calls);
+  }
+
+  free(in);
+  free(out);
+}
+
+static void network_sort(unsigned char * data, unsigned int size) {
+  (void)sort_array_network(data, size);
+}
+
+void bench_sort_network(void) {
+  static const size_t sizes[] = {8, 16, 32, 40};
+  static const char * const inputs[] = {"random", "ascending", "descending"};
+  uint8_t in[40];
+  uint8_t out[40];
+  uint32_t seed = 43;
+
+  PRINTF("\nbench_sort_network() - times include a copy of the input\n");
+  for (size_t k = 0; k < sizeof(sizes) / sizeof(sizes[0]); k++) {
+    size_t n = sizes[k];
+    uint32_t calls = (uint32_t)(BENCH_WORK_BYTES / 16 / n);
+
+    for (size_t p = 0; p < sizeof(inputs) / sizeof(inputs[0]); p++) {
+      for (size_t i = 0; i < n; i++) {
+        seed = seed * 1103515245u + 12345u;
+        in[i] = p == 0 ? (uint8_t)(seed >> 16) :
+                p == 1 ? (uint8_t)(i * 6) : (uint8_t)(255 - i * 6);
+      }
+      PRINTF("  %s:\n", inputs[p]);
+      bench_sort_one("sorting network", network_sort, in, out, n, calls);
+      bench_sort_one("insertion sort", sort_array_insertion, in, out, n,
+                     calls);
+      bench_sort_one("introsort", sort_array_intro, in, out, n, calls);
+    }
+  }
+}
+
+/* Reference kernels: the scalar stats loops */
+static unsigned char ref_max_bytes(const uint8_t * data, size_t n) {
+  unsigned char max = data[0];
+  for (size_t i = 1; i < n; i++) if (data[i] > max) max = data[i];
+  return max;
+}
+
+static unsigned char ref_min_bytes(const uint8_t * data, size_t n) {
+  unsigned char min = data[0];
+  for (size_t i = 1; i < n; i++) if (data[i] < min) min = data[i];
+  return min;
+}
+
+static uint32_t ref_sum_bytes(const uint8_t * data, size_t n) {
+  uint32_t sum = 0;
+  for (size_t i = 0; i < n; i++) sum += data[i];
+  return sum;
+}
+
+/**
+ * @brief Old find_median: copy, bubble sort, read the middle
+ */
+static unsigned char ref_sort_median(const uint8_t * in, uint8_t * tmp,
+                                     unsigned int n) {
+  my_memcopy((uint8_t *)in, tmp, n);
+  ref_bubble_sort(tmp, n);
+  return tmp[n / 2];
+}
+
+static int cmp_i32_desc(const void * a, const void * b) {
+  int32_t x = *(const int32_t *)a, y = *(const int32_t *)b;
+  return (x < y) - (x > y);
+}
+
+void bench_median(void) {
+  static const size_t sizes[] = {40, 1024,
+#if defined (HOST)
+                                 65536, 1UL << 20
+#endif
+                                };
+#if defined (HOST)
+  const size_t max_n = 1UL << 20;
+#else
+  const size_t max_n = 1024;
+#endif
+  uint8_t * in = (uint8_t *) malloc(max_n);
+  uint8_t * tmp = (uint8_t *) malloc(max_n);
+  int32_t * wide = (int32_t *) malloc(max_n * sizeof(int32_t));
+  int32_t * scratch = (int32_t *) malloc(max_n * sizeof(int32_t));
+  uint32_t seed = 99;
+  uint32_t acc = 0;
+
+  PRINTF("\nbench_median()\n");
+  if (!in || !tmp || !wide || !scratch) {
+    free(in);
+    free(tmp);
+    free(wide);
+    free(scratch);
+    return;
+  }
+  for (size_t i = 0; i < max_n; i++) {
+    seed = seed * 1103515245u + 12345u;
+    in[i] = (uint8_t)(seed >> 16);
+    wide[i] = (int32_t)seed;
+  }
+
+  for (size_t k = 0; k < sizeof(sizes) / sizeof(sizes[0]); k++) {
+    unsigned int n = (unsigned int)sizes[k];
+    uint32_t calls = (uint32_t)(BENCH_WORK_BYTES / 4 / n);
+    uint64_t t0;
+
+    if (calls == 0) calls = 1;
+    if (n <= 4096) {
+      uint32_t bubble_calls = (uint32_t)((BENCH_WORK_BYTES * 4) / (n * n));
+      if (bubble_calls == 0) bubble_calls = 1;
+      t0 = bench_ticks();
+      for (uint32_t c = 0; c < bubble_calls; c++) {
+        acc += ref_sort_median(in, tmp, n);
+      }
+      bench_report("copy + bubble sort", n, bubble_calls, bench_ticks() - t0);
+    }
+
+    t0 = bench_ticks();
+    for (uint32_t c = 0; c < calls; c++) {
+      my_memcopy(in, tmp, n);
+      sort_array(tmp, n);
+      acc += tmp[n / 2];
+    }
+    bench_report("copy + sort_array", n, calls, bench_ticks() - t0);
+
+    t0 = bench_ticks();
+    for (uint32_t c = 0; c < calls; c++) acc += find_median(in, n);
+    bench_report("find_median (histogram)", n, calls, bench_ticks() - t0);
+
+    calls = calls / 4 + 1;
+    t0 = bench_ticks();
+    for (uint32_t c = 0; c < calls; c++) {
+      my_memcopy((uint8_t *)wide, (uint8_t *)scratch, n * sizeof(int32_t));
+      qsort(scratch, n, sizeof(int32_t), cmp_i32_desc);
+      acc += (uint32_t)scratch[n / 2];
+    }
+    bench_report("i32 copy + qsort", n * 4, calls, bench_ticks() - t0);
+
+    t0 = bench_ticks();
+    for (uint32_t c = 0; c < calls; c++) {
+      acc += (uint32_t)find_kth_i32(wide, n, n / 2, scratch);
+    }
+    bench_report("find_kth_i32", n * 4, calls, bench_ticks() - t0);
+  }
+  bench_sink = (uint8_t)acc;
+
+  free(in);
+  free(tmp);
+  free(wide);
+  free(scratch);
+}
+
+void bench_statistics(void) {
+  static const size_t sizes[] = {40, 1024,
+#if defined (HOST)
+                                 65536, 1UL << 20, 16UL << 20
+#endif
+                                };
+#if defined (HOST)
+  const size_t max_n = 16UL << 20;
+#else
+  const size_t max_n = 1024;
+#endif
+  uint8_t * in = (uint8_t *) malloc(max_n);
+  uint8_t * tmp = (uint8_t *) malloc(max_n);
+  stats_result_t result;
+  uint32_t seed = 5;
+  uint32_t acc = 0;
+
+  PRINTF("\nbench_statistics() - min, max, mean, median\n");
+  if (!in || !tmp) {
+    free(in);
+    free(tmp);
+    return;
+  }
+  for (size_t i = 0; i < max_n; i++) {
+    seed = seed * 1103515245u + 12345u;
+    in[i] = (uint8_t)(seed >> 16);
+  }
+
+  for (size_t k = 0; k < sizeof(sizes) / sizeof(sizes[0]); k++) {
+    unsigned int n = (unsigned int)sizes[k];
+    uint32_t calls = (uint32_t)(BENCH_WORK_BYTES / 2 / n);
+    uint64_t t0;
+
+    if (calls == 0) calls = 1;
+    /* What print_statistics used to do, with the sort_array engine */
+    t0 = bench_ticks();
+    for (uint32_t c = 0; c < calls; c++) {
+      acc += find_maximum(in, n) + find_minimum(in, n) + find_mean(in, n);
+      my_memcopy(in, tmp, n);
+      sort_array(tmp, n);
+      acc += tmp[n / 2];
+    }
+    bench_report("separate + sort", n, calls, bench_ticks() - t0);
+
+    t0 = bench_ticks();
+    for (uint32_t c = 0; c < calls; c++) {
+      acc += find_maximum(in, n) + find_minimum(in, n) + find_mean(in, n) +
+             find_median(in, n);
+    }
+    bench_report("separate passes", n, calls, bench_ticks() - t0);
+
+    t0 = bench_ticks();
+    for (uint32_t c = 0; c < calls; c++) {
+      compute_statistics(in, n, &result);
+      acc += result.maximum + result.minimum + result.mean + result.median;
+    }
+    bench_report("compute_statistics", n, calls, bench_ticks() - t0);
+  }
+  bench_sink = (uint8_t)acc;
+
+  free(in);
+  free(tmp);
+}
+
+void bench_stats_kernels(void) {
+  static const size_t sizes[] = {40, 1024, 4096,
+#if defined (HOST)
+                                 1UL << 20
+#endif
+                                };
+  uint8_t * in = (uint8_t *) malloc(BENCH_MAX_BYTES);
+  uint32_t seed = 77;
+  uint64_t acc = 0;
+
+#if defined (HOST) && defined (__AVX2__)
+  PRINTF("\nbench_stats_kernels() - AVX2 vs scalar\n");
+#elif defined (HOST) && defined (__SSE2__)
+  PRINTF("\nbench_stats_kernels() - SSE2 vs scalar\n");
+#else
+  PRINTF("\nbench_stats_kernels() - DSP (USUB8/SEL, USADA8) vs scalar\n");
+#endif
+  if (!in) {
+    return;
+  }
+  for (size_t i = 0; i < BENCH_MAX_BYTES; i++) {
+    seed = seed * 1103515245u + 12345u;
+    in[i] = (uint8_t)(seed >> 16);
+  }
+
+  for (size_t k = 0; k < sizeof(sizes) / sizeof(sizes[0]); k++) {
+    unsigned int n = (unsigned int)sizes[k];
+    uint32_t calls = (uint32_t)(BENCH_WORK_BYTES / n);
+    uint64_t t0;
+
+    t0 = bench_ticks();
+    for (uint32_t c = 0; c < calls; c++) acc += ref_max_bytes(in, n);
+    bench_report("scalar max", n, calls, bench_ticks() - t0);
+    t0 = bench_ticks();
+    for (uint32_t c = 0; c < calls; c++) acc += find_maximum(in, n);
+    bench_report("find_maximum", n, calls, bench_ticks() - t0);
+
+    t0 = bench_ticks();
+    for (uint32_t c = 0; c < calls; c++) acc += ref_min_bytes(in, n);
+    bench_report("scalar min", n, calls, bench_ticks() - t0);
+    t0 = bench_ticks();
+    for (uint32_t c = 0; c < calls; c++) acc += find_minimum(in, n);
+    bench_report("find_minimum", n, calls, bench_ticks() - t0);
+
+    t0 = bench_ticks();
+    for (uint32_t c = 0; c < calls; c++) acc += ref_sum_bytes(in, n);
+    bench_report("scalar sum", n, calls, bench_ticks() - t0);
+    t0 = bench_ticks();
+    for (uint32_t c = 0; c < calls; c++) acc += find_sum(in, n);
+    bench_report("find_sum", n, calls, bench_ticks() - t0);
+  }
+  bench_sink = (uint8_t)acc;
+  free(in);
+}
+
+void bench_stats_stream(void) {
+  static const uint32_t windows[] = {40, 1024,
+#if defined (HOST)
+                                     16384
+#endif
+                                    };
+#if defined (HOST)
+  enum { SAMPLES = 1 << 16 };
+#else
+  enum { SAMPLES = 1 << 12 };
+#endif
+  uint8_t * samples = (uint8_t *) malloc(SAMPLES);
+  uint8_t * ring = (uint8_t *) malloc(windows[sizeof(windows) /
+                                              sizeof(windows[0]) - 1]);
+  uint8_t * tmp = (uint8_t *) malloc(windows[sizeof(windows) /
+                                             sizeof(windows[0]) - 1]);
+  stats_stream_t stream;
+  uint32_t seed = 31;
+  uint32_t acc = 0;
+
+  PRINTF("\nbench_stats_stream() - push + window median, per sample\n");
+  if (!samples || !ring || !tmp) {
+    free(samples);
+    free(ring);
+    free(tmp);
+    return;
+  }
+  for (uint32_t i = 0; i < SAMPLES; i++) {
+    seed = seed * 1103515245u + 12345u;
+    samples[i] = (uint8_t)(seed >> 16);
+  }
+
+  for (size_t k = 0; k < sizeof(windows) / sizeof(windows[0]); k++) {
+    uint32_t w = windows[k];
+    uint32_t n = SAMPLES;
+    uint64_t t0;
+
+    /* Re-sort a copy of the window after every sample */
+    if (w <= 1024) {
+      t0 = bench_ticks();
+      for (uint32_t i = w; i < n; i++) {
+        my_memcopy(samples + i - w, tmp, w);
+        sort_array(tmp, w);
+        acc += tmp[w / 2];
+      }
+      bench_report("copy + sort_array", w, n - w, bench_ticks() - t0);
+    }
+
+    t0 = bench_ticks();
+    for (uint32_t i = w; i < n; i++) {
+      acc += find_median(samples + i - w, w);
+    }
+    bench_report("find_median of window", w, n - w, bench_ticks() - t0);
+
+    stats_stream_init(&stream, ring, w);
+    stats_stream_push_block(&stream, samples, w);
+    t0 = bench_ticks();
+    for (uint32_t i = w; i < n; i++) {
+      stats_stream_push(&stream, samples[i]);
+      acc += stats_stream_median(&stream);
+    }
+    bench_report("stats_stream push+median", w, n - w, bench_ticks() - t0);
+  }
+  bench_sink = (uint8_t)acc;
+
+  free(samples);
+  free(ring);
+  free(tmp);
+}
+
+/* Reference kernels for the typed statistics: the plain loops */
+#define REF_TYPED(sfx, T, SUM_T)                                            \
+  static T ref_max_##sfx(const T * data, unsigned int n) {                  \
+    T max = data[0];                                                        \
+    for (unsigned int i = 1; i < n; i++) if (data[i] > max) max = data[i];  \
+    return max;                                                             \
+  }                                                                         \
+  static SUM_T ref_sum_##sfx(const T * data, unsigned int n) {              \
+    SUM_T sum = 0;                                                          \
+    for (unsigned int i = 0; i < n; i++) sum += data[i];                    \
+    return sum;                                                             \
+  }
+
+REF_TYPED(u16, uint16_t, uint64_t)
+REF_TYPED(i16, int16_t, int64_t)
+REF_TYPED(i32, int32_t, int64_t)
+REF_TYPED(f32, float, double)
+#undef REF_TYPED
+
+/* Times max and sum of one sample type against the plain loops */
+#define BENCH_TYPED(sfx, data, n, calls)                                    \
+  do {                                                                      \
+    size_t bytes = (size_t)(n) * sizeof((data)[0]);                         \
+    uint64_t t0 = bench_ticks();                                            \
+    for (uint32_t c = 0; c < (calls); c++) acc += ref_max_##sfx(data, n);   \
+    bench_report("scalar max " #sfx, bytes, calls, bench_ticks() - t0);     \
+    t0 = bench_ticks();                                                     \
+    for (uint32_t c = 0; c < (calls); c++) acc += find_maximum_##sfx(data, n); \
+    bench_report("find_maximum_" #sfx, bytes, calls, bench_ticks() - t0);   \
+    t0 = bench_ticks();                                                     \
+    for (uint32_t c = 0; c < (calls); c++) acc += ref_sum_##sfx(data, n);   \
+    bench_report("scalar sum " #sfx, bytes, calls, bench_ticks() - t0);     \
+    t0 = bench_ticks();                                                     \
+    for (uint32_t c = 0; c < (calls); c++) acc += find_sum_##sfx(data, n);  \
+    bench_report("find_sum_" #sfx, bytes, calls, bench_ticks() - t0);       \
+  } while (0)
+
+void bench_stats_typed(void) {
+  static const unsigned int sizes[] = {40, 1024,
+#if defined (HOST)
+                                       1u << 18
+#endif
+                                      };
+  unsigned int max_n = sizes[sizeof(sizes) / sizeof(sizes[0]) - 1];
+  uint16_t * u16 = (uint16_t *) malloc(max_n * sizeof(uint16_t));
+  int16_t * i16 = (int16_t *) malloc(max_n * sizeof(int16_t));
+  int32_t * i32 = (int32_t *) malloc(max_n * sizeof(int32_t));
+  float * f32 = (float *) malloc(max_n * sizeof(float));
+  uint32_t seed = 41;
+  double acc = 0;
+
+#if defined (HOST) && defined (__SSE2__)
+  PRINTF("\nbench_stats_typed() - SSE2 vs scalar\n");
+#else
+  PRINTF("\nbench_stats_typed() - DSP (USUB16/SSUB16/SEL, SMLALD) vs scalar\n");
+#endif
+  if (!u16 || !i16 || !i32 || !f32) {
+    free(u16);
+    free(i16);
+    free(i32);
+    free(f32);
+    return;
+  }
+  for (unsigned int i = 0; i < max_n; i++) {
+    seed = seed * 1103515245u + 12345u;
+    u16[i] = (uint16_t)(seed >> 12) & 0x3FFF;   /* 14-bit ADC samples */
+    i16[i] = (int16_t)(seed >> 8);
+    i32[i] = (int32_t)seed;
+    f32[i] = (float)(int32_t)seed / 65536.0f;
+  }
+
+  for (size_t k = 0; k < sizeof(sizes) / sizeof(sizes[0]); k++) {
+    unsigned int n = sizes[k];
+
+    /* Same number of samples per type, so times compare across widths */
+    uint32_t calls = (uint32_t)(BENCH_WORK_BYTES / 2 / n);
+    BENCH_TYPED(u16, u16, n, calls);
+    BENCH_TYPED(i16, i16, n, calls);
+    BENCH_TYPED(i32, i32, n, calls);
+    BENCH_TYPED(f32, f32, n, calls);
+  }
+  bench_sink = (uint8_t)acc;
+
+  free(u16);
+  free(i16);
+  free(i32);
+  free(f32);
+}
+#undef BENCH_TYPED
+
+/*
+ * Float references for the dispersion statistics: what the old float
+ * post-processing step did. sqrt is Newton's method so libm is not needed.
+ */
+static float ref_sqrtf(float x) {
+  float r = x > 1.0f ? x / 2.0f : 1.0f;
+  if (x <= 0.0f) return 0.0f;
+  for (int i = 0; i < 20; i++) r = 0.5f * (r + x / r);
+  return r;
+}
+
+static float ref_variance_f(const uint8_t * data, unsigned int n) {
+  float mean = 0.0f, var = 0.0f;
+  for (unsigned int i = 0; i < n; i++) mean += data[i];
+  mean /= (float)n;
+  for (unsigned int i = 0; i < n; i++) {
+    float d = (float)data[i] - mean;
+    var += d * d;
+  }
+  return var / (float)n;
+}
+
+static int cmp_u8_asc(const void * a, const void * b) {
+  return *(const uint8_t *)a - *(const uint8_t *)b;
+}
+
+/* Sort a copy, then index it at pct / 100 of the length */
+static void ref_percentiles_f(const uint8_t * data, uint8_t * tmp,
+                              unsigned int n, const unsigned int * pct,
+                              unsigned int count, uint8_t * out) {
+  my_memcopy((uint8_t *)data, tmp, n);
+  qsort(tmp, n, 1, cmp_u8_asc);
+  for (unsigned int i = 0; i < count; i++) {
+    float pos = (float)pct[i] / 100.0f * (float)n;
+    unsigned int idx = pos < 1.0f ? 0 : (unsigned int)(pos + 0.999f) - 1;
+    out[i] = tmp[idx < n ? idx : n - 1];
+  }
+}
+
+static void ref_histogram_f(const uint8_t * data, unsigned int n,
+                            uint32_t * bins, unsigned int bin_count) {
+  float scale = (float)bin_count / 256.0f;
+  for (unsigned int b = 0; b < bin_count; b++) bins[b] = 0;
+  for (unsigned int i = 0; i < n; i++) bins[(unsigned int)(data[i] * scale)]++;
+}
+
+void bench_variance(void) {
+  static const unsigned int sizes[] = {40, 1024, 4096,
+#if defined (HOST)
+                                       1u << 20
+#endif
+                                      };
+  static const unsigned int pcts[] = {1, 5, 25, 50, 75, 95, 99};
+  enum { PCT_COUNT = sizeof(pcts) / sizeof(pcts[0]), BINS = 16 };
+  uint8_t * in = (uint8_t *) malloc(BENCH_MAX_BYTES);
+  uint8_t * tmp = (uint8_t *) malloc(BENCH_MAX_BYTES);
+  uint8_t out[PCT_COUNT];
+  uint32_t bins[BINS];
+  /* Read through a volatile pointer so the pure float references are not
+     hoisted out of the timing loops */
+  const uint8_t * volatile src = in;
+  uint32_t seed = 19;
+  float facc = 0.0f;
+  uint64_t acc = 0;
+
+  PRINTF("\nbench_variance() - integer math vs float reference\n");
+  if (!in || !tmp) {
+    free(in);
+    free(tmp);
+    return;
+  }
+  for (size_t i = 0; i < BENCH_MAX_BYTES; i++) {
+    seed = seed * 1103515245u + 12345u;
+    /* Sum of two bytes / 2: a rough bell shape */
+    in[i] = (uint8_t)(((seed >> 8 & 0xFF) + (seed >> 16 & 0xFF)) / 2);
+  }
+
+  for (size_t k = 0; k < sizeof(sizes) / sizeof(sizes[0]); k++) {
+    unsigned int n = sizes[k];
+    uint32_t calls = (uint32_t)(BENCH_WORK_BYTES / n);
+    uint32_t sort_calls = calls / 8 ? calls / 8 : 1;
+    uint64_t t0;
+
+    t0 = bench_ticks();
+    for (uint32_t c = 0; c < calls; c++) facc += ref_variance_f(src, n);
+    bench_report("float variance", n, calls, bench_ticks() - t0);
+    t0 = bench_ticks();
+    for (uint32_t c = 0; c < calls; c++) acc += find_variance(in, n);
+    bench_report("find_variance", n, calls, bench_ticks() - t0);
+    t0 = bench_ticks();
+    for (uint32_t c = 0; c < calls; c++) acc += find_variance_q8(in, n);
+    bench_report("find_variance_q8", n, calls, bench_ticks() - t0);
+
+    t0 = bench_ticks();
+    for (uint32_t c = 0; c < calls; c++) {
+      facc += ref_sqrtf(ref_variance_f(src, n));
+    }
+    bench_report("float stddev", n, calls, bench_ticks() - t0);
+    t0 = bench_ticks();
+    for (uint32_t c = 0; c < calls; c++) acc += find_stddev_q8(in, n);
+    bench_report("find_stddev_q8", n, calls, bench_ticks() - t0);
+
+    t0 = bench_ticks();
+    for (uint32_t c = 0; c < sort_calls; c++) {
+      ref_percentiles_f(src, tmp, n, pcts, PCT_COUNT, out);
+      acc += out[0];
+    }
+    bench_report("float percentiles (qsort)", n, sort_calls,
+                 bench_ticks() - t0);
+    t0 = bench_ticks();
+    for (uint32_t c = 0; c < calls; c++) {
+      find_percentiles(in, n, pcts, PCT_COUNT, out);
+      acc += out[0];
+    }
+    bench_report("find_percentiles", n, calls, bench_ticks() - t0);
+
+    t0 = bench_ticks();
+    for (uint32_t c = 0; c < calls; c++) {
+      ref_histogram_f(src, n, bins, BINS);
+      acc += bins[0];
+    }
+    bench_report("float histogram (16 bins)", n, calls, bench_ticks() - t0);
+    t0 = bench_ticks();
+    for (uint32_t c = 0; c < calls; c++) {
+      find_histogram(in, n, bins, BINS);
+      acc += bins[0];
+    }
+    bench_report("find_histogram (16 bins)", n, calls, bench_ticks() - t0);
+  }
+
+  /* isqrt against the float Newton square root, per call */
+  {
+    enum { ROOTS = 1 << 12 };
+    uint64_t t0 = bench_ticks();
+    for (uint32_t c = 0; c < ROOTS; c++) facc += ref_sqrtf((float)(c * 2654435761u));
+    bench_report("float sqrt", 4, ROOTS, bench_ticks() - t0);
+    t0 = bench_ticks();
+    for (uint32_t c = 0; c < ROOTS; c++) acc += isqrt(c * 2654435761u);
+    bench_report("isqrt", 4, ROOTS, bench_ticks() - t0);
+  }
+  bench_sink = (uint8_t)(acc + (uint64_t)facc);
+
+  free(in);
+  free(tmp);
+}
+
+void bench_top_k(void) {
+  static const unsigned int sizes[] = {40, 1024, 4096,
+#if defined (HOST)
+                                       1u << 20
+#endif
+                                      };
+  static const unsigned int ks[] = {8, 16, 64, 256};
+  static const char * const top_names[] = {
+    "find_top_k k=8", "find_top_k k=16", "find_top_k k=64", "find_top_k k=256"
+  };
+  static const char * const partial_names[] = {
+    "sort_array_partial k=8", "sort_array_partial k=16",
+    "sort_array_partial k=64", "sort_array_partial k=256"
+  };
+  uint8_t * in = (uint8_t *) malloc(BENCH_MAX_BYTES);
+  uint8_t * tmp = (uint8_t *) malloc(BENCH_MAX_BYTES);
+  uint8_t out[256];
+  uint32_t seed = 37;
+  uint64_t acc = 0;
+
+  PRINTF("\nbench_top_k() - random bytes, sorts include a copy of the input\n");
+  if (!in || !tmp) {
+    free(in);
+    free(tmp);
+    return;
+  }
+  for (size_t i = 0; i < BENCH_MAX_BYTES; i++) {
+    seed = seed * 1103515245u + 12345u;
+    in[i] = (uint8_t)(seed >> 16);
+  }
+
+  for (size_t s = 0; s < sizeof(sizes) / sizeof(sizes[0]); s++) {
+    unsigned int n = sizes[s];
+    uint32_t calls = (uint32_t)(BENCH_WORK_BYTES / 4 / n);
+    uint64_t t0;
+
+    if (calls == 0) calls = 1;
+    t0 = bench_ticks();
+    for (uint32_t c = 0; c < calls; c++) {
+      my_memcopy(in, tmp, n);
+      sort_array(tmp, n);
+      acc += tmp[0];
+    }
+    bench_report("sort_array (all)", n, calls, bench_ticks() - t0);
+
+    for (size_t j = 0; j < sizeof(ks) / sizeof(ks[0]); j++) {
+      unsigned int k = ks[j];
+
+      if (k >= n) continue;
+      t0 = bench_ticks();
+      for (uint32_t c = 0; c < calls; c++) {
+        acc += find_top_k(in, n, k, out);
+      }
+      bench_report(top_names[j], n, calls, bench_ticks() - t0);
+
+      t0 = bench_ticks();
+      for (uint32_t c = 0; c < calls; c++) {
+        my_memcopy(in, tmp, n);
+        sort_array_partial(tmp, n, k);
+        acc += tmp[k - 1];
+      }
+      bench_report(partial_names[j], n, calls, bench_ticks() - t0);
+    }
+  }
+  bench_sink = (uint8_t)(acc + out[0]);
+
+  free(in);
+  free(tmp);
+}
+
+/* Wide sorts behind one signature for bench_sort_wide */
+static void wide_intro_u16(void * data, unsigned int n, void * tmp) {
+  (void)tmp;
+  sort_array_u16((uint16_t *)data, n);
+}
+
+static void wide_radix_u16(void * data, unsigned int n, void * tmp) {
+  radix_sort_u16((uint16_t *)data, n, (uint16_t *)tmp);
+}
+
+/* Signed order, but the same work as sorting the u32 keys */
+static void wide_intro_i32(void * data, unsigned int n, void * tmp) {
+  (void)tmp;
+  sort_array_i32((int32_t *)data, n);
+}
+
+static void wide_radix_u32(void * data, unsigned int n, void * tmp) {
+  radix_sort_u32((uint32_t *)data, n, (uint32_t *)tmp);
+}
+
+#if defined (HOST)
+static void wide_radix_u16_mt(void * data, unsigned int n, void * tmp) {
+  radix_sort_u16_mt((uint16_t *)data, n, (uint16_t *)tmp);
+}
+
+static void wide_radix_u32_mt(void * data, unsigned int n, void * tmp) {
+  radix_sort_u32_mt((uint32_t *)data, n, (uint32_t *)tmp);
+}
+#endif
+
+/**
+ * @brief Time calls sorts of fresh copies of n samples of width bytes
+ */
+static void bench_sort_wide(const char * name,
+                            void (*sort)(void *, unsigned int, void *),
+                            const void * in, void * out, void * tmp,
+                            unsigned int n, size_t width, uint32_t calls) {
+  uint64_t t0 = bench_ticks();
+
+  for (uint32_t c = 0; c < calls; c++) {
+    my_memcopy((uint8_t *)in, (uint8_t *)out, n * width);
+    sort(out, n, tmp);
+  }
+  bench_report(name, n * width, calls, bench_ticks() - t0);
+  bench_sink = *(const uint8_t *)out;
+}
+
+void bench_radix(void) {
+  static const unsigned int sizes[] = {256, 1024,
+#if defined (HOST)
+                                       1u << 16, 1u << 20, 1u << 22
+#endif
+                                      };
+  unsigned int max_n = sizes[sizeof(sizes) / sizeof(sizes[0]) - 1];
+  uint16_t * u16 = (uint16_t *) malloc(max_n * sizeof(uint16_t));
+  uint32_t * u32 = (uint32_t *) malloc(max_n * sizeof(uint32_t));
+  uint32_t * out = (uint32_t *) malloc(max_n * sizeof(uint32_t));
+  uint32_t * tmp = (uint32_t *) malloc(max_n * sizeof(uint32_t));
+  uint32_t seed = 53;
+
+  PRINTF("\nbench_radix() - 14-bit u16 and random u32 samples, "
+         "times include a copy of the input\n");
+  if (!u16 || !u32 || !out || !tmp) {
+    free(u16);
+    free(u32);
+    free(out);
+    free(tmp);
+    return;
+  }
+  for (unsigned int i = 0; i < max_n; i++) {
+    seed = seed * 1103515245u + 12345u;
+    u16[i] = (uint16_t)(seed >> 12) & 0x3FFF;
+    u32[i] = seed ^ (seed << 13);
+  }
+
+  for (size_t k = 0; k < sizeof(sizes) / sizeof(sizes[0]); k++) {
+    unsigned int n = sizes[k];
+    uint32_t calls = (uint32_t)(BENCH_WORK_BYTES / 4 / n);
+    /* Introsort is O(n log n): fewer rounds on large arrays */
+    uint32_t intro_calls = n > 4096 ? calls / 8 : calls;
+
+    if (calls == 0) calls = 1;
+    if (intro_calls == 0) intro_calls = 1;
+    bench_sort_wide("sort_array_u16", wide_intro_u16, u16, out, tmp, n,
+                    sizeof(uint16_t), intro_calls);
+    bench_sort_wide("radix_sort_u16", wide_radix_u16, u16, out, tmp, n,
+                    sizeof(uint16_t), calls);
+#if defined (HOST)
+    bench_sort_wide("radix_sort_u16_mt", wide_radix_u16_mt, u16, out, tmp, n,
+                    sizeof(uint16_t), calls);
+#endif
+    bench_sort_wide("sort_array_i32", wide_intro_i32, u32, out, tmp, n,
+                    sizeof(uint32_t), intro_calls);
+    bench_sort_wide("radix_sort_u32", wide_radix_u32, u32, out, tmp, n,
+                    sizeof(uint32_t), calls);
+#if defined (HOST)
+    bench_sort_wide("radix_sort_u32_mt", wide_radix_u32_mt, u32, out, tmp, n,
+                    sizeof(uint32_t), calls);
+#endif
+  }
+
+  free(u16);
+  free(u32);
+  free(out);
+  free(tmp);
+}
+
+#if defined (HOST)
+void bench_stats_parallel(void) {
+  enum { BYTES = 64 << 20 };
+  long cpus = sysconf(_SC_NPROCESSORS_ONLN);
+  uint32_t max_threads = (uint32_t)(cpus > 4 ? (cpus < 64 ? cpus : 64) : 4);
+  uint8_t * in = (uint8_t *) malloc(BYTES);
+  stats_result_t * result = (stats_result_t *) malloc(sizeof(*result));
+  uint32_t seed = 53;
+  uint64_t acc = 0;
+
+  PRINTF("\nbench_stats_parallel() - %u CPUs, compute_statistics of 64 MiB\n",
+         (unsigned)cpus);
+  if (!in || !result) {
+    free(in);
+    free(result);
+    return;
+  }
+  for (size_t i = 0; i < BYTES; i++) {
+    seed = seed * 1103515245u + 12345u;
+    in[i] = (uint8_t)(seed >> 16);
+  }
+
+  for (uint32_t n = 1; n <= max_threads; n *= 2) {
+    char name[32];
+    uint64_t t0;
+
+    tpool_init(n);
+    compute_statistics(in, BYTES, result);     /* Warm up the workers */
+    t0 = bench_ticks();
+    for (uint32_t c = 0; c < 4; c++) {
+      compute_statistics(in, BYTES, result);
+      acc += result->median;
+    }
+    snprintf(name, sizeof(name), "compute_statistics x%u", (unsigned)n);
+    bench_report(name, BYTES, 4, bench_ticks() - t0);
+  }
+  tpool_shutdown();
+  bench_sink = (uint8_t)acc;
+
+  free(in);
+  free(result);
+}
+
+void bench_sort_parallel(void) {
+  enum { COUNT = 16 << 20 };
+  long cpus = sysconf(_SC_NPROCESSORS_ONLN);
+  uint32_t max_threads = (uint32_t)(cpus > 4 ? (cpus < 64 ? cpus : 64) : 4);
+  int32_t * in = (int32_t *) malloc(COUNT * sizeof(int32_t));
+  int32_t * work = (int32_t *) malloc(COUNT * sizeof(int32_t));
+  uint32_t seed = 71;
+  uint64_t acc = 0;
+
+  PRINTF("\nbench_sort_parallel() - %u CPUs, sort_array of 64 MiB bytes, "
+         "sort_array_i32 of 16M samples\n", (unsigned)cpus);
+  if (!in || !work) {
+    free(in);
+    free(work);
+    return;
+  }
+  for (size_t i = 0; i < COUNT; i++) {
+    seed = seed * 1103515245u + 12345u;
+    in[i] = (int32_t)(seed ^ (seed << 13));
+  }
+
+  for (uint32_t n = 1; n <= max_threads; n *= 2) {
+    char name[32];
+    uint64_t ticks = 0, t0;
+
+    tpool_init(n);
+    for (uint32_t c = 0; c < 2; c++) {
+      my_memcopy((uint8_t *)in, (uint8_t *)work, COUNT * sizeof(int32_t));
+      t0 = bench_ticks();
+      sort_array((uint8_t *)work, COUNT * sizeof(int32_t));
+      ticks += bench_ticks() - t0;
+      acc += ((uint8_t *)work)[COUNT];
+    }
+    snprintf(name, sizeof(name), "sort_array x%u", (unsigned)n);
+    bench_report(name, COUNT * sizeof(int32_t), 2, ticks);
+
+    ticks = 0;
+    for (uint32_t c = 0; c < 2; c++) {
+      my_memcopy((uint8_t *)in, (uint8_t *)work, COUNT * sizeof(int32_t));
+      t0 = bench_ticks();
+      sort_array_i32(work, COUNT);
+      ticks += bench_ticks() - t0;
+      acc += (uint64_t)work[COUNT / 2];
+    }
+    snprintf(name, sizeof(name), "sort_array_i32 x%u", (unsigned)n);
+    bench_report(name, COUNT * sizeof(int32_t), 2, ticks);
+  }
+  tpool_shutdown();
+  bench_sink = (uint8_t)acc;
+
+  free(in);
+  free(work);
+}
+#endif
+
+#if defined (HOST)
+/* capture_stream callback: fold each window into one histogram */
+static int capture_bench_chunk(const void * samples, size_t count,
+                               void * ctx) {
+  stats_result_t * total = (stats_result_t *)ctx;
+  stats_result_t window;
+
+  compute_statistics((unsigned char *)samples, (unsigned int)count, &window);
+  for (unsigned int v = 0; v < 256; v++) {
+    total->histogram[v] += window.histogram[v];
+  }
+  total->sum += window.sum;
+  return 0;
+}
+
+void bench_capture(void) {
+  enum { BYTES = 64 << 20 };
+  char path[] = "/tmp/c1m4_benchXXXXXX";
+  uint8_t * buf = (uint8_t *) malloc(BYTES);
+  stats_result_t * result = (stats_result_t *) malloc(sizeof(*result));
+  capture_t cap;
+  uint32_t seed = 59;
+  uint64_t acc = 0, t0;
+  int fd;
+
+  PRINTF("\nbench_capture() - compute_statistics of a 64 MiB capture file "
+         "(page cache warm)\n");
+  fd = mkstemp(path);
+  if (!buf || !result || fd < 0) {
+    if (fd >= 0) {
+      close(fd);
+      unlink(path);
+    }
+    free(buf);
+    free(result);
+    return;
+  }
+  for (size_t i = 0; i < BYTES; i++) {
+    seed = seed * 1103515245u + 12345u;
+    buf[i] = (uint8_t)(seed >> 16);
+  }
+  if (write(fd, buf, BYTES) != BYTES) {
+    PRINTF("  cannot write %s\n", path);
+  }
+  close(fd);
+
+  /* The old way: read the file into a buffer, then compute */
+  t0 = bench_ticks();
+  fd = open(path, O_RDONLY);
+  if (fd >= 0) {
+    size_t done = 0;
+    ssize_t got;
+    while (done < BYTES && (got = read(fd, buf + done, BYTES - done)) > 0) {
+      done += (size_t)got;
+    }
+    close(fd);
+    compute_statistics(buf, (unsigned int)done, result);
+    acc += result->median;
+  }
+  bench_report("read() + compute", BYTES, 1, bench_ticks() - t0);
+
+  t0 = bench_ticks();
+  if (capture_open(&cap, path, CAPTURE_U8, CAPTURE_READ_ONLY) == 0) {
+    compute_statistics(capture_u8(&cap), (unsigned int)cap.count, result);
+    acc += result->median;
+    capture_close(&cap);
+  }
+  bench_report("capture_open + compute", BYTES, 1, bench_ticks() - t0);
+
+  /* Streaming drops each window from the page cache, so it runs last */
+  my_memzero((uint8_t *)result, sizeof(*result));
+  t0 = bench_ticks();
+  capture_stream(path, CAPTURE_U8, 8 << 20, capture_bench_chunk, result);
+  bench_report("capture_stream + compute", BYTES, 1, bench_ticks() - t0);
+  acc += result->sum;
+
+  bench_sink = (uint8_t)acc;
+  unlink(path);
+  free(buf);
+  free(result);
+}
+
+void bench_extsort(void) {
+  enum { BYTES = 64 << 20 };
+  static const struct {
+    const char * name;
+    capture_format_t format;
+    size_t memory;
+  } cases[] = {
+    { "extsort u8, 8 MiB",           CAPTURE_U8,  8 << 20 },
+    { "extsort u16, 8 MiB (16 runs)", CAPTURE_U16, 8 << 20 },
+    { "extsort i32, 8 MiB (16 runs)", CAPTURE_I32, 8 << 20 },
+    { "extsort i32, in memory",      CAPTURE_I32, 0 },
+  };
+  char path[] = "/tmp/c1m4_benchXXXXXX";
+  char out_path[] = "/tmp/c1m4_benchXXXXXX";
+  uint8_t * buf = (uint8_t *) malloc(BYTES);
+  extsort_stats_t stats;
+  uint32_t seed = 61;
+  uint64_t t0;
+  int fd = mkstemp(path);
+  int out = mkstemp(out_path);
+
+  PRINTF("\nbench_extsort() - sort a 64 MiB capture file into another "
+         "(page cache warm), per phase\n");
+  if (out >= 0) {
+    close(out);
+  }
+  if (!buf || fd < 0 || out < 0) {
+    if (fd >= 0) {
+      close(fd);
+      unlink(path);
+    }
+    if (out >= 0) {
+      unlink(out_path);
+    }
+    free(buf);
+    return;
+  }
+  for (size_t i = 0; i < BYTES; i++) {
+    seed = seed * 1103515245u + 12345u;
+    buf[i] = (uint8_t)(seed >> 16);
+  }
+  if (write(fd, buf, BYTES) != BYTES) {
+    PRINTF("  cannot write %s\n", path);
+  }
+  close(fd);
+  free(buf);
+
+  for (size_t c = 0; c < sizeof(cases) / sizeof(cases[0]); c++) {
+    t0 = bench_ticks();
+    if (extsort_file(path, out_path, cases[c].format, cases[c].memory,
+                     NULL, &stats) != 0) {
+      PRINTF("  %s failed\n", cases[c].name);
+      continue;
+    }
+    bench_report(cases[c].name, BYTES, 1, bench_ticks() - t0);
+    print_extsort_stats(&stats);
+  }
+
+  unlink(path);
+  unlink(out_path);
+}
+#endif
+
+void bench(void) {
+  PRINTF("Benchmarks (%s per call, throughput in %s)\n",
+         BENCH_TICK_UNIT, BENCH_RATE_UNIT);
+  bench_memcopy();
+  bench_memmove();
+  bench_memset();
+  bench_reverse();
+  bench_pool();
+  bench_arena();
+  bench_tlsf();
+#if defined (HOST)
+  bench_mtpool();
+#endif
+  bench_dma();
+  bench_bits();
+  bench_sort();
+  bench_sort_network();
+  bench_median();
+  bench_statistics();
+  bench_stats_kernels();
+  bench_stats_stream();
+  bench_stats_typed();
+  bench_variance();
+  bench_top_k();
+  bench_radix();
+#if defined (HOST)
+  bench_stats_parallel();
+  bench_sort_parallel();
+  bench_capture();
+  bench_extsort();
+#endif
+}
@@ -0,0 +1,172 @@
+/*****************************************************************************
+ * @file capture.c
+ * @brief Implementation of the memory-mapped capture loader (HOST)
+ *
+ * capture_open maps the file once with MAP_PRIVATE, read only or
+ * copy-on-write. capture_stream maps fixed windows at page-aligned file
+ * offsets and unmaps each one before mapping the next.
+ *
+ * This code was written as part of the Introduction to Embedded Systems
+ * Software and Development Environments course (University of Colorado Boulder).
+ *
+ * @author Timofei Alekseenko
+ * @date October 17, 2026
+ *
+ *****************************************************************************/
+
+#define _DEFAULT_SOURCE   /* madvise, MADV_HUGEPAGE, posix_fadvise */
+
+#include "capture.h"
+#include <stdint.h>
+#include <stddef.h>
+#include <limits.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+/**
+ * @brief Hint sequential access, and huge pages where supported
+ */
+static void capture_advise(void * map, size_t length) {
+  madvise(map, length, MADV_SEQUENTIAL);
+#if defined (MADV_HUGEPAGE)
+  madvise(map, length, MADV_HUGEPAGE);    /* Ignored by most filesystems */
+#endif
+}
+
+/**
+ * @brief Open path and return its size in whole samples of sample bytes
+ * @return File descriptor, or -1
+ */
+static int capture_open_fd(const char * path, size_t sample, size_t * bytes) {
+  struct stat st;
+  int fd;
+
+  if (sample == 0) {
+    return -1;
+  }
+  fd = open(path, O_RDONLY);
+  if (fd < 0) {
+    return -1;
+  }
+  if (fstat(fd, &st) != 0 || st.st_size < 0) {
+    close(fd);
+    return -1;
+  }
+  *bytes = (size_t)st.st_size - (size_t)st.st_size % sample;
+  return fd;
+}
+
+size_t capture_sample_bytes(capture_format_t format) {
+  switch (format) {
+    case CAPTURE_U8:  return 1;
+    case CAPTURE_U16: return 2;
+    case CAPTURE_I32: return 4;
+    default:          return 0;
+  }
+}
+
+int8_t capture_open(capture_t * cap, const char * path,
+                    capture_format_t format, uint8_t flags) {
+  size_t sample = capture_sample_bytes(format);
+  size_t bytes;
+  int fd = capture_open_fd(path, sample, &bytes);
+
+  if (fd < 0) {
+    return -1;
+  }
+  /* The stats and sort APIs take unsigned int sizes */
+  if (bytes / sample > UINT_MAX) {
+    close(fd);
+    return -1;
+  }
+  cap->data = NULL;
+  cap->count = 0;
+  cap->map_bytes = 0;
+  cap->format = format;
+
+  /* mmap rejects zero lengths: an empty capture is a valid empty view */
+  if (bytes > 0) {
+    int prot = PROT_READ | ((flags & CAPTURE_WRITABLE) ? PROT_WRITE : 0);
+    void * map = mmap(NULL, bytes, prot, MAP_PRIVATE, fd, 0);
+
+    if (map == MAP_FAILED) {
+      close(fd);
+      return -1;
+    }
+    capture_advise(map, bytes);
+    cap->data = map;
+    cap->count = bytes / sample;
+    cap->map_bytes = bytes;
+  }
+  /* The mapping keeps the file referenced */
+  close(fd);
+  return 0;
+}
+
+void capture_close(capture_t * cap) {
+  if (cap->data != NULL) {
+    munmap(cap->data, cap->map_bytes);
+  }
+  cap->data = NULL;
+  cap->count = 0;
+  cap->map_bytes = 0;
+}
+
+uint8_t * capture_u8(const capture_t * cap) {
+  return cap->format == CAPTURE_U8 ? (uint8_t *)cap->data : NULL;
+}
+
+uint16_t * capture_u16(const capture_t * cap) {
+  return cap->format == CAPTURE_U16 ? (uint16_t *)cap->data : NULL;
+}
+
+int32_t * capture_i32(const capture_t * cap) {
+  return cap->format == CAPTURE_I32 ? (int32_t *)cap->data : NULL;
+}
+
+int8_t capture_stream(const char * path, capture_format_t format,
+                      size_t chunk_bytes, capture_chunk_fn fn, void * ctx) {
+  size_t sample = capture_sample_bytes(format);
+  size_t page = (size_t)sysconf(_SC_PAGESIZE);
+  size_t bytes, offset;
+  int fd = capture_open_fd(path, sample, &bytes);
+
+  if (fd < 0) {
+    return -1;
+  }
+  /* Whole pages for mmap offsets; pages also hold whole samples */
+  if (chunk_bytes == 0) {
+    chunk_bytes = CAPTURE_CHUNK_BYTES;
+  }
+  chunk_bytes = (chunk_bytes + page - 1) / page * page;
+
+  for (offset = 0; offset < bytes; offset += chunk_bytes) {
+    size_t length = bytes - offset < chunk_bytes ? bytes - offset
+                                                 : chunk_bytes;
+    void * map = mmap(NULL, length, PROT_READ, MAP_PRIVATE, fd,
+                      (off_t)offset);
+    int stop;
+
+    if (map == MAP_FAILED) {
+      close(fd);
+      return -1;
+    }
+    capture_advise(map, length);
+    if (offset + length < bytes) {
+      posix_fadvise(fd, (off_t)(offset + length), (off_t)chunk_bytes,
+                    POSIX_FADV_WILLNEED);
+    }
+
+    stop = fn(map, length / sample, ctx);
+
+    munmap(map, length);
+    posix_fadvise(fd, (off_t)offset, (off_t)length, POSIX_FADV_DONTNEED);
+    if (stop) {
+      break;
+    }
+  }
+  close(fd);
+  return 0;
+}
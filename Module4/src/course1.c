@@ -17,12 +17,35 @@
  *
  */
 
+#if defined (HOST)
+#define _POSIX_C_SOURCE 200809L   /* pthreads for test_mtpool */
+#endif
+
 #include <stdint.h>
 #include "course1.h"
 #include "platform.h"
 #include "memory.h"
 #include "data.h"
 #include "stats.h"
+#include "stats_typed.h"
+#include "radix.h"
+#include "pool.h"
+#include "arena.h"
+#include "tlsf.h"
+#include "dma.h"
+
+#if defined (HOST)
+#include <pthread.h>
+#include "mtpool.h"
+#include "tpool.h"
+#include "capture.h"
+#include "extsort.h"
+#include <stdlib.h>
+#include <string.h>
+#include <limits.h>
+#include <fcntl.h>
+#include <unistd.h>
+#endif
 
 int8_t test_data1() {
   uint8_t * ptr;
@@ -239,6 +262,106 @@ int8_t test_memcopy() {
   return ret;
 }
 
+int8_t test_memmove_bulk() {
+  uint16_t i;
+  uint8_t l, so, d;
+  int8_t ret = TEST_NO_ERROR;
+  uint8_t * set;
+  const uint8_t lengths[] = {1, 15, 16, 17, 63, 64, 65, 100, 127, 128, 129,
+                             200};
+  const int8_t deltas[] = {-40, -9, -8, -5, -4, -3, -1, 0,
+                           1, 3, 4, 5, 8, 9, 40};
+
+  PRINTF("test_memmove_bulk() - OVERLAP BOTH DIRECTIONS\n");
+  set = (uint8_t*) reserve_words(MEM_BULK_SIZE_W);
+
+  if (! set )
+  {
+    return TEST_ERROR;
+  }
+
+  for (l = 0; l < sizeof(lengths); l++)
+  {
+    for (so = 48; so < 56; so++)
+    {
+      for (d = 0; d < sizeof(deltas); d++)
+      {
+        uint8_t dof = (uint8_t)(so + deltas[d]);
+
+        for (i = 0; i < MEM_BULK_SIZE_B; i++)
+        {
+          set[i] = (uint8_t) i;
+        }
+
+        my_memmove(&set[so], &set[dof], lengths[l]);
+
+        for (i = 0; i < MEM_BULK_SIZE_B; i++)
+        {
+          uint8_t expect = (i >= dof && i < dof + lengths[l]) ?
+                           (uint8_t)(so + i - dof) : (uint8_t) i;
+          if (set[i] != expect)
+          {
+            ret = TEST_ERROR;
+          }
+        }
+      }
+    }
+  }
+
+  free_words( (int32_t*)set );
+  return ret;
+}
+
+int8_t test_memcopy_bulk() {
+  uint16_t i;
+  uint8_t l, so, dof;
+  int8_t ret = TEST_NO_ERROR;
+  uint8_t * set;
+  uint8_t * dst;
+  const uint8_t lengths[] = {0, 1, 3, 15, 16, 17, 31, 63, 64, 65, 100, 120,
+                             128, 129, 200};
+
+  PRINTF("test_memcopy_bulk() - SIZES AND ALIGNMENTS\n");
+  set = (uint8_t*) reserve_words(MEM_BULK_SIZE_W);
+
+  if (! set )
+  {
+    return TEST_ERROR;
+  }
+  dst = &set[MEM_BULK_SIZE_B / 2];
+
+  for (l = 0; l < sizeof(lengths); l++)
+  {
+    for (so = 0; so < 8; so++)
+    {
+      for (dof = 0; dof < 8; dof++)
+      {
+        /* Source half counts up, destination half holds a marker */
+        for (i = 0; i < MEM_BULK_SIZE_B / 2; i++)
+        {
+          set[i] = (uint8_t) i;
+          dst[i] = 0xA5;
+        }
+
+        my_memcopy(&set[so], &dst[dof], lengths[l]);
+
+        for (i = 0; i < MEM_BULK_SIZE_B / 2; i++)
+        {
+          uint8_t expect = (i >= dof && i < dof + lengths[l]) ?
+                           (uint8_t)(so + i - dof) : 0xA5;
+          if (dst[i] != expect)
+          {
+            ret = TEST_ERROR;
+          }
+        }
+      }
+    }
+  }
+
+  free_words( (int32_t*)set );
+  return ret;
+}
+
 int8_t test_memset() 
 {
   uint8_t i;
@@ -285,6 +408,112 @@ int8_t test_memset()
   return ret;
 }
 
+int8_t test_memset_bulk()
+{
+  uint16_t i;
+  uint8_t l, off;
+  int8_t ret = TEST_NO_ERROR;
+  uint8_t * set;
+  uint16_t * set16;
+  uint32_t * set32;
+  const uint8_t lengths[] = {0, 1, 3, 15, 16, 17, 63, 64, 65, 100, 127};
+
+  PRINTF("test_memset_bulk()\n");
+  set = (uint8_t*)reserve_words(MEM_BULK_SIZE_W);
+  if (! set )
+  {
+    return TEST_ERROR;
+  }
+
+  for (l = 0; l < sizeof(lengths); l++)
+  {
+    for (off = 0; off < 8; off++)
+    {
+      my_memset(set, MEM_BULK_SIZE_B, 0xA5);
+      my_memset(&set[off], lengths[l], 0x3C);
+      for (i = 0; i < MEM_BULK_SIZE_B; i++)
+      {
+        uint8_t expect = (i >= off && i < off + lengths[l]) ? 0x3C : 0xA5;
+        if (set[i] != expect)
+        {
+          ret = TEST_ERROR;
+        }
+      }
+
+      /* Typed fills; elements outside the range must keep the marker */
+      set16 = (uint16_t*)set;
+      my_memset(set, MEM_BULK_SIZE_B, 0xA5);
+      my_memset16(&set16[off], lengths[l] / 2, 0xBEEF);
+      for (i = 0; i < MEM_BULK_SIZE_B / 2; i++)
+      {
+        uint16_t expect = (i >= off && i < off + lengths[l] / 2) ?
+                          0xBEEF : 0xA5A5;
+        if (set16[i] != expect)
+        {
+          ret = TEST_ERROR;
+        }
+      }
+
+      set32 = (uint32_t*)set;
+      my_memset(set, MEM_BULK_SIZE_B, 0xA5);
+      my_memset32(&set32[off], lengths[l] / 4, 0x12345678);
+      for (i = 0; i < MEM_BULK_SIZE_B / 4; i++)
+      {
+        uint32_t expect = (i >= off && i < off + lengths[l] / 4) ?
+                          0x12345678 : 0xA5A5A5A5;
+        if (set32[i] != expect)
+        {
+          ret = TEST_ERROR;
+        }
+      }
+    }
+  }
+
+  /* Small streaming fill falls back to the cached path */
+  my_memset_stream(&set[1], MEM_BULK_SIZE_B - 2, 0x5A);
+  my_memzero_stream(&set[3], MEM_BULK_SIZE_B - 6);
+  for (i = 1; i < MEM_BULK_SIZE_B - 1; i++)
+  {
+    if (set[i] != ((i < 3 || i >= MEM_BULK_SIZE_B - 3) ? 0x5A : 0))
+    {
+      ret = TEST_ERROR;
+    }
+  }
+  free_words( (int32_t*)set );
+
+#if defined (HOST)
+  /* Large fill takes the non-temporal path */
+  {
+    size_t n;
+    size_t big = MEM_STREAM_THRESHOLD + 77;
+    uint8_t * buf = (uint8_t*)reserve_words(big / sizeof(int32_t) + 1);
+
+    if (! buf )
+    {
+      return TEST_ERROR;
+    }
+    buf[0] = 0x11;
+    buf[big - 1] = 0x22;
+    my_memset_stream(&buf[1], big - 2, 0xC3);
+    for (n = 1; n < big - 1; n++)
+    {
+      if (buf[n] != 0xC3)
+      {
+        ret = TEST_ERROR;
+        break;
+      }
+    }
+    if (buf[0] != 0x11 || buf[big - 1] != 0x22)
+    {
+      ret = TEST_ERROR;
+    }
+    free_words( (int32_t*)buf );
+  }
+#endif
+
+  return ret;
+}
+
 int8_t test_reverse()
 {
   uint8_t i;
@@ -321,6 +550,2099 @@ int8_t test_reverse()
   return ret;
 }
 
+int8_t test_reverse_bulk()
+{
+  uint16_t i;
+  uint8_t len, off;
+  int8_t ret = TEST_NO_ERROR;
+  uint8_t * set;
+  uint16_t * set16;
+  uint32_t * set32;
+
+  PRINTF("test_reverse_bulk()\n");
+  set = (uint8_t*)reserve_words(MEM_BULK_SIZE_W);
+  if (! set )
+  {
+    return TEST_ERROR;
+  }
+  set16 = (uint16_t*)set;
+  set32 = (uint32_t*)set;
+
+  for (len = 0; len <= 70; len++)
+  {
+    for (off = 0; off < 4; off++)
+    {
+      for (i = 0; i < MEM_BULK_SIZE_B; i++)
+      {
+        set[i] = (uint8_t) i;
+      }
+      my_reverse(&set[off], len);
+      for (i = 0; i < MEM_BULK_SIZE_B; i++)
+      {
+        uint8_t expect = (i >= off && i < off + len) ?
+                         (uint8_t)(2 * off + len - 1 - i) : (uint8_t) i;
+        if (set[i] != expect)
+        {
+          ret = TEST_ERROR;
+        }
+      }
+
+      for (i = 0; i < MEM_BULK_SIZE_B / 2; i++)
+      {
+        set16[i] = i;
+      }
+      my_reverse16(&set16[off], len);
+      for (i = 0; i < MEM_BULK_SIZE_B / 2; i++)
+      {
+        uint16_t expect = (i >= off && i < off + len) ?
+                          (uint16_t)(2 * off + len - 1 - i) : i;
+        if (set16[i] != expect)
+        {
+          ret = TEST_ERROR;
+        }
+      }
+
+      if (off + len <= MEM_BULK_SIZE_W)
+      {
+        for (i = 0; i < MEM_BULK_SIZE_W; i++)
+        {
+          set32[i] = 0x10000u * i + i;
+        }
+        my_reverse32(&set32[off], len);
+        for (i = 0; i < MEM_BULK_SIZE_W; i++)
+        {
+          uint32_t j = (i >= off && i < off + len) ? 2u * off + len - 1 - i : i;
+          if (set32[i] != 0x10000u * j + j)
+          {
+            ret = TEST_ERROR;
+          }
+        }
+      }
+    }
+  }
+
+  free_words( (int32_t*)set );
+  return ret;
+}
+
+int8_t test_pool()
+{
+  uint16_t i;
+  int8_t ret = TEST_NO_ERROR;
+  int32_t * blocks[POOL_BLOCK_COUNT];
+  int32_t * extra;
+  int32_t * big;
+  pool_stats_t before;
+  pool_stats_t after;
+
+  PRINTF("test_pool()\n");
+  pool_get_stats(&before);
+
+  /* Drain whatever is left of the pool */
+  for (i = 0; i < POOL_BLOCK_COUNT - before.in_use; i++)
+  {
+    blocks[i] = reserve_words(POOL_BLOCK_WORDS);
+    if (! blocks[i] || ! pool_owns(blocks[i]))
+    {
+      ret = TEST_ERROR;
+    }
+    my_memset32((uint32_t*)blocks[i], POOL_BLOCK_WORDS, i);
+  }
+
+  /* Exhausted and oversized requests come from the heap */
+  extra = reserve_words(1);
+  big = reserve_words(POOL_BLOCK_WORDS + 1);
+  if (! extra || ! big || pool_owns(extra) || pool_owns(big))
+  {
+    ret = TEST_ERROR;
+  }
+  free_words(extra);
+  free_words(big);
+
+  /* Blocks do not overlap */
+  for (i = 0; i < POOL_BLOCK_COUNT - before.in_use; i++)
+  {
+    if (blocks[i][0] != i || blocks[i][POOL_BLOCK_WORDS - 1] != i)
+    {
+      ret = TEST_ERROR;
+    }
+  }
+
+  pool_get_stats(&after);
+  if (after.in_use != POOL_BLOCK_COUNT || after.high_water != POOL_BLOCK_COUNT ||
+      after.misses < before.misses + 2)
+  {
+    ret = TEST_ERROR;
+  }
+
+  /* The most recently freed block is handed out next */
+  free_words(blocks[0]);
+  extra = reserve_words(POOL_BLOCK_WORDS);
+  if (extra != blocks[0])
+  {
+    ret = TEST_ERROR;
+  }
+
+  for (i = 0; i < POOL_BLOCK_COUNT - before.in_use; i++)
+  {
+    free_words(blocks[i]);
+  }
+  pool_get_stats(&after);
+  if (after.in_use != before.in_use)
+  {
+    ret = TEST_ERROR;
+  }
+  return ret;
+}
+
+int8_t test_arena()
+{
+  int8_t ret = TEST_NO_ERROR;
+  uint8_t backing[ARENA_SIZE_B];
+  arena_t arena;
+  arena_mark_t mark;
+  uint8_t * a;
+  uint8_t * b;
+  int32_t * w;
+  uint8_t * c;
+
+  PRINTF("test_arena()\n");
+  arena_init(&arena, &backing[1], ARENA_SIZE_B - 1);
+
+  /* Byte, word and 16-byte aligned scratch buffers */
+  a = (uint8_t*)arena_alloc(&arena, 3, 1);
+  w = arena_reserve_words(&arena, MEM_SET_SIZE_W);
+  b = (uint8_t*)arena_alloc(&arena, 5, 16);
+  if (! a || ! w || ! b ||
+      ((uintptr_t)w & 3) != 0 || ((uintptr_t)b & 15) != 0 ||
+      (uint8_t*)w < a + 3 || b < (uint8_t*)(w + MEM_SET_SIZE_W))
+  {
+    return TEST_ERROR;
+  }
+  my_memset(a, 3, 0xAA);
+  my_memset32((uint32_t*)w, MEM_SET_SIZE_W, 0x55555555);
+  my_memset(b, 5, 0xCC);
+  if (a[2] != 0xAA || w[0] != 0x55555555 || b[0] != 0xCC)
+  {
+    ret = TEST_ERROR;
+  }
+
+  /* A batch released in one step; the next allocation reuses the space */
+  mark = arena_mark(&arena);
+  c = (uint8_t*)arena_alloc(&arena, 64, 0);
+  if (! c || arena_alloc(&arena, ARENA_SIZE_B, 0) != NULL)
+  {
+    ret = TEST_ERROR;
+  }
+  arena_reset(&arena, mark);
+  if (arena_mark(&arena) != mark || arena_alloc(&arena, 64, 0) != c)
+  {
+    ret = TEST_ERROR;
+  }
+  if (arena.high_water < mark + 64)
+  {
+    ret = TEST_ERROR;
+  }
+
+  arena_reset(&arena, 0);
+  if (arena_alloc(&arena, ARENA_SIZE_B - 1, 1) != &backing[1])
+  {
+    ret = TEST_ERROR;
+  }
+  return ret;
+}
+
+int8_t test_tlsf()
+{
+  uint8_t i;
+  uint16_t j;
+  int8_t ret = TEST_NO_ERROR;
+  const uint16_t sizes[] = {1, 24, 100, 200, 7, 333, 64, 129};
+  uint8_t * bufs[sizeof(sizes) / sizeof(sizes[0])];
+  int32_t * words;
+  tlsf_stats_t before;
+  tlsf_stats_t stats;
+
+  PRINTF("test_tlsf()\n");
+  tlsf_get_stats(&before);
+
+  for (i = 0; i < sizeof(bufs) / sizeof(bufs[0]); i++)
+  {
+    bufs[i] = (uint8_t*)tlsf_alloc(sizes[i]);
+    if (! bufs[i] || ((uintptr_t)bufs[i] & 7) != 0)
+    {
+      return TEST_ERROR;
+    }
+    my_memset(bufs[i], sizes[i], i + 1);
+  }
+
+  /* Free every other buffer, then refill the holes */
+  for (i = 0; i < sizeof(bufs) / sizeof(bufs[0]); i += 2)
+  {
+    tlsf_free(bufs[i]);
+  }
+  tlsf_get_stats(&stats);
+  if (stats.free_blocks < 2 || stats.fragmentation_pct == 0)
+  {
+    ret = TEST_ERROR;
+  }
+  for (i = 0; i < sizeof(bufs) / sizeof(bufs[0]); i += 2)
+  {
+    bufs[i] = (uint8_t*)tlsf_alloc(sizes[i]);
+    if (! bufs[i] )
+    {
+      return TEST_ERROR;
+    }
+    my_memset(bufs[i], sizes[i], i + 1);
+  }
+
+  /* No buffer was overwritten by another */
+  for (i = 0; i < sizeof(bufs) / sizeof(bufs[0]); i++)
+  {
+    for (j = 0; j < sizes[i]; j++)
+    {
+      if (bufs[i][j] != i + 1)
+      {
+        ret = TEST_ERROR;
+      }
+    }
+  }
+
+  words = tlsf_reserve_words(MEM_SET_SIZE_W);
+  if (! words || tlsf_alloc(before.total_bytes + 1) != NULL)
+  {
+    ret = TEST_ERROR;
+  }
+  tlsf_free_words(words);
+
+  for (i = 1; i < sizeof(bufs) / sizeof(bufs[0]); i += 2)
+  {
+    tlsf_free(bufs[i]);
+  }
+  for (i = 0; i < sizeof(bufs) / sizeof(bufs[0]); i += 2)
+  {
+    tlsf_free(bufs[i]);
+  }
+
+  /* Everything coalesced back */
+  tlsf_get_stats(&stats);
+  if (stats.used_bytes != before.used_bytes ||
+      stats.free_blocks != before.free_blocks ||
+      stats.largest_free != before.largest_free ||
+      stats.failures != before.failures + 1)
+  {
+    ret = TEST_ERROR;
+  }
+  return ret;
+}
+
+#if defined (HOST)
+/* Blocks freed by the next thread in the ring (cross-thread frees) */
+static int32_t * volatile mt_handoff[MT_TEST_THREADS];
+
+static void * mtpool_worker(void * arg)
+{
+  uintptr_t id = (uintptr_t)arg;
+  uintptr_t errors = 0;
+  uint32_t r, k;
+  int32_t * live[8];
+
+  for (r = 0; r < 20000; r++)
+  {
+    for (k = 0; k < 8; k++)
+    {
+      live[k] = mtpool_reserve_words(MTPOOL_BLOCK_WORDS);
+      live[k][0] = (int32_t)(id << 24 | r);
+      live[k][MTPOOL_BLOCK_WORDS - 1] = (int32_t)(id << 24 | k);
+    }
+    for (k = 0; k < 8; k++)
+    {
+      if (live[k][0] != (int32_t)(id << 24 | r) ||
+          live[k][MTPOOL_BLOCK_WORDS - 1] != (int32_t)(id << 24 | k))
+      {
+        errors++;
+      }
+    }
+    /* Hand one block to a neighbour, free one the previous thread left */
+    live[0] = __atomic_exchange_n(&mt_handoff[id], live[0], __ATOMIC_ACQ_REL);
+    for (k = 0; k < 8; k++)
+    {
+      if (live[k])
+      {
+        mtpool_free_words(live[k]);
+      }
+    }
+  }
+  return (void *)errors;
+}
+
+/* Consumer that only frees blocks another thread reserved */
+#define MT_CONSUMER_BLOCKS (20)
+
+static void * mtpool_consumer(void * arg)
+{
+  int32_t ** blocks = (int32_t **)arg;
+  uint32_t k;
+
+  for (k = 0; k < MT_CONSUMER_BLOCKS; k++)
+  {
+    mtpool_free_words(blocks[k]);
+  }
+  return NULL;
+}
+#endif
+
+int8_t test_mtpool()
+{
+  int8_t ret = TEST_NO_ERROR;
+
+  PRINTF("test_mtpool()\n");
+#if defined (HOST)
+  {
+    pthread_t threads[MT_TEST_THREADS];
+    mtpool_stats_t stats;
+    uintptr_t t;
+    void * errors;
+
+    for (t = 0; t < MT_TEST_THREADS; t++)
+    {
+      if (pthread_create(&threads[t], NULL, mtpool_worker, (void *)t) != 0)
+      {
+        return TEST_ERROR;
+      }
+    }
+    for (t = 0; t < MT_TEST_THREADS; t++)
+    {
+      pthread_join(threads[t], &errors);
+      if (errors)
+      {
+        ret = TEST_ERROR;
+      }
+    }
+    for (t = 0; t < MT_TEST_THREADS; t++)
+    {
+      mtpool_free_words(mt_handoff[t]);
+      mt_handoff[t] = NULL;
+    }
+    mtpool_thread_flush();
+
+    /* Exited threads gave their cached blocks back */
+    mtpool_get_stats(&stats);
+    if (stats.outstanding != 0 || stats.high_water == 0)
+    {
+      ret = TEST_ERROR;
+    }
+
+    /* A free-only thread's cache is given back when it exits, too */
+    for (t = 0; t < 3; t++)
+    {
+      int32_t * blocks[MT_CONSUMER_BLOCKS];
+      uint32_t k;
+
+      for (k = 0; k < MT_CONSUMER_BLOCKS; k++)
+      {
+        blocks[k] = mtpool_reserve_words(MTPOOL_BLOCK_WORDS);
+      }
+      if (pthread_create(&threads[0], NULL, mtpool_consumer, blocks) != 0)
+      {
+        return TEST_ERROR;
+      }
+      pthread_join(threads[0], NULL);
+      mtpool_thread_flush();
+      mtpool_get_stats(&stats);
+      if (stats.outstanding != 0)
+      {
+        ret = TEST_ERROR;
+      }
+    }
+  }
+#endif
+  return ret;
+}
+
+static volatile uint32_t dma_test_calls;
+static volatile dma_handle_t dma_test_last;
+
+static void dma_test_callback(dma_handle_t handle, void * ctx)
+{
+  dma_test_calls += (uint32_t)(uintptr_t)ctx;
+  dma_test_last = handle;
+}
+
+int8_t test_dma()
+{
+  static uint8_t src[MEM_BULK_SIZE_B];
+  static uint8_t dst[MEM_BULK_SIZE_B];
+  dma_desc_t chain[4];
+  dma_handle_t handles[DMA_MAX_TRANSFERS];
+  dma_handle_t handle;
+  uint32_t i, j;
+  int8_t ret = TEST_NO_ERROR;
+
+  PRINTF("test_dma()\n");
+
+  for (i = 0; i < MEM_BULK_SIZE_B; i++)
+  {
+    src[i] = (uint8_t)(i * 7 + 1);
+  }
+  my_memzero(dst, MEM_BULK_SIZE_B);
+
+  /* Gather three pieces (one empty) into the front of dst */
+  chain[0].src = src + 128;  chain[0].dst = dst;       chain[0].length = 64;
+  chain[1].src = src;        chain[1].dst = dst + 64;  chain[1].length = 0;
+  chain[2].src = src + 3;    chain[2].dst = dst + 64;  chain[2].length = 37;
+  chain[3].src = src + 200;  chain[3].dst = dst + 101; chain[3].length = 27;
+  for (i = 0; i < 3; i++)
+  {
+    chain[i].next = &chain[i + 1];
+  }
+  chain[3].next = NULL;
+
+  dma_test_calls = 0;
+  handle = dma_copy_async(chain, dma_test_callback, (void *)1);
+  if (handle == DMA_INVALID_HANDLE)
+  {
+    return TEST_ERROR;
+  }
+  dma_wait(handle);
+  if (dma_test_calls != 1 || dma_test_last != handle ||
+      dma_poll(handle) != DMA_STATUS_DONE)
+  {
+    ret = TEST_ERROR;
+  }
+  for (i = 0; i < 64; i++)
+  {
+    if (dst[i] != src[128 + i]) ret = TEST_ERROR;
+  }
+  for (i = 0; i < 37; i++)
+  {
+    if (dst[64 + i] != src[3 + i]) ret = TEST_ERROR;
+  }
+  for (i = 0; i < 27; i++)
+  {
+    if (dst[101 + i] != src[200 + i]) ret = TEST_ERROR;
+  }
+  for (i = 128; i < MEM_BULK_SIZE_B; i++)
+  {
+    if (dst[i] != 0) ret = TEST_ERROR;
+  }
+
+  /* Fill the queue with small copies, poll the last one to completion */
+  for (i = 0; i < DMA_MAX_TRANSFERS; i++)
+  {
+    handles[i] = dma_memcopy_async(src + i, dst + 128 + i * 16, 15 - i,
+                                   dma_test_callback, (void *)2);
+    if (handles[i] == DMA_INVALID_HANDLE)
+    {
+      return TEST_ERROR;
+    }
+  }
+  while (dma_poll(handles[DMA_MAX_TRANSFERS - 1]) == DMA_STATUS_BUSY)
+  {
+  }
+  for (i = 0; i < DMA_MAX_TRANSFERS; i++)
+  {
+    dma_wait(handles[i]);
+    for (j = 0; j < 15 - i; j++)
+    {
+      if (dst[128 + i * 16 + j] != src[i + j]) ret = TEST_ERROR;
+    }
+  }
+  if (dma_test_calls != 1 + 2 * DMA_MAX_TRANSFERS ||
+      dma_poll(DMA_INVALID_HANDLE) != DMA_STATUS_DONE)
+  {
+    ret = TEST_ERROR;
+  }
+  return ret;
+}
+
+#if defined (HOST)
+static uint8_t bit_test_shared[8];
+
+static void * bit_worker(void * arg)
+{
+  uintptr_t id = (uintptr_t)arg;
+  uint32_t r, b;
+
+  /* Threads own interleaved bits of the same bytes */
+  for (r = 0; r < 2000; r++)
+  {
+    for (b = (uint32_t)id; b < 64; b += MT_TEST_THREADS)
+    {
+      if (r & 1) clear_bit(bit_test_shared, b); else set_bit(bit_test_shared, b);
+    }
+  }
+  for (b = (uint32_t)id; b < 64; b += MT_TEST_THREADS)
+  {
+    set_bit(bit_test_shared, b);
+  }
+  return NULL;
+}
+#endif
+
+int8_t test_bits()
+{
+  static uint8_t bits[40];
+  uint32_t offset, n, i;
+  int8_t ret = TEST_NO_ERROR;
+
+  PRINTF("test_bits()\n");
+
+  my_memzero(bits, sizeof(bits));
+  set_bit(bits, 0);
+  set_bit(bits, 9);
+  set_bit(bits, 31);
+  set_bit(bits, 200);
+  if (bits[0] != 0x01 || bits[1] != 0x02 || bits[3] != 0x80 ||
+      bits[25] != 0x01 || !test_bit(bits, 9) || test_bit(bits, 10))
+  {
+    ret = TEST_ERROR;
+  }
+  clear_bit(bits, 9);
+  if (bits[1] != 0 || toggle_bit(bits, 12) != 0 || bits[1] != 0x10 ||
+      toggle_bit(bits, 12) != 1 || bits[1] != 0)
+  {
+    ret = TEST_ERROR;
+  }
+
+  /* Bulk scans against bit-by-bit counts, at every start alignment */
+  for (i = 0; i < sizeof(bits) * 8; i++)
+  {
+    if ((i * 37) % 11 == 0) set_bit(bits, i); else clear_bit(bits, i);
+  }
+  for (offset = 0; offset < 4; offset++)
+  {
+    for (n = 0; n <= (sizeof(bits) - offset) * 8; n += 7)
+    {
+      size_t naive = 0;
+      int32_t first = -1;
+      for (i = 0; i < n; i++)
+      {
+        if (test_bit(bits + offset, i))
+        {
+          naive++;
+          if (first < 0) first = (int32_t)i;
+        }
+      }
+      if (count_bits(bits + offset, n) != naive ||
+          find_first_bit(bits + offset, n) != first)
+      {
+        ret = TEST_ERROR;
+      }
+    }
+  }
+  my_memzero(bits, sizeof(bits));
+  if (find_first_bit(bits, sizeof(bits) * 8) != -1)
+  {
+    ret = TEST_ERROR;
+  }
+  set_bit(bits, 317);
+  if (find_first_bit(bits, 317) != -1 || find_first_bit(bits, 318) != 317)
+  {
+    ret = TEST_ERROR;
+  }
+
+#if defined (HOST)
+  {
+    pthread_t threads[MT_TEST_THREADS];
+    uintptr_t t;
+
+    my_memzero(bit_test_shared, sizeof(bit_test_shared));
+    for (t = 0; t < MT_TEST_THREADS; t++)
+    {
+      if (pthread_create(&threads[t], NULL, bit_worker, (void *)t) != 0)
+      {
+        return TEST_ERROR;
+      }
+    }
+    for (t = 0; t < MT_TEST_THREADS; t++)
+    {
+      pthread_join(threads[t], NULL);
+    }
+    if (count_bits(bit_test_shared, 64) != 64)
+    {
+      ret = TEST_ERROR;
+    }
+  }
+#endif
+  return ret;
+}
+
+/* Sorted descending and a permutation of the input (same histogram) */
+static int8_t check_sorted(const uint8_t * in, const uint8_t * out,
+                           uint32_t size)
+{
+  int32_t counts[256];
+  uint32_t i;
+
+  my_memzero((uint8_t *)counts, sizeof(counts));
+  for (i = 0; i < size; i++)
+  {
+    counts[in[i]]++;
+    counts[out[i]]--;
+    if (i > 0 && out[i - 1] < out[i])
+    {
+      return TEST_ERROR;
+    }
+  }
+  for (i = 0; i < 256; i++)
+  {
+    if (counts[i] != 0)
+    {
+      return TEST_ERROR;
+    }
+  }
+  return TEST_NO_ERROR;
+}
+
+int8_t test_sort()
+{
+  static const uint32_t sizes[] = {0, 1, 2, 15, 16, 17, 40, 100, 127, 128,
+                                   300, SORT_TEST_SIZE};
+  static void (* const sorts[])(unsigned char *, unsigned int) = {
+    sort_array, sort_array_insertion, sort_array_intro, sort_array_counting
+  };
+  static uint8_t in[SORT_TEST_SIZE];
+  static uint8_t out[SORT_TEST_SIZE];
+  uint32_t seed = 1;
+  uint32_t n, p, f, i;
+  int8_t ret = TEST_NO_ERROR;
+
+  PRINTF("test_sort()\n");
+
+  for (n = 0; n < sizeof(sizes) / sizeof(sizes[0]); n++)
+  {
+    uint32_t size = sizes[n];
+    /* random, ascending, descending, constant, few values, organ pipe */
+    for (p = 0; p < 6; p++)
+    {
+      for (i = 0; i < size; i++)
+      {
+        seed = seed * 1103515245u + 12345u;
+        switch (p)
+        {
+          case 0: in[i] = (uint8_t)(seed >> 16); break;
+          case 1: in[i] = (uint8_t)i; break;
+          case 2: in[i] = (uint8_t)(255 - i); break;
+          case 3: in[i] = 42; break;
+          case 4: in[i] = (uint8_t)((seed >> 16) % 3); break;
+          default: in[i] = (uint8_t)(i < size / 2 ? i : size - i); break;
+        }
+      }
+      for (f = 0; f < sizeof(sorts) / sizeof(sorts[0]); f++)
+      {
+        my_memcopy(in, out, size);
+        sorts[f](out, size);
+        if (check_sorted(in, out, size) != TEST_NO_ERROR)
+        {
+          ret = TEST_ERROR;
+        }
+      }
+    }
+  }
+  return ret;
+}
+
+int8_t test_median()
+{
+  static const uint32_t sizes[] = {1, 2, 3, 16, 17, 40, 101, 128,
+                                   WIDE_TEST_SIZE};
+  static uint8_t in[WIDE_TEST_SIZE];
+  static uint8_t sorted[WIDE_TEST_SIZE];
+  static int32_t wide[WIDE_TEST_SIZE];
+  static int32_t wide_sorted[WIDE_TEST_SIZE];
+  static int32_t scratch[WIDE_TEST_SIZE];
+  uint32_t seed = 7;
+  uint32_t n, p, i, k;
+  int8_t ret = TEST_NO_ERROR;
+
+  PRINTF("test_median()\n");
+
+  for (n = 0; n < sizeof(sizes) / sizeof(sizes[0]); n++)
+  {
+    uint32_t size = sizes[n];
+    /* random, few values, ascending, descending */
+    for (p = 0; p < 4; p++)
+    {
+      for (i = 0; i < size; i++)
+      {
+        seed = seed * 1103515245u + 12345u;
+        switch (p)
+        {
+          case 0: wide[i] = (int32_t)seed; break;
+          case 1: wide[i] = (int32_t)((seed >> 16) % 5) - 2; break;
+          case 2: wide[i] = (int32_t)i * 3; break;
+          default: wide[i] = -(int32_t)i; break;
+        }
+        in[i] = (uint8_t)(wide[i] ^ (wide[i] >> 8));
+      }
+      my_memcopy(in, sorted, size);
+      sort_array(sorted, size);
+      my_memcopy((uint8_t *)wide, (uint8_t *)wide_sorted, size * 4);
+      for (i = 1; i < size; i++)
+      {
+        int32_t v = wide_sorted[i];
+        k = i;
+        while (k > 0 && wide_sorted[k - 1] < v)
+        {
+          wide_sorted[k] = wide_sorted[k - 1];
+          k--;
+        }
+        wide_sorted[k] = v;
+      }
+
+      if (find_median(in, size) != sorted[size / 2] ||
+          find_percentile(in, size, 50) != sorted[size / 2] ||
+          find_percentile(in, size, 0) != sorted[size - 1] ||
+          find_percentile(in, size, 100) != sorted[0] ||
+          find_kth(in, size, size + 5) != sorted[size - 1])
+      {
+        ret = TEST_ERROR;
+      }
+      for (k = 0; k < size; k += (size > 40 ? 7 : 1))
+      {
+        if (find_kth(in, size, k) != sorted[k] ||
+            find_kth_i32(wide, size, k, scratch) != wide_sorted[k])
+        {
+          ret = TEST_ERROR;
+        }
+      }
+
+      /* The byte input is untouched */
+      for (i = 0; i < size; i++)
+      {
+        if (in[i] != (uint8_t)(wide[i] ^ (wide[i] >> 8)))
+        {
+          ret = TEST_ERROR;
+        }
+      }
+    }
+  }
+
+  /* In-place selection */
+  my_memcopy((uint8_t *)wide_sorted, (uint8_t *)scratch, sizeof(scratch));
+  if (find_kth_i32(scratch, WIDE_TEST_SIZE, 10, scratch) != wide_sorted[10])
+  {
+    ret = TEST_ERROR;
+  }
+  return ret;
+}
+
+int8_t test_statistics()
+{
+  static const uint32_t sizes[] = {0, 1, 3, 40, 255, 1000};
+  static uint8_t in[SORT_TEST_SIZE];
+  stats_result_t result;
+  uint32_t seed = 3;
+  uint32_t n, i, total;
+  uint64_t sum;
+  int8_t ret = TEST_NO_ERROR;
+
+  PRINTF("test_statistics()\n");
+
+  for (n = 0; n < sizeof(sizes) / sizeof(sizes[0]); n++)
+  {
+    uint32_t size = sizes[n];
+    sum = 0;
+    for (i = 0; i < size; i++)
+    {
+      seed = seed * 1103515245u + 12345u;
+      in[i] = (uint8_t)(16 + (seed >> 16) % 200);
+      sum += in[i];
+    }
+    compute_statistics(in, size, &result);
+
+    total = 0;
+    for (i = 0; i < 256; i++)
+    {
+      total += result.histogram[i];
+    }
+    if (result.count != size || result.sum != sum || total != size)
+    {
+      ret = TEST_ERROR;
+    }
+    if (size == 0)
+    {
+      if (result.minimum || result.maximum || result.mean || result.median)
+      {
+        ret = TEST_ERROR;
+      }
+      continue;
+    }
+    if (result.minimum != find_minimum(in, size) ||
+        result.maximum != find_maximum(in, size) ||
+        result.mean != find_mean(in, size) ||
+        result.median != find_median(in, size) ||
+        result.histogram[in[0]] == 0)
+    {
+      ret = TEST_ERROR;
+    }
+  }
+  return ret;
+}
+
+int8_t test_stats_kernels()
+{
+  static uint8_t buf[SORT_TEST_SIZE + 4];
+  uint32_t seed = 11;
+  uint32_t off, size, i, plant;
+  int8_t ret = TEST_NO_ERROR;
+
+  PRINTF("test_stats_kernels()\n");
+
+  for (off = 0; off < 4; off++)
+  {
+    for (size = 1; size <= SORT_TEST_SIZE; size += (size < 80 ? 1 : 97))
+    {
+      /* Extremes planted at the head, in the middle and at the tail */
+      for (plant = 0; plant < 3; plant++)
+      {
+        uint8_t * data = buf + off;
+        uint8_t max = 0, min = 255;
+        uint64_t sum = 0;
+        uint32_t at = (plant == 0) ? 0 : (plant == 1) ? size / 2 : size - 1;
+
+        for (i = 0; i < size; i++)
+        {
+          seed = seed * 1103515245u + 12345u;
+          data[i] = (uint8_t)(20 + (seed >> 16) % 200);
+        }
+        data[at] = (uint8_t)(plant & 1 ? 1 : 254);
+        data[(at + size / 3) % size] = (uint8_t)(plant & 1 ? 255 : 0);
+        for (i = 0; i < size; i++)
+        {
+          if (data[i] > max) max = data[i];
+          if (data[i] < min) min = data[i];
+          sum += data[i];
+        }
+        if (find_maximum(data, size) != max ||
+            find_minimum(data, size) != min ||
+            find_sum(data, size) != sum ||
+            find_mean(data, size) != (uint8_t)(sum / size))
+        {
+          ret = TEST_ERROR;
+        }
+      }
+    }
+  }
+  if (find_sum(buf, 0) != 0 || find_mean(buf, 0) != 0)
+  {
+    ret = TEST_ERROR;
+  }
+  return ret;
+}
+
+int8_t test_stats_stream()
+{
+  static const uint32_t windows[] = {1, 2, 5, 40, 300};
+  static uint8_t history[SORT_TEST_SIZE];
+  static uint8_t ring[300];
+  static uint8_t copy[300];
+  stats_stream_t stream;
+  uint32_t seed = 13;
+  uint32_t w, i, n;
+  uint64_t sum, sum_sq;
+  int8_t ret = TEST_NO_ERROR;
+
+  PRINTF("test_stats_stream()\n");
+
+  for (w = 0; w < sizeof(windows) / sizeof(windows[0]); w++)
+  {
+    uint32_t size = windows[w];
+
+    stats_stream_init(&stream, ring, size);
+    if (stats_stream_median(&stream) != 0 || stats_stream_min(&stream) != 0)
+    {
+      ret = TEST_ERROR;
+    }
+    sum = 0;
+    sum_sq = 0;
+    for (n = 1; n <= SORT_TEST_SIZE; n++)
+    {
+      uint32_t fill = n < size ? n : size;
+      seed = seed * 1103515245u + 12345u;
+      /* Slow drift plus noise, so the window median moves */
+      history[n - 1] = (uint8_t)((n / 4) + ((seed >> 16) % 64));
+      stats_stream_push(&stream, history[n - 1]);
+      sum += history[n - 1];
+      sum_sq += (uint32_t)history[n - 1] * history[n - 1];
+
+      my_memcopy(history + n - fill, copy, fill);
+      if (stats_stream_median(&stream) != find_median(copy, fill))
+      {
+        ret = TEST_ERROR;
+      }
+      if (n % 97 == 0 || n == SORT_TEST_SIZE)
+      {
+        uint64_t var = (n * sum_sq - sum * sum) / ((uint64_t)n * n);
+        if (stats_stream_min(&stream) != find_minimum(history, n) ||
+            stats_stream_max(&stream) != find_maximum(history, n) ||
+            stats_stream_mean(&stream) != find_mean(history, n) ||
+            stats_stream_variance(&stream) != var)
+        {
+          ret = TEST_ERROR;
+        }
+      }
+    }
+  }
+
+  /* No window: running values only; constant input has zero variance */
+  stats_stream_init(&stream, NULL, 0);
+  for (i = 0; i < 1000; i++)
+  {
+    stats_stream_push(&stream, 77);
+  }
+  stats_stream_push_block(&stream, history, 3);
+  if (stats_stream_median(&stream) != 0 || stream.count != 1003 ||
+      stats_stream_variance(&stream) == 0)
+  {
+    ret = TEST_ERROR;
+  }
+  stats_stream_init(&stream, NULL, 0);
+  stats_stream_push_block(&stream, ring, 0);
+  for (i = 0; i < 10; i++)
+  {
+    stats_stream_push(&stream, 200);
+  }
+  if (stats_stream_variance(&stream) != 0 || stats_stream_mean(&stream) != 200)
+  {
+    ret = TEST_ERROR;
+  }
+  return ret;
+}
+
+/* Checks one typed array against scalar loops; sorted/scratch get size */
+#define CHECK_TYPED(sfx, T, SUM_T, data, sorted, scratch, size)              \
+  do                                                                        \
+  {                                                                         \
+    SUM_T ref_sum = 0, sorted_sum = 0;                                      \
+    T ref_max = (size) ? (data)[0] : 0, ref_min = ref_max;                  \
+    for (k = 0; k < (size); k++)                                            \
+    {                                                                       \
+      ref_sum += (data)[k];                                                 \
+      if ((data)[k] > ref_max) ref_max = (data)[k];                         \
+      if ((data)[k] < ref_min) ref_min = (data)[k];                         \
+      (sorted)[k] = (data)[k];                                              \
+    }                                                                       \
+    if (find_sum_##sfx(data, size) != ref_sum ||                            \
+        find_maximum_##sfx(data, size) != ref_max ||                        \
+        find_minimum_##sfx(data, size) != ref_min)                          \
+    {                                                                       \
+      ret = TEST_ERROR;                                                     \
+    }                                                                       \
+    sort_array_##sfx(sorted, size);                                         \
+    for (k = 0; k < (size); k++)                                            \
+    {                                                                       \
+      sorted_sum += (sorted)[k];                                            \
+      if (k > 0 && (sorted)[k - 1] < (sorted)[k]) ret = TEST_ERROR;         \
+    }                                                                       \
+    if (sorted_sum != ref_sum) ret = TEST_ERROR;                            \
+    for (k = 0; k < (size); k += 1 + (size) / 8)                            \
+    {                                                                       \
+      if (find_kth_##sfx(data, size, k, scratch) != (sorted)[k])            \
+      {                                                                     \
+        ret = TEST_ERROR;                                                   \
+      }                                                                     \
+    }                                                                       \
+    if ((size) > 0 &&                                                       \
+        (find_median_##sfx(data, size, scratch) != (sorted)[(size) / 2] || \
+         find_percentile_##sfx(data, size, 100, scratch) != (sorted)[0]))   \
+    {                                                                       \
+      ret = TEST_ERROR;                                                     \
+    }                                                                       \
+  } while (0)
+
+int8_t test_stats_typed()
+{
+  static const uint32_t sizes[] = {0, 1, 2, 3, 7, 8, 9, 15, 16, 17, 31, 33,
+                                   100, WIDE_TEST_SIZE};
+  /* One set of buffers shared by all types; +4 for the start offsets */
+  static union
+  {
+    uint16_t u16[WIDE_TEST_SIZE + 4];
+    int16_t i16[WIDE_TEST_SIZE + 4];
+    int32_t i32[WIDE_TEST_SIZE + 4];
+    float f32[WIDE_TEST_SIZE + 4];
+  } in, sorted, scratch;
+  uint32_t seed = 17;
+  uint32_t n, p, off, i, k;
+  int8_t ret = TEST_NO_ERROR;
+
+  PRINTF("test_stats_typed()\n");
+
+  for (n = 0; n < sizeof(sizes) / sizeof(sizes[0]); n++)
+  {
+    uint32_t size = sizes[n];
+    /* random full range, few values, ascending */
+    for (p = 0; p < 3; p++)
+    {
+      for (off = 0; off < 4; off++)
+      {
+        uint16_t *u16 = in.u16 + off;
+        int16_t *i16 = in.i16 + off;
+        int32_t *i32 = in.i32 + off;
+        float *f32 = in.f32 + off;
+
+        for (i = 0; i < size; i++)
+        {
+          seed = seed * 1103515245u + 12345u;
+          u16[i] = p == 0 ? (uint16_t)(seed >> 8) :
+                   p == 1 ? (uint16_t)(65533u + (seed >> 16) % 3) :
+                            (uint16_t)(i * 61);
+        }
+        CHECK_TYPED(u16, uint16_t, uint64_t, u16, sorted.u16, scratch.u16,
+                    size);
+
+        for (i = 0; i < size; i++)
+        {
+          seed = seed * 1103515245u + 12345u;
+          i16[i] = p == 0 ? (int16_t)(seed >> 8) :
+                   p == 1 ? (int16_t)((seed >> 16) % 3) - 1 :
+                            (int16_t)(i * 61 - 30000);
+        }
+        CHECK_TYPED(i16, int16_t, int64_t, i16, sorted.i16, scratch.i16,
+                    size);
+        if (size > 0)
+        {
+          int64_t sum = find_sum_i16(i16, size);
+          int64_t mean = find_mean_i16(i16, size);
+          if (mean * size > sum || (mean + 1) * size <= sum)
+          {
+            ret = TEST_ERROR;
+          }
+        }
+
+        for (i = 0; i < size; i++)
+        {
+          seed = seed * 1103515245u + 12345u;
+          i32[i] = p == 0 ? (int32_t)seed :
+                   p == 1 ? INT32_MAX - (int32_t)((seed >> 16) % 3) :
+                            (int32_t)i * 4000 - 2000000000;
+        }
+        CHECK_TYPED(i32, int32_t, int64_t, i32, sorted.i32, scratch.i32,
+                    size);
+        if (size > 0)
+        {
+          int64_t sum = find_sum_i32(i32, size);
+          int64_t mean = find_mean_i32(i32, size);
+          if (mean * size > sum || (mean + 1) * size <= sum)
+          {
+            ret = TEST_ERROR;
+          }
+        }
+
+        /* Quarter steps: every partial sum is exact in double */
+        for (i = 0; i < size; i++)
+        {
+          seed = seed * 1103515245u + 12345u;
+          f32[i] = p == 0 ? (float)((int32_t)seed >> 8) / 4 :
+                   p == 1 ? (float)((seed >> 16) % 3) - 1.5f :
+                            (float)i * 0.25f;
+        }
+        CHECK_TYPED(f32, float, double, f32, sorted.f32, scratch.f32, size);
+      }
+    }
+  }
+
+  /* Sums past 32 bits */
+  for (i = 0; i < WIDE_TEST_SIZE; i++)
+  {
+    in.i32[i] = INT32_MIN;
+  }
+  if (find_sum_i32(in.i32, WIDE_TEST_SIZE) !=
+        (int64_t)INT32_MIN * WIDE_TEST_SIZE ||
+      find_mean_i32(in.i32, WIDE_TEST_SIZE) != INT32_MIN)
+  {
+    ret = TEST_ERROR;
+  }
+#if defined (HOST)
+  {
+    /* Enough samples for the 16-bit lanes to need folding */
+    static uint16_t big[1u << 17];
+    for (i = 0; i < (1u << 17); i++)
+    {
+      big[i] = 65535;
+    }
+    if (find_sum_u16(big, 1u << 17) != 65535ull << 17 ||
+        find_mean_u16(big, 1u << 17) != 65535)
+    {
+      ret = TEST_ERROR;
+    }
+    for (i = 0; i < (1u << 17); i++)
+    {
+      big[i] = 0x8000;
+    }
+    if (find_sum_i16((int16_t *)big, 1u << 17) != -(32768ll << 17))
+    {
+      ret = TEST_ERROR;
+    }
+  }
+#endif
+  return ret;
+}
+#undef CHECK_TYPED
+
+int8_t test_variance()
+{
+  static const uint32_t sizes[] = {0, 1, 2, 3, 5, 16, 17, 63, 64, 65, 255,
+                                   SORT_TEST_SIZE};
+  static const uint64_t roots[] = {0, 1, 2, 3, 4, 15, 16, 17, 65535, 65536,
+                                   0xFFFFFFFFull, 0x100000000ull,
+                                   0xFFFFFFFFFFFFFFFFull};
+  static const unsigned int pcts[] = {0, 1, 25, 50, 75, 90, 99, 100, 250};
+  static uint8_t in[SORT_TEST_SIZE + 3];
+  uint32_t bins[256];
+  uint32_t ref_bins[256];
+  uint8_t out[sizeof(pcts) / sizeof(pcts[0])];
+  uint32_t seed = 23;
+  uint32_t n, p, i, k;
+  int8_t ret = TEST_NO_ERROR;
+
+  PRINTF("test_variance()\n");
+
+  /* isqrt: exact floor at the edges and on random values */
+  for (i = 0; i < sizeof(roots) / sizeof(roots[0]); i++)
+  {
+    uint64_t r = isqrt(roots[i]);
+    if (r * r > roots[i] || (r < 0xFFFFFFFFu && (r + 1) * (r + 1) <= roots[i]))
+    {
+      ret = TEST_ERROR;
+    }
+  }
+  for (i = 0; i < 2000; i++)
+  {
+    uint64_t v, r;
+    seed = seed * 1103515245u + 12345u;
+    v = ((uint64_t)seed << (i % 32)) ^ (seed >> 7);
+    r = isqrt(v);
+    if (r * r > v || (r + 1) * (r + 1) <= v)
+    {
+      ret = TEST_ERROR;
+    }
+  }
+
+  for (n = 0; n < sizeof(sizes) / sizeof(sizes[0]); n++)
+  {
+    uint32_t size = sizes[n];
+    /* random, two clusters, constant; every start offset */
+    for (p = 0; p < 3; p++)
+    {
+      uint8_t *data = in + (n + p) % 4;
+      uint64_t sum = 0, sum_sq = 0, num;
+
+      for (i = 0; i < size; i++)
+      {
+        seed = seed * 1103515245u + 12345u;
+        data[i] = p == 0 ? (uint8_t)(seed >> 16) :
+                  p == 1 ? (uint8_t)((seed >> 16) & 1 ? 250 : 3) : 42;
+        sum += data[i];
+        sum_sq += (uint32_t)data[i] * data[i];
+      }
+
+      /* n^2 * variance, exact for these sizes */
+      num = (uint64_t)size * sum_sq - sum * sum;
+      if (find_sum_squares(data, size) != sum_sq)
+      {
+        ret = TEST_ERROR;
+      }
+      if (size == 0)
+      {
+        if (find_variance(data, 0) != 0 || find_stddev_q8(data, 0) != 0)
+        {
+          ret = TEST_ERROR;
+        }
+      }
+      else
+      {
+        uint64_t sq = (uint64_t)size * size;
+        uint64_t var_q16 = (num << 16) / sq;
+        uint64_t sd = find_stddev(data, size);
+        uint64_t sd_q8 = find_stddev_q8(data, size);
+
+        if (find_variance(data, size) != num / sq ||
+            find_variance_q8(data, size) != (num << 8) / sq ||
+            sd * sd > num / sq || (sd + 1) * (sd + 1) <= num / sq ||
+            sd_q8 * sd_q8 > var_q16 || (sd_q8 + 1) * (sd_q8 + 1) <= var_q16)
+        {
+          ret = TEST_ERROR;
+        }
+      }
+
+      /* Batched percentiles match the single queries */
+      find_percentiles(data, size, pcts, sizeof(pcts) / sizeof(pcts[0]), out);
+      for (i = 0; i < sizeof(pcts) / sizeof(pcts[0]); i++)
+      {
+        if (out[i] != find_percentile(data, size, pcts[i]))
+        {
+          ret = TEST_ERROR;
+        }
+      }
+
+      /* Binned histograms against a direct count */
+      for (k = 1; k <= 256; k = k < 8 ? k + 1 : k * 2)
+      {
+        my_memzero((uint8_t *)ref_bins, sizeof(ref_bins));
+        for (i = 0; i < size; i++)
+        {
+          ref_bins[data[i] * k / 256]++;
+        }
+        find_histogram(data, size, bins, k);
+        for (i = 0; i < k; i++)
+        {
+          if (bins[i] != ref_bins[i])
+          {
+            ret = TEST_ERROR;
+          }
+        }
+      }
+    }
+  }
+#if defined (HOST)
+  {
+    /* Long enough for the wide kernels to fold their 32-bit lanes */
+    static uint8_t big[1u << 18];
+    my_memset(big, 1u << 18, 255);
+    if (find_sum_squares(big, 1u << 18) != 65025ull << 18 ||
+        find_variance(big, 1u << 18) != 0 || find_stddev_q8(big, 1u << 18) != 0)
+    {
+      ret = TEST_ERROR;
+    }
+    big[0] = 0;
+    if (find_variance_q8(big, 1u << 18) == 0)
+    {
+      ret = TEST_ERROR;
+    }
+  }
+#endif
+  return ret;
+}
+
+#if defined (HOST)
+/* tpool job: count the calls per index; odd indices start a nested job */
+typedef struct
+{
+  uint32_t hits[1000];
+  uint32_t nested;
+  unsigned char * big;                  /* For tpool_test_stats */
+  unsigned int big_size;
+  unsigned char medians[MT_TEST_THREADS];
+  uint32_t inner_threads[MT_TEST_THREADS];
+} tpool_test_job_t;
+
+static void tpool_test_inner(void * arg, uint32_t index)
+{
+  (void)index;
+  __atomic_fetch_add(&((tpool_test_job_t *)arg)->nested, 1, __ATOMIC_RELAXED);
+}
+
+static void tpool_test_task(void * arg, uint32_t index)
+{
+  tpool_test_job_t * job = (tpool_test_job_t *)arg;
+  __atomic_fetch_add(&job->hits[index], 1, __ATOMIC_RELAXED);
+  if (index % 100 == 1)
+  {
+    tpool_run(tpool_test_inner, job, 3);
+  }
+}
+
+/* Parallel-capable stats from inside a task must run serially, not wait
+   on the pool that is running them */
+static void tpool_test_stats(void * arg, uint32_t index)
+{
+  tpool_test_job_t * job = (tpool_test_job_t *)arg;
+  job->inner_threads[index] = tpool_threads();
+  job->medians[index] = find_median(job->big, job->big_size);
+}
+#endif
+
+int8_t test_stats_parallel()
+{
+  int8_t ret = TEST_NO_ERROR;
+
+  PRINTF("test_stats_parallel()\n");
+#if defined (HOST)
+  {
+    /* Just over two parallel thresholds, odd length */
+    enum { BIG = 2 * STATS_PARALLEL_MIN + 12345 };
+    static uint8_t big[BIG];
+    static tpool_test_job_t job;
+    static stats_result_t parallel, serial;
+    uint32_t seed = 29, i;
+
+    if (tpool_init(MT_TEST_THREADS) != 0 ||
+        tpool_threads() != MT_TEST_THREADS)
+    {
+      ret = TEST_ERROR;
+    }
+    my_memzero((uint8_t *)&job, sizeof(job));
+    tpool_run(tpool_test_task, &job, 1000);
+    for (i = 0; i < 1000; i++)
+    {
+      if (job.hits[i] != 1)
+      {
+        ret = TEST_ERROR;
+      }
+    }
+    if (job.nested != 30)
+    {
+      ret = TEST_ERROR;
+    }
+
+    /* Skewed data with the extremes in single chunks */
+    for (i = 0; i < BIG; i++)
+    {
+      seed = seed * 1103515245u + 12345u;
+      big[i] = (uint8_t)(((seed >> 16) & 0x7F) + (i >> 15));
+    }
+    big[BIG / 3] = 0;
+    big[BIG - 1] = 255;
+
+    compute_statistics(big, BIG, &parallel);
+    tpool_init(1);
+    compute_statistics(big, BIG, &serial);
+    for (i = 0; i < 256; i++)
+    {
+      if (parallel.histogram[i] != serial.histogram[i])
+      {
+        ret = TEST_ERROR;
+      }
+    }
+    if (parallel.count != serial.count || parallel.sum != serial.sum ||
+        parallel.mean != serial.mean || parallel.median != serial.median ||
+        parallel.sum != find_sum(big, BIG) ||
+        parallel.minimum != 0 || parallel.maximum != 255)
+    {
+      ret = TEST_ERROR;
+    }
+
+    /* Median and percentiles agree across pool sizes too */
+    tpool_init(MT_TEST_THREADS);
+    if (find_median(big, BIG) != serial.median ||
+        find_percentile(big, BIG, 0) != 0 ||
+        find_percentile(big, BIG, 100) != 255)
+    {
+      ret = TEST_ERROR;
+    }
+
+    /* ... and from inside a task, which must not deadlock */
+    job.big = big;
+    job.big_size = BIG;
+    tpool_run(tpool_test_stats, &job, MT_TEST_THREADS);
+    for (i = 0; i < MT_TEST_THREADS; i++)
+    {
+      if (job.medians[i] != serial.median || job.inner_threads[i] != 1)
+      {
+        ret = TEST_ERROR;
+      }
+    }
+    if (tpool_threads() != MT_TEST_THREADS)
+    {
+      ret = TEST_ERROR;
+    }
+    tpool_shutdown();
+  }
+#endif
+  return ret;
+}
+
+#if defined (HOST)
+/* capture_stream callback: add up a u16 file, stop after max_chunks */
+typedef struct
+{
+  uint64_t sum;
+  size_t samples;
+  uint32_t chunks;
+  uint32_t max_chunks;
+} capture_test_ctx_t;
+
+static int capture_test_chunk(const void * samples, size_t count, void * ctx)
+{
+  capture_test_ctx_t * c = (capture_test_ctx_t *)ctx;
+  c->sum += find_sum_u16((const uint16_t *)samples, (unsigned int)count);
+  c->samples += count;
+  c->chunks++;
+  return c->chunks == c->max_chunks;
+}
+#endif
+
+int8_t test_capture()
+{
+  int8_t ret = TEST_NO_ERROR;
+
+  PRINTF("test_capture()\n");
+#if defined (HOST)
+  {
+    /* A few pages plus an odd tail, so u16/i32 views drop a partial sample */
+    enum { BYTES = 5 * 4096 + 7 };
+    static uint8_t bytes[BYTES];
+    static int32_t scratch[BYTES / 4];
+    char path[] = "/tmp/c1m4_captureXXXXXX";
+    capture_test_ctx_t ctx = {0, 0, 0, 0};
+    capture_t cap;
+    stats_result_t from_file, from_memory;
+    uint32_t seed = 37, i;
+    int fd = mkstemp(path);
+
+    if (fd < 0)
+    {
+      return TEST_ERROR;
+    }
+    for (i = 0; i < BYTES; i++)
+    {
+      seed = seed * 1103515245u + 12345u;
+      bytes[i] = (uint8_t)(seed >> 16);
+    }
+    if (write(fd, bytes, BYTES) != BYTES)
+    {
+      ret = TEST_ERROR;
+    }
+    close(fd);
+
+    /* u8: the mapped view feeds the stats directly */
+    if (capture_open(&cap, path, CAPTURE_U8, CAPTURE_READ_ONLY) != 0 ||
+        cap.count != BYTES || capture_u16(&cap) != NULL)
+    {
+      ret = TEST_ERROR;
+    }
+    else
+    {
+      compute_statistics(capture_u8(&cap), BYTES, &from_file);
+      compute_statistics(bytes, BYTES, &from_memory);
+      if (from_file.sum != from_memory.sum ||
+          from_file.median != from_memory.median ||
+          find_variance(capture_u8(&cap), BYTES) !=
+            find_variance(bytes, BYTES))
+      {
+        ret = TEST_ERROR;
+      }
+      capture_close(&cap);
+    }
+
+    /* Copy-on-write: sorting the view leaves the file as it was */
+    if (capture_open(&cap, path, CAPTURE_U8, CAPTURE_WRITABLE) != 0)
+    {
+      ret = TEST_ERROR;
+    }
+    else
+    {
+      sort_array(capture_u8(&cap), BYTES);
+      for (i = 1; i < BYTES; i++)
+      {
+        if (capture_u8(&cap)[i - 1] < capture_u8(&cap)[i])
+        {
+          ret = TEST_ERROR;
+        }
+      }
+      capture_close(&cap);
+    }
+
+    /* u16 and i32 views of the same bytes */
+    if (capture_open(&cap, path, CAPTURE_U16, CAPTURE_READ_ONLY) != 0 ||
+        cap.count != BYTES / 2 ||
+        find_sum_u16(capture_u16(&cap), BYTES / 2) !=
+          find_sum_u16((uint16_t *)bytes, BYTES / 2) ||
+        capture_u8(&cap) != NULL)
+    {
+      ret = TEST_ERROR;
+    }
+    capture_close(&cap);
+    if (capture_open(&cap, path, CAPTURE_I32, CAPTURE_READ_ONLY) != 0 ||
+        cap.count != BYTES / 4 ||
+        find_median_i32(capture_i32(&cap), BYTES / 4, scratch) !=
+          find_median_i32((int32_t *)bytes, BYTES / 4, scratch) ||
+        bytes[0] != *(uint8_t *)cap.data)
+    {
+      ret = TEST_ERROR;
+    }
+    capture_close(&cap);
+
+    /* Streaming: 5000-byte windows round up to 2 pages, so 3 windows */
+    ctx.max_chunks = 100;
+    if (capture_stream(path, CAPTURE_U16, 5000, capture_test_chunk,
+                       &ctx) != 0 ||
+        ctx.chunks != 3 || ctx.samples != BYTES / 2 ||
+        ctx.sum != find_sum_u16((uint16_t *)bytes, BYTES / 2))
+    {
+      ret = TEST_ERROR;
+    }
+    ctx.sum = 0;
+    ctx.samples = 0;
+    ctx.chunks = 0;
+    ctx.max_chunks = 1;
+    if (capture_stream(path, CAPTURE_U16, 4096, capture_test_chunk,
+                       &ctx) != 0 || ctx.chunks != 1 || ctx.samples != 2048)
+    {
+      ret = TEST_ERROR;
+    }
+
+    /* Empty and missing files */
+    if (truncate(path, 0) != 0 ||
+        capture_open(&cap, path, CAPTURE_U8, CAPTURE_READ_ONLY) != 0 ||
+        cap.count != 0 || cap.data != NULL)
+    {
+      ret = TEST_ERROR;
+    }
+    capture_close(&cap);
+
+    /* Views stop at UINT_MAX samples (sparse file, where supported) */
+    if (truncate(path, (off_t)UINT_MAX + 1) == 0)
+    {
+      if (capture_open(&cap, path, CAPTURE_U8, CAPTURE_READ_ONLY) != -1)
+      {
+        ret = TEST_ERROR;
+        capture_close(&cap);
+      }
+      if (capture_open(&cap, path, CAPTURE_U16, CAPTURE_READ_ONLY) != 0 ||
+          cap.count != ((size_t)UINT_MAX + 1) / 2)
+      {
+        ret = TEST_ERROR;
+      }
+      capture_close(&cap);
+    }
+    unlink(path);
+    if (capture_open(&cap, path, CAPTURE_U8, CAPTURE_READ_ONLY) != -1 ||
+        capture_stream(path, CAPTURE_U8, 0, capture_test_chunk, &ctx) != -1)
+    {
+      ret = TEST_ERROR;
+    }
+  }
+#endif
+  return ret;
+}
+
+int8_t test_top_k()
+{
+  static const uint32_t sizes[] = {0, 1, 5, 16, 17, 40, 300, SORT_TEST_SIZE};
+  static const uint32_t ks[] = {0, 1, 2, 8, 16, 63, 64, 65, 200, 999, 1000,
+                                5000};
+  static uint8_t in[SORT_TEST_SIZE];
+  static uint8_t sorted[SORT_TEST_SIZE];
+  static uint8_t part[SORT_TEST_SIZE];
+  static uint8_t out[SORT_TEST_SIZE];
+  uint32_t counts[256];
+  uint32_t seed = 31;
+  uint32_t n, p, j, i;
+  int8_t ret = TEST_NO_ERROR;
+
+  PRINTF("test_top_k()\n");
+
+  for (n = 0; n < sizeof(sizes) / sizeof(sizes[0]); n++)
+  {
+    uint32_t size = sizes[n];
+    /* random, ascending (worst case for the heap), constant, three values */
+    for (p = 0; p < 4; p++)
+    {
+      for (i = 0; i < size; i++)
+      {
+        seed = seed * 1103515245u + 12345u;
+        in[i] = p == 0 ? (uint8_t)(seed >> 16) :
+                p == 1 ? (uint8_t)(i * 255 / size) :
+                p == 2 ? 7 : (uint8_t)((seed >> 16) % 3 * 100);
+      }
+      my_memcopy(in, sorted, size);
+      sort_array(sorted, size);
+
+      for (j = 0; j < sizeof(ks) / sizeof(ks[0]); j++)
+      {
+        uint32_t k = ks[j];
+        uint32_t want = k < size ? k : size;
+
+        if (find_top_k(in, size, k, out) != want)
+        {
+          ret = TEST_ERROR;
+        }
+
+        /* Sorted prefix, and the whole array still holds the same values */
+        my_memcopy(in, part, size);
+        sort_array_partial(part, size, k);
+        my_memzero((uint8_t *)counts, sizeof(counts));
+        for (i = 0; i < size; i++)
+        {
+          counts[in[i]]++;
+          counts[part[i]]--;
+        }
+        for (i = 0; i < want; i++)
+        {
+          if (out[i] != sorted[i] || part[i] != sorted[i])
+          {
+            ret = TEST_ERROR;
+          }
+        }
+        for (i = 0; i < 256; i++)
+        {
+          if (counts[i] != 0)
+          {
+            ret = TEST_ERROR;
+          }
+        }
+      }
+    }
+  }
+#if defined (HOST)
+  {
+    /* Long enough for the heap to cover k up to 256 (TOPK_HEAP_RATIO);
+       ascending data makes every sample enter the heap */
+    static uint8_t big[1u << 18];
+    static uint8_t big_sorted[1u << 18];
+    uint32_t size = 1u << 18;
+
+    for (p = 0; p < 2; p++)
+    {
+      for (i = 0; i < size; i++)
+      {
+        seed = seed * 1103515245u + 12345u;
+        big[i] = p == 0 ? (uint8_t)(i >> 10) : (uint8_t)((seed >> 16) % 200);
+      }
+      my_memcopy(big, big_sorted, size);
+      sort_array(big_sorted, size);
+      for (j = 1; j <= 256; j *= 4)
+      {
+        find_top_k(big, size, j, out);
+        for (i = 0; i < j; i++)
+        {
+          if (out[i] != big_sorted[i])
+          {
+            ret = TEST_ERROR;
+          }
+        }
+        sort_array_partial(big, size, j);
+        for (i = 0; i < j; i++)
+        {
+          if (big[i] != big_sorted[i])
+          {
+            ret = TEST_ERROR;
+          }
+        }
+      }
+      /* Still the same values */
+      sort_array(big, size);
+      for (i = 0; i < size; i++)
+      {
+        if (big[i] != big_sorted[i])
+        {
+          ret = TEST_ERROR;
+        }
+      }
+    }
+  }
+#endif
+  return ret;
+}
+
+int8_t test_sort_network()
+{
+  static const uint32_t sizes[] = {8, 16, 32, 40};
+  uint8_t in[40];
+  uint8_t net[40];
+  uint8_t ref[40];
+  uint32_t seed = 41;
+  uint32_t n, p, i, bits;
+  int8_t ret = TEST_NO_ERROR;
+
+  PRINTF("test_sort_network()\n");
+
+  /* 0-1 principle: every 0-1 input sorted means every input is */
+  for (n = 0; n < 2; n++)
+  {
+    uint32_t size = sizes[n];
+    for (bits = 0; bits < (1u << size); bits++)
+    {
+      uint32_t ones = 0;
+      for (i = 0; i < size; i++)
+      {
+        net[i] = (uint8_t)((bits >> i) & 1u);
+        ones += net[i];
+      }
+      sort_array_network(net, size);
+      for (i = 0; i < size; i++)
+      {
+        if (net[i] != (i < ones))
+        {
+          ret = TEST_ERROR;
+        }
+      }
+    }
+  }
+
+  for (n = 0; n < sizeof(sizes) / sizeof(sizes[0]); n++)
+  {
+    uint32_t size = sizes[n];
+    /* random, ascending, descending, constant, two values */
+    for (p = 0; p < 5; p++)
+    {
+      for (i = 0; i < size; i++)
+      {
+        seed = seed * 1103515245u + 12345u;
+        in[i] = p == 0 ? (uint8_t)(seed >> 16) :
+                p == 1 ? (uint8_t)(i * 6) :
+                p == 2 ? (uint8_t)(255 - i * 6) :
+                p == 3 ? 200 : (uint8_t)((seed >> 16) & 1 ? 255 : 0);
+      }
+      my_memcopy(in, ref, size);
+      sort_array_intro(ref, size);
+      my_memcopy(in, net, size);
+      if (sort_array_network(net, size) != 0)
+      {
+        ret = TEST_ERROR;
+      }
+      for (i = 0; i < size; i++)
+      {
+        if (net[i] != ref[i])
+        {
+          ret = TEST_ERROR;
+        }
+      }
+      my_memcopy(in, net, size);
+      sort_array(net, size);
+      for (i = 0; i < size; i++)
+      {
+        if (net[i] != ref[i])
+        {
+          ret = TEST_ERROR;
+        }
+      }
+    }
+  }
+
+  /* Sizes without a network are left alone */
+  for (i = 0; i < 40; i++)
+  {
+    in[i] = (uint8_t)i;
+    net[i] = (uint8_t)i;
+  }
+  if (sort_array_network(net, 0) != -1 || sort_array_network(net, 9) != -1 ||
+      sort_array_network(net, 39) != -1)
+  {
+    ret = TEST_ERROR;
+  }
+  for (i = 0; i < 40; i++)
+  {
+    if (net[i] != in[i])
+    {
+      ret = TEST_ERROR;
+    }
+  }
+  return ret;
+}
+
+/* Descending and equal to ref (u32 refs are sorted as i32, top bit flipped) */
+static int8_t radix_check_u32(const uint32_t * data, int32_t * ref,
+                              uint32_t size)
+{
+  uint32_t i;
+
+  sort_array_i32(ref, size);
+  for (i = 0; i < size; i++)
+  {
+    if (data[i] != ((uint32_t)ref[i] ^ 0x80000000u))
+    {
+      return TEST_ERROR;
+    }
+  }
+  return TEST_NO_ERROR;
+}
+
+int8_t test_radix()
+{
+  static const uint32_t sizes[] = {0, 1, 2, 16, 17, 100, WIDE_TEST_SIZE};
+  static uint16_t in16[WIDE_TEST_SIZE];
+  static uint16_t ref16[WIDE_TEST_SIZE];
+  static uint16_t tmp16[WIDE_TEST_SIZE];
+  static uint32_t in32[WIDE_TEST_SIZE];
+  static int32_t ref32[WIDE_TEST_SIZE];
+  static uint32_t tmp32[WIDE_TEST_SIZE];
+  uint32_t seed = 47;
+  uint32_t n, p, i;
+  int8_t ret = TEST_NO_ERROR;
+
+  PRINTF("test_radix()\n");
+
+  for (n = 0; n < sizeof(sizes) / sizeof(sizes[0]); n++)
+  {
+    uint32_t size = sizes[n];
+    /* random, 14-bit, constant, ascending, descending */
+    for (p = 0; p < 5; p++)
+    {
+      for (i = 0; i < size; i++)
+      {
+        uint32_t r;
+        seed = seed * 1103515245u + 12345u;
+        r = seed ^ (seed << 11);
+        in32[i] = p == 0 ? r : p == 1 ? r & 0x3FFF : p == 2 ? 0xDEADBEEF :
+                  p == 3 ? i * 4099u : 0xFFFFFFFFu - i * 4099u;
+        in16[i] = (uint16_t)(p == 0 ? r >> 8 : in32[i]);
+        ref16[i] = in16[i];
+        ref32[i] = (int32_t)(in32[i] ^ 0x80000000u);
+      }
+      radix_sort_u16(in16, size, tmp16);
+      sort_array_u16(ref16, size);
+      for (i = 0; i < size; i++)
+      {
+        if (in16[i] != ref16[i])
+        {
+          ret = TEST_ERROR;
+        }
+      }
+      radix_sort_u32(in32, size, tmp32);
+      if (radix_check_u32(in32, ref32, size) != TEST_NO_ERROR)
+      {
+        ret = TEST_ERROR;
+      }
+    }
+  }
+#if defined (HOST)
+  {
+    /* Past the parallel threshold, odd length */
+    enum { BIG = 4 * RADIX_PARALLEL_MIN + 777 };
+    uint32_t * big = (uint32_t *)malloc(BIG * sizeof(uint32_t));
+    uint32_t * tmp = (uint32_t *)malloc(BIG * sizeof(uint32_t));
+    int32_t * ref = (int32_t *)malloc(BIG * sizeof(int32_t));
+    uint16_t * big16 = (uint16_t *)malloc(BIG * sizeof(uint16_t));
+    uint16_t * ref16_big = (uint16_t *)malloc(BIG * sizeof(uint16_t));
+
+    if (!big || !tmp || !ref || !big16 || !ref16_big)
+    {
+      ret = TEST_ERROR;
+    }
+    else
+    {
+      tpool_init(MT_TEST_THREADS);
+      /* random, then keys sharing their top 12 bits, then all equal */
+      for (p = 0; p < 3; p++)
+      {
+        for (i = 0; i < BIG; i++)
+        {
+          seed = seed * 1103515245u + 12345u;
+          big[i] = p == 0 ? seed ^ (seed << 13) :
+                   p == 1 ? 0xABC00000u | (seed >> 12) : 12345;
+          big16[i] = (uint16_t)(p == 1 ? 0x0400 | (seed >> 25) : big[i]);
+          ref[i] = (int32_t)(big[i] ^ 0x80000000u);
+          ref16_big[i] = big16[i];
+        }
+        radix_sort_u32_mt(big, BIG, tmp);
+        if (radix_check_u32(big, ref, BIG) != TEST_NO_ERROR)
+        {
+          ret = TEST_ERROR;
+        }
+        radix_sort_u16_mt(big16, BIG, (uint16_t *)tmp);
+        radix_sort_u16(ref16_big, BIG, (uint16_t *)tmp);
+        for (i = 0; i < BIG; i++)
+        {
+          if (big16[i] != ref16_big[i])
+          {
+            ret = TEST_ERROR;
+          }
+        }
+      }
+      tpool_shutdown();
+    }
+    free(big);
+    free(tmp);
+    free(ref);
+    free(big16);
+    free(ref16_big);
+  }
+#endif
+  return ret;
+}
+
+#if defined (HOST)
+/* Sort path into out_path and compare the result with ref (sorted) */
+static int8_t extsort_check(const char * path, const char * out_path,
+                            capture_format_t format, size_t memory,
+                            const void * ref, size_t count, uint32_t * runs)
+{
+  extsort_stats_t stats;
+  capture_t cap;
+  int8_t ret = TEST_NO_ERROR;
+
+  if (extsort_file(path, out_path, format, memory, NULL, &stats) != 0 ||
+      capture_open(&cap, out_path, format, CAPTURE_READ_ONLY) != 0)
+  {
+    return TEST_ERROR;
+  }
+  if (cap.count != count || stats.samples != count ||
+      (count > 0 && memcmp(cap.data, ref,
+                           count * capture_sample_bytes(format)) != 0))
+  {
+    ret = TEST_ERROR;
+  }
+  *runs = stats.runs;
+  capture_close(&cap);
+  return ret;
+}
+#endif
+
+int8_t test_extsort()
+{
+  int8_t ret = TEST_NO_ERROR;
+
+  PRINTF("test_extsort()\n");
+#if defined (HOST)
+  {
+    /* 1 MiB budget: 4 MiB of i32 spill 8 runs, each merged through a
+       buffer smaller than itself; plus a partial sample at the end */
+    enum { BYTES = (4 << 20) + 6, MEMORY = 1 << 20 };
+    static const capture_format_t formats[] = {
+      CAPTURE_U8, CAPTURE_U16, CAPTURE_I32
+    };
+    uint8_t * bytes = (uint8_t *)malloc(BYTES);
+    uint8_t * ref = (uint8_t *)malloc(BYTES);
+    uint16_t * scratch = (uint16_t *)malloc(BYTES);
+    char path[] = "/tmp/c1m4_extsortXXXXXX";
+    char out_path[] = "/tmp/c1m4_extsortXXXXXX";
+    int fd = mkstemp(path);
+    int out = mkstemp(out_path);
+    uint32_t seed = 53, runs, i, f;
+
+    if (fd >= 0) close(fd);
+    if (out >= 0) close(out);
+    if (!bytes || !ref || !scratch || fd < 0 || out < 0)
+    {
+      ret = TEST_ERROR;
+    }
+    for (i = 0; ret == TEST_NO_ERROR && i < BYTES; i++)
+    {
+      seed = seed * 1103515245u + 12345u;
+      bytes[i] = (uint8_t)(seed >> 16);
+    }
+    for (f = 0; ret == TEST_NO_ERROR && f < 3; f++)
+    {
+      size_t sample = capture_sample_bytes(formats[f]);
+      size_t count = BYTES / sample;
+
+      fd = open(path, O_WRONLY | O_TRUNC);
+      if (fd < 0 || write(fd, bytes, BYTES) != BYTES)
+      {
+        ret = TEST_ERROR;
+      }
+      if (fd >= 0) close(fd);
+
+      my_memcopy(bytes, ref, BYTES);
+      if (formats[f] == CAPTURE_U8)
+      {
+        sort_array(ref, count);
+      }
+      else if (formats[f] == CAPTURE_U16)
+      {
+        radix_sort_u16((uint16_t *)ref, count, scratch);
+      }
+      else
+      {
+        sort_array_i32((int32_t *)ref, count);
+      }
+
+      /* Spilled runs (u8 is counted, never spilled) */
+      if (extsort_check(path, out_path, formats[f], MEMORY, ref, count,
+                        &runs) != TEST_NO_ERROR ||
+          (runs == 0) != (formats[f] == CAPTURE_U8))
+      {
+        ret = TEST_ERROR;
+      }
+      /* Fits the default budget: sorted in memory, in place */
+      if (extsort_check(path, path, formats[f], 0, ref, count,
+                        &runs) != TEST_NO_ERROR || runs != 0)
+      {
+        ret = TEST_ERROR;
+      }
+    }
+
+    /* Empty file */
+    fd = open(path, O_WRONLY | O_TRUNC);
+    if (fd >= 0) close(fd);
+    if (extsort_check(path, out_path, CAPTURE_I32, MEMORY, ref, 0,
+                      &runs) != TEST_NO_ERROR ||
+        extsort_file("/nonexistent/c1m4", out_path, CAPTURE_U16, 0, NULL,
+                     NULL) == 0)
+    {
+      ret = TEST_ERROR;
+    }
+
+    unlink(path);
+    unlink(out_path);
+    free(bytes);
+    free(ref);
+    free(scratch);
+  }
+#endif
+  return ret;
+}
+
+int8_t test_sort_parallel()
+{
+  int8_t ret = TEST_NO_ERROR;
+
+  PRINTF("test_sort_parallel()\n");
+#if defined (HOST)
+  {
+    /* Past the parallel threshold, odd length */
+    enum { BIG = 2 * SORT_PARALLEL_MIN + 333 };
+    uint8_t * bytes = (uint8_t *)malloc(BIG);
+    uint8_t * bytes_ref = (uint8_t *)malloc(BIG);
+    int32_t * i32 = (int32_t *)malloc(BIG * sizeof(int32_t));
+    int32_t * i32_ref = (int32_t *)malloc(BIG * sizeof(int32_t));
+    uint16_t * u16 = (uint16_t *)malloc(BIG * sizeof(uint16_t));
+    uint16_t * u16_ref = (uint16_t *)malloc(BIG * sizeof(uint16_t));
+    float * f32 = (float *)malloc(BIG * sizeof(float));
+    float * f32_ref = (float *)malloc(BIG * sizeof(float));
+    uint32_t seed = 67, i, p;
+
+    if (!bytes || !bytes_ref || !i32 || !i32_ref || !u16 || !u16_ref ||
+        !f32 || !f32_ref)
+    {
+      ret = TEST_ERROR;
+    }
+    /* random, a few distinct values, all equal, ascending */
+    for (p = 0; ret == TEST_NO_ERROR && p < 4; p++)
+    {
+      for (i = 0; i < BIG; i++)
+      {
+        seed = seed * 1103515245u + 12345u;
+        i32[i] = p == 0 ? (int32_t)(seed ^ (seed << 13)) :
+                 p == 1 ? (int32_t)(seed >> 29) - 3 :
+                 p == 2 ? -7 : (int32_t)i - BIG / 2;
+        bytes[i] = (uint8_t)i32[i];
+        u16[i] = (uint16_t)i32[i];
+        f32[i] = (float)i32[i] * 0.25f + 0.5f;
+      }
+      my_memcopy(bytes, bytes_ref, BIG);
+      my_memcopy((uint8_t *)i32, (uint8_t *)i32_ref, BIG * sizeof(int32_t));
+      my_memcopy((uint8_t *)u16, (uint8_t *)u16_ref, BIG * sizeof(uint16_t));
+      my_memcopy((uint8_t *)f32, (uint8_t *)f32_ref, BIG * sizeof(float));
+
+      tpool_init(1);
+      sort_array(bytes_ref, BIG);
+      sort_array_i32(i32_ref, BIG);
+      sort_array_u16(u16_ref, BIG);
+      sort_array_f32(f32_ref, BIG);
+      tpool_init(MT_TEST_THREADS);
+      sort_array(bytes, BIG);
+      sort_array_i32(i32, BIG);
+      sort_array_u16(u16, BIG);
+      sort_array_f32(f32, BIG);
+
+      if (memcmp(bytes, bytes_ref, BIG) != 0 ||
+          memcmp(i32, i32_ref, BIG * sizeof(int32_t)) != 0 ||
+          memcmp(u16, u16_ref, BIG * sizeof(uint16_t)) != 0 ||
+          memcmp(f32, f32_ref, BIG * sizeof(float)) != 0)
+      {
+        ret = TEST_ERROR;
+      }
+    }
+    tpool_shutdown();
+    free(bytes);
+    free(bytes_ref);
+    free(i32);
+    free(i32_ref);
+    free(u16);
+    free(u16_ref);
+    free(f32);
+    free(f32_ref);
+  }
+#endif
+  return ret;
+}
+
 void course1(void) 
 {
   uint8_t i;
@@ -335,6 +2657,30 @@ void course1(void)
   results[5] = test_memcopy();
   results[6] = test_memset();
   results[7] = test_reverse();
+  results[8] = test_memcopy_bulk();
+  results[9] = test_memmove_bulk();
+  results[10] = test_memset_bulk();
+  results[11] = test_reverse_bulk();
+  results[12] = test_pool();
+  results[13] = test_arena();
+  results[14] = test_tlsf();
+  results[15] = test_mtpool();
+  results[16] = test_dma();
+  results[17] = test_bits();
+  results[18] = test_sort();
+  results[19] = test_median();
+  results[20] = test_statistics();
+  results[21] = test_stats_kernels();
+  results[22] = test_stats_stream();
+  results[23] = test_stats_typed();
+  results[24] = test_variance();
+  results[25] = test_stats_parallel();
+  results[26] = test_capture();
+  results[27] = test_top_k();
+  results[28] = test_sort_network();
+  results[29] = test_radix();
+  results[30] = test_extsort();
+  results[31] = test_sort_parallel();
 
   for ( i = 0; i < TESTCOUNT; i++) 
   {
@@ -346,4 +2692,6 @@ void course1(void)
   PRINTF("  PASSED: %d / %d\n", (TESTCOUNT - failed), TESTCOUNT);
   PRINTF("  FAILED: %d / %d\n", failed, TESTCOUNT);
   PRINTF("--------------------------------\n");
+  print_pool_stats();
+  print_tlsf_stats();
 }
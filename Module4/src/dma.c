@@ -0,0 +1,440 @@
+/*****************************************************************************
+ * @file dma.c
+ * @brief Implementation of the asynchronous memory copy engine
+ *
+ * Transfers live in a fixed table of DMA_MAX_TRANSFERS slots and are served
+ * in submission order. A handle packs the slot index with a generation
+ * count, so a handle whose slot has been recycled reads as done.
+ *
+ * MSP432: one software-triggered µDMA channel in auto-request mode. A
+ * descriptor is split into runs of at most 1024 items (words when source,
+ * destination and length allow it, bytes otherwise). The DMA_INT0 handler
+ * programs the next run, walks the descriptor chain, and starts the next
+ * queued transfer, so the CPU only touches the engine between runs.
+ *
+ * HOST: a worker thread stands in for the controller and copies each
+ * descriptor with my_memcopy.
+ *
+ * This code was written as part of the Introduction to Embedded Systems
+ * Software and Development Environments course (University of Colorado Boulder).
+ *
+ * @author Timofei Alekseenko
+ * @date October 17, 2026
+ *
+ *****************************************************************************/
+
+#if defined (HOST)
+#define _POSIX_C_SOURCE 200809L   /* pthread condition variables */
+#endif
+
+#include "dma.h"
+#include "platform.h"
+#include "memory.h"
+#include <stdint.h>
+#include <stddef.h>
+
+#if defined (HOST)
+#include <pthread.h>
+#endif
+
+#define DMA_SLOT_FREE   (0)
+#define DMA_SLOT_QUEUED (1)
+#define DMA_SLOT_ACTIVE (2)
+
+#define DMA_HANDLE_SLOT(h) ((uint32_t)(h) & 0xFFu)
+#define DMA_HANDLE_GEN(h)  (((uint32_t)(h) >> 8) & 0x7FFFFFu)
+
+typedef struct {
+  volatile uint8_t state;
+  uint32_t gen;               /* Bumped on every submission, 23 bits used */
+  dma_desc_t * desc;          /* Descriptor being copied */
+  size_t done;                /* Bytes of desc already copied */
+  size_t run;                 /* Bytes in the run in flight (MSP432) */
+  dma_desc_t single;          /* Storage for dma_memcopy_async */
+  dma_callback_t callback;
+  void * ctx;
+} dma_slot_t;
+
+static dma_slot_t dma_slots[DMA_MAX_TRANSFERS];
+
+/* Submission order: ring of slot indices */
+static uint8_t dma_fifo[DMA_MAX_TRANSFERS];
+static uint32_t dma_fifo_head = 0;
+static uint32_t dma_fifo_count = 0;
+
+static uint8_t dma_ready = 0;
+
+static inline dma_handle_t make_handle(uint32_t slot) {
+  return (dma_handle_t)((dma_slots[slot].gen << 8) | slot);
+}
+
+static void fifo_push(uint32_t slot) {
+  dma_fifo[(dma_fifo_head + dma_fifo_count) % DMA_MAX_TRANSFERS] =
+    (uint8_t)slot;
+  dma_fifo_count++;
+}
+
+static int32_t fifo_pop(void) {
+  uint8_t slot;
+
+  if (dma_fifo_count == 0) {
+    return -1;
+  }
+  slot = dma_fifo[dma_fifo_head];
+  dma_fifo_head = (dma_fifo_head + 1) % DMA_MAX_TRANSFERS;
+  dma_fifo_count--;
+  return slot;
+}
+
+/**
+ * @brief Claim a free slot and fill it (caller holds the engine lock)
+ * @param chain  Descriptor chain, or NULL to use a copy of single
+ * @param single Descriptor copied into the slot when chain is NULL
+ * @return Slot index, or -1 if every slot is busy
+ */
+static int32_t claim_slot(dma_desc_t * chain, const dma_desc_t * single,
+                          dma_callback_t callback, void * ctx) {
+  uint32_t i;
+
+  for (i = 0; i < DMA_MAX_TRANSFERS; i++) {
+    if (dma_slots[i].state == DMA_SLOT_FREE) {
+      if (chain == NULL && single != NULL) {
+        dma_slots[i].single = *single;
+        chain = &dma_slots[i].single;
+      }
+      dma_slots[i].gen = (dma_slots[i].gen + 1) & 0x7FFFFFu;
+      dma_slots[i].desc = chain;
+      dma_slots[i].done = 0;
+      dma_slots[i].callback = callback;
+      dma_slots[i].ctx = ctx;
+      dma_slots[i].state = DMA_SLOT_QUEUED;
+      return (int32_t)i;
+    }
+  }
+  return -1;
+}
+
+#if defined (MSP432)
+
+/* Channel control structure: {source end, destination end, control, spare} */
+typedef struct {
+  volatile void * src_end;
+  volatile void * dst_end;
+  volatile uint32_t control;
+  uint32_t spare;
+} dma_ctl_t;
+
+/* Primary and alternate tables for all 8 channels; CTLBASE needs 1 KiB
+ * alignment */
+static dma_ctl_t dma_ctl_table[16] __attribute__((aligned(1024)));
+
+#define DMA_CH_MASK       ((uint32_t)1 << DMA_COPY_CHANNEL)
+#define DMA_MAX_ITEMS     (1024u)
+
+static int32_t dma_current = -1;   /* Slot owned by the controller */
+
+static inline uint32_t irq_save(void) {
+  uint32_t primask = __get_PRIMASK();
+  __disable_irq();
+  return primask;
+}
+
+static inline void irq_restore(uint32_t primask) {
+  __set_PRIMASK(primask);
+}
+
+/**
+ * @brief Program and trigger the next run of the current descriptor
+ */
+static void start_run(dma_slot_t * slot) {
+  dma_desc_t * desc = slot->desc;
+  const uint8_t * src = desc->src + slot->done;
+  uint8_t * dst = desc->dst + slot->done;
+  size_t left = desc->length - slot->done;
+  uint32_t size_log2 = 0;
+  uint32_t items;
+  uint32_t control;
+  dma_ctl_t * ctl = &dma_ctl_table[DMA_COPY_CHANNEL];
+
+  if (((((uintptr_t)src) | ((uintptr_t)dst)) & 3u) == 0 && left >= 4) {
+    size_log2 = 2;
+  }
+  items = (uint32_t)(left >> size_log2);
+  if (items > DMA_MAX_ITEMS) {
+    items = DMA_MAX_ITEMS;
+  }
+
+  if (size_log2 == 2) {
+    control = UDMA_CHCTL_DSTINC_32 | UDMA_CHCTL_DSTSIZE_32 |
+              UDMA_CHCTL_SRCINC_32 | UDMA_CHCTL_SRCSIZE_32;
+  }
+  else {
+    control = UDMA_CHCTL_DSTINC_8 | UDMA_CHCTL_DSTSIZE_8 |
+              UDMA_CHCTL_SRCINC_8 | UDMA_CHCTL_SRCSIZE_8;
+  }
+  control |= UDMA_CHCTL_ARBSIZE_32 |
+             ((items - 1u) << UDMA_CHCTL_XFERSIZE_S) |
+             UDMA_CHCTL_XFERMODE_AUTO;
+
+  slot->run = (size_t)items << size_log2;
+  ctl->src_end = (void *)(src + ((items - 1u) << size_log2));
+  ctl->dst_end = (void *)(dst + ((items - 1u) << size_log2));
+  ctl->control = control;
+
+  DMA_Control->ENASET = DMA_CH_MASK;
+  DMA_Channel->SW_CHTRIG = DMA_CH_MASK;
+}
+
+/**
+ * @brief Hand the next queued transfer to the controller (interrupts off)
+ */
+static void start_next(void) {
+  dma_current = fifo_pop();
+  if (dma_current >= 0) {
+    dma_slots[dma_current].state = DMA_SLOT_ACTIVE;
+    start_run(&dma_slots[dma_current]);
+  }
+}
+
+void dma_init(void) {
+  uint32_t primask;
+
+  if (dma_ready) {
+    return;
+  }
+  primask = irq_save();
+  DMA_Control->CFG = DMA_CFG_MASTEN;
+  DMA_Control->CTLBASE = (uint32_t)(uintptr_t)dma_ctl_table;
+  DMA_Channel->CH_SRCCFG[DMA_COPY_CHANNEL] = 0;    /* Software only */
+  DMA_Control->ALTCLR = DMA_CH_MASK;
+  DMA_Control->USEBURSTCLR = DMA_CH_MASK;
+  DMA_Control->REQMASKCLR = DMA_CH_MASK;
+  DMA_Channel->INT0_CLRFLG = DMA_CH_MASK;
+  NVIC_EnableIRQ(DMA_INT0_IRQn);
+  dma_ready = 1;
+  irq_restore(primask);
+}
+
+/**
+ * @brief Run completion: advance the chain, finish or start the next run
+ */
+void DMA_INT0_IRQHandler(void) {
+  dma_slot_t * slot;
+  dma_handle_t handle;
+
+  if ((DMA_Channel->INT0_SRCFLG & DMA_CH_MASK) == 0) {
+    return;
+  }
+  DMA_Channel->INT0_CLRFLG = DMA_CH_MASK;
+  if (dma_current < 0) {
+    return;
+  }
+
+  slot = &dma_slots[dma_current];
+  slot->done += slot->run;
+
+  while (slot->desc != NULL && slot->done >= slot->desc->length) {
+    slot->desc = slot->desc->next;
+    slot->done = 0;
+  }
+  if (slot->desc != NULL) {
+    start_run(slot);
+    return;
+  }
+
+  handle = make_handle((uint32_t)dma_current);
+  if (slot->callback != NULL) {
+    slot->callback(handle, slot->ctx);
+  }
+  slot->state = DMA_SLOT_FREE;
+  start_next();
+}
+
+static dma_handle_t dma_submit(dma_desc_t * chain, const dma_desc_t * single,
+                               dma_callback_t callback, void * ctx) {
+  uint32_t primask;
+  int32_t slot;
+  dma_handle_t handle;
+
+  dma_init();
+
+  primask = irq_save();
+  slot = claim_slot(chain, single, callback, ctx);
+  if (slot < 0) {
+    irq_restore(primask);
+    return DMA_INVALID_HANDLE;
+  }
+  handle = make_handle((uint32_t)slot);
+  /* Skip empty leading descriptors so every run moves at least one item */
+  chain = dma_slots[slot].desc;
+  while (chain != NULL && chain->length == 0) {
+    chain = chain->next;
+  }
+  dma_slots[slot].desc = chain;
+  if (chain == NULL) {
+    /* Nothing to move: complete inline */
+    irq_restore(primask);
+    if (callback != NULL) {
+      callback(handle, ctx);
+    }
+    dma_slots[slot].state = DMA_SLOT_FREE;
+    return handle;
+  }
+  fifo_push((uint32_t)slot);
+  if (dma_current < 0) {
+    start_next();
+  }
+  irq_restore(primask);
+  return handle;
+}
+
+void dma_wait(dma_handle_t handle) {
+  /* Check and sleep with interrupts masked: a completion that lands
+     between dma_poll and WFI stays pending and still wakes WFI */
+  uint32_t primask = irq_save();
+
+  while (dma_poll(handle) == DMA_STATUS_BUSY) {
+    __WFI();
+    __enable_irq();       /* Let the pending DMA_INT0 handler run */
+    __disable_irq();
+  }
+  irq_restore(primask);
+}
+
+#else /* HOST */
+
+static pthread_mutex_t dma_lock = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t dma_work = PTHREAD_COND_INITIALIZER;
+static pthread_cond_t dma_done = PTHREAD_COND_INITIALIZER;
+static pthread_once_t dma_once = PTHREAD_ONCE_INIT;
+static pthread_t dma_thread;
+
+/**
+ * @brief Worker thread: the software "controller"
+ */
+static void * dma_worker(void * arg) {
+  (void)arg;
+
+  pthread_mutex_lock(&dma_lock);
+  for (;;) {
+    int32_t slot;
+    dma_desc_t * desc;
+
+    while ((slot = fifo_pop()) < 0) {
+      pthread_cond_wait(&dma_work, &dma_lock);
+    }
+    dma_slots[slot].state = DMA_SLOT_ACTIVE;
+    desc = dma_slots[slot].desc;
+    pthread_mutex_unlock(&dma_lock);
+
+    for (; desc != NULL; desc = desc->next) {
+      if (desc->length != 0) {
+        my_memcopy((uint8_t *)desc->src, desc->dst, desc->length);
+      }
+    }
+    if (dma_slots[slot].callback != NULL) {
+      dma_slots[slot].callback(make_handle((uint32_t)slot),
+                               dma_slots[slot].ctx);
+    }
+
+    pthread_mutex_lock(&dma_lock);
+    dma_slots[slot].desc = NULL;
+    dma_slots[slot].state = DMA_SLOT_FREE;
+    pthread_cond_broadcast(&dma_done);
+  }
+  return NULL;
+}
+
+static void dma_start_worker(void) {
+  pthread_attr_t attr;
+
+  pthread_attr_init(&attr);
+  pthread_attr_setdetachstate(&attr, PTHREAD_CREATE_DETACHED);
+  if (pthread_create(&dma_thread, &attr, dma_worker, NULL) == 0) {
+    dma_ready = 1;
+  }
+  pthread_attr_destroy(&attr);
+}
+
+void dma_init(void) {
+  pthread_once(&dma_once, dma_start_worker);
+}
+
+static dma_handle_t dma_submit(dma_desc_t * chain, const dma_desc_t * single,
+                               dma_callback_t callback, void * ctx) {
+  int32_t slot;
+  dma_handle_t handle;
+
+  dma_init();
+  if (!dma_ready) {
+    return DMA_INVALID_HANDLE;
+  }
+
+  pthread_mutex_lock(&dma_lock);
+  slot = claim_slot(chain, single, callback, ctx);
+  if (slot < 0) {
+    pthread_mutex_unlock(&dma_lock);
+    return DMA_INVALID_HANDLE;
+  }
+  handle = make_handle((uint32_t)slot);
+  fifo_push((uint32_t)slot);
+  pthread_cond_signal(&dma_work);
+  pthread_mutex_unlock(&dma_lock);
+  return handle;
+}
+
+void dma_wait(dma_handle_t handle) {
+  uint32_t slot = DMA_HANDLE_SLOT(handle);
+
+  if (handle < 0 || slot >= DMA_MAX_TRANSFERS) {
+    return;
+  }
+  pthread_mutex_lock(&dma_lock);
+  while (dma_slots[slot].state != DMA_SLOT_FREE &&
+         dma_slots[slot].gen == DMA_HANDLE_GEN(handle)) {
+    pthread_cond_wait(&dma_done, &dma_lock);
+  }
+  pthread_mutex_unlock(&dma_lock);
+}
+
+#endif /* MSP432 */
+
+dma_handle_t dma_copy_async(dma_desc_t * chain, dma_callback_t callback,
+                            void * ctx) {
+  if (chain == NULL) {
+    return DMA_INVALID_HANDLE;
+  }
+  return dma_submit(chain, NULL, callback, ctx);
+}
+
+dma_handle_t dma_memcopy_async(const uint8_t * src, uint8_t * dst,
+                               size_t length, dma_callback_t callback,
+                               void * ctx) {
+  dma_desc_t single;
+
+  single.src = src;
+  single.dst = dst;
+  single.length = length;
+  single.next = NULL;
+  return dma_submit(NULL, &single, callback, ctx);
+}
+
+uint8_t dma_poll(dma_handle_t handle) {
+  uint32_t slot = DMA_HANDLE_SLOT(handle);
+  uint8_t status = DMA_STATUS_DONE;
+
+  if (handle < 0 || slot >= DMA_MAX_TRANSFERS) {
+    return DMA_STATUS_DONE;
+  }
+#if defined (HOST)
+  pthread_mutex_lock(&dma_lock);
+#endif
+  if (dma_slots[slot].state != DMA_SLOT_FREE &&
+      dma_slots[slot].gen == DMA_HANDLE_GEN(handle)) {
+    status = DMA_STATUS_BUSY;
+  }
+#if defined (HOST)
+  pthread_mutex_unlock(&dma_lock);
+#endif
+  return status;
+}
@@ -0,0 +1,469 @@
+/*****************************************************************************
+ * @file extsort.c
+ * @brief Implementation of the external merge sort (HOST)
+ *
+ * u16 and i32 blocks are sorted with radix_sort_u16_mt/radix_sort_u32_mt,
+ * i32 with the sign bit flipped so the unsigned order is the signed one;
+ * runs keep the flipped keys and the merge flips them back on output.
+ * u8 files need no runs: 256 counters hold any file, so the blocks are
+ * counted in parallel and the output is written from the counts.
+ *
+ * This code was written as part of the Introduction to Embedded Systems
+ * Software and Development Environments course (University of Colorado Boulder).
+ *
+ * @author Timofei Alekseenko
+ * @date October 17, 2026
+ *
+ *****************************************************************************/
+
+#define _POSIX_C_SOURCE 200809L   /* pread, mkstemp, posix_fadvise */
+
+#include "extsort.h"
+#include "radix.h"
+#include "tpool.h"
+#include "memory.h"
+#include "platform.h"
+#include <stdint.h>
+#include <stddef.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <limits.h>
+#include <errno.h>
+#include <time.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/stat.h>
+
+#define EXTSORT_SIGN (0x80000000u)
+
+/**
+ * @brief One sorted run being merged
+ */
+typedef struct {
+  uint8_t * buf;
+  size_t pos;                 /* Next sample in buf */
+  size_t len;                 /* Samples in buf */
+  uint64_t offset;            /* Next spill file byte to read */
+  uint64_t end;               /* End of the run in the spill file */
+} extsort_run_t;
+
+/**
+ * @brief Parallel byte count of one block
+ */
+typedef struct {
+  const uint8_t * data;
+  size_t size;
+  uint32_t pieces;
+  uint32_t counts[TPOOL_MAX_THREADS][256];
+} extsort_count_t;
+
+static uint64_t extsort_ns(void) {
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return (uint64_t)ts.tv_sec * 1000000000ULL + (uint64_t)ts.tv_nsec;
+}
+
+/**
+ * @brief read() until length bytes or end of file
+ * @return Bytes read, or -1
+ */
+static ssize_t read_full(int fd, void * buf, size_t length) {
+  size_t done = 0;
+
+  while (done < length) {
+    ssize_t got = read(fd, (uint8_t *)buf + done, length - done);
+    if (got < 0 && errno == EINTR) continue;
+    if (got < 0) return -1;
+    if (got == 0) break;
+    done += (size_t)got;
+  }
+  return (ssize_t)done;
+}
+
+/**
+ * @brief pread() until length bytes or end of file
+ * @return Bytes read, or -1
+ */
+static ssize_t pread_full(int fd, void * buf, size_t length, uint64_t offset) {
+  size_t done = 0;
+
+  while (done < length) {
+    ssize_t got = pread(fd, (uint8_t *)buf + done, length - done,
+                        (off_t)(offset + done));
+    if (got < 0 && errno == EINTR) continue;
+    if (got < 0) return -1;
+    if (got == 0) break;
+    done += (size_t)got;
+  }
+  return (ssize_t)done;
+}
+
+/**
+ * @brief write() all of length bytes
+ * @return 0, or -1
+ */
+static int8_t write_full(int fd, const void * buf, size_t length) {
+  size_t done = 0;
+
+  while (done < length) {
+    ssize_t put = write(fd, (const uint8_t *)buf + done, length - done);
+    if (put < 0 && errno == EINTR) continue;
+    if (put <= 0) return -1;
+    done += (size_t)put;
+  }
+  return 0;
+}
+
+static void extsort_count(void * arg, uint32_t index) {
+  extsort_count_t * job = (extsort_count_t *)arg;
+  uint32_t * counts = job->counts[index];
+  size_t begin = (uint64_t)job->size * index / job->pieces;
+  size_t end = (uint64_t)job->size * (index + 1) / job->pieces;
+
+  my_memzero((uint8_t *)counts, 256 * sizeof(uint32_t));
+  for (size_t i = begin; i < end; i++) {
+    counts[job->data[i]]++;
+  }
+}
+
+/**
+ * @brief Sort one block in place, keys as stored in the runs
+ */
+static void extsort_block(void * block, void * scratch, size_t count,
+                          size_t sample) {
+  if (sample == 2) {
+    radix_sort_u16_mt((uint16_t *)block, (unsigned int)count,
+                      (uint16_t *)scratch);
+  } else {
+    uint32_t * keys = (uint32_t *)block;
+    for (size_t i = 0; i < count; i++) keys[i] ^= EXTSORT_SIGN;
+    radix_sort_u32_mt(keys, (unsigned int)count, (uint32_t *)scratch);
+  }
+}
+
+/**
+ * @brief Undo the run key encoding of count samples before output
+ */
+static void extsort_decode(void * block, size_t count, size_t sample) {
+  if (sample == 4) {
+    uint32_t * keys = (uint32_t *)block;
+    for (size_t i = 0; i < count; i++) keys[i] ^= EXTSORT_SIGN;
+  }
+}
+
+/**
+ * @brief u8: count every block, then write the sorted file from the counts
+ */
+static int8_t extsort_bytes(int in, const char * out_path, uint8_t * block,
+                            size_t block_bytes, uint64_t total,
+                            extsort_stats_t * st) {
+  extsort_count_t * job = (extsort_count_t *)malloc(sizeof(*job));
+  uint64_t counts[256] = {0};
+  uint64_t t0;
+  int out;
+  int8_t ret = 0;
+
+  if (job == NULL) return -1;
+  job->pieces = tpool_threads();
+  for (uint64_t done = 0; done < total; ) {
+    size_t length = total - done < block_bytes ? (size_t)(total - done)
+                                               : block_bytes;
+    t0 = extsort_ns();
+    if (read_full(in, block, length) != (ssize_t)length) {
+      free(job);
+      return -1;
+    }
+    st->read_ns += extsort_ns() - t0;
+
+    t0 = extsort_ns();
+    job->data = block;
+    job->size = length;
+    tpool_run(extsort_count, job, job->pieces);
+    for (uint32_t p = 0; p < job->pieces; p++) {
+      for (unsigned int v = 0; v < 256; v++) counts[v] += job->counts[p][v];
+    }
+    st->sort_ns += extsort_ns() - t0;
+    done += length;
+  }
+  free(job);
+
+  t0 = extsort_ns();
+  out = open(out_path, O_WRONLY | O_CREAT | O_TRUNC, 0666);
+  if (out < 0) return -1;
+  for (unsigned int v = 256; v > 0 && ret == 0; v--) {
+    uint64_t left = counts[v - 1];
+    while (left > 0 && ret == 0) {
+      size_t length = left < block_bytes ? (size_t)left : block_bytes;
+      my_memset(block, length, (uint8_t)(v - 1));
+      ret = write_full(out, block, length);
+      left -= length;
+    }
+  }
+  if (close(out) != 0) ret = -1;
+  st->spill_ns += extsort_ns() - t0;
+  return ret;
+}
+
+/**
+ * @brief Current key of a run for the loser tree: sample + 1, 0 when done,
+ *        so the larger value wins and finished runs lose to everything
+ */
+static inline uint64_t run_key(const extsort_run_t * run, size_t sample) {
+  if (run->pos == run->len) return 0;
+  if (sample == 2) return (uint64_t)((const uint16_t *)run->buf)[run->pos] + 1;
+  return (uint64_t)((const uint32_t *)run->buf)[run->pos] + 1;
+}
+
+/**
+ * @brief Refill an exhausted run buffer
+ * @return 0, or -1 on a read error
+ */
+static int8_t run_fill(extsort_run_t * run, int fd, size_t buf_bytes,
+                       size_t sample) {
+  size_t length = run->end - run->offset < buf_bytes
+                  ? (size_t)(run->end - run->offset) : buf_bytes;
+
+  run->pos = 0;
+  run->len = 0;
+  if (length == 0) return 0;
+  if (pread_full(fd, run->buf, length, run->offset) != (ssize_t)length) {
+    return -1;
+  }
+  run->offset += length;
+  run->len = length / sample;
+  return 0;
+}
+
+/**
+ * @brief k-way merge of the spilled runs through a loser tree
+ *
+ * tree[1 .. k - 1] hold the loser of each match, tree[0] the overall
+ * winner; key[k] is a sentinel that beats every run while the tree is
+ * built. Equal keys go to the lower run, which keeps the merge stable.
+ */
+static int8_t extsort_merge(int spill, int out, const uint64_t * bounds,
+                            uint32_t k, size_t memory, size_t sample) {
+  extsort_run_t * runs = (extsort_run_t *)calloc(k, sizeof(*runs));
+  uint32_t * tree = (uint32_t *)malloc(k * sizeof(*tree));
+  uint64_t * key = (uint64_t *)malloc((k + 1) * sizeof(*key));
+  size_t buf_bytes = memory / (k + 1) / sample * sample;
+  uint8_t * obuf = NULL;
+  size_t olen = 0;
+  int8_t ret = -1;
+
+  if (buf_bytes < EXTSORT_MIN_BUFFER) buf_bytes = EXTSORT_MIN_BUFFER;
+  if (runs == NULL || tree == NULL || key == NULL ||
+      (obuf = (uint8_t *)malloc(buf_bytes)) == NULL) {
+    goto done;
+  }
+  for (uint32_t r = 0; r < k; r++) {
+    runs[r].offset = bounds[r];
+    runs[r].end = bounds[r + 1];
+    runs[r].buf = (uint8_t *)malloc(buf_bytes);
+    if (runs[r].buf == NULL || run_fill(&runs[r], spill, buf_bytes,
+                                        sample) != 0) {
+      goto done;
+    }
+    key[r] = run_key(&runs[r], sample);
+    tree[r] = k;
+  }
+  key[k] = UINT64_MAX;
+
+  /* Build: each run climbs from its leaf, pushing a sentinel up */
+  for (uint32_t r = k; r > 0; r--) {
+    uint32_t s = r - 1;
+    for (uint32_t t = (s + k) / 2; t > 0; t /= 2) {
+      uint32_t o = tree[t];
+      if (key[o] > key[s] || (key[o] == key[s] && o < s)) {
+        tree[t] = s;
+        s = o;
+      }
+    }
+    tree[0] = s;
+  }
+
+  for (;;) {
+    uint32_t s = tree[0];
+    extsort_run_t * run = &runs[s];
+
+    if (key[s] == 0) break;
+    if (olen == buf_bytes) {
+      extsort_decode(obuf, olen / sample, sample);
+      if (write_full(out, obuf, olen) != 0) goto done;
+      olen = 0;
+    }
+    if (sample == 2) {
+      *(uint16_t *)(obuf + olen) = ((uint16_t *)run->buf)[run->pos];
+    } else {
+      *(uint32_t *)(obuf + olen) = ((uint32_t *)run->buf)[run->pos];
+    }
+    olen += sample;
+    if (++run->pos == run->len &&
+        run_fill(run, spill, buf_bytes, sample) != 0) {
+      goto done;
+    }
+    key[s] = run_key(run, sample);
+
+    /* Replay the winner's path against the stored losers */
+    for (uint32_t t = (s + k) / 2; t > 0; t /= 2) {
+      uint32_t o = tree[t];
+      if (key[o] > key[s] || (key[o] == key[s] && o < s)) {
+        tree[t] = s;
+        s = o;
+      }
+    }
+    tree[0] = s;
+  }
+  extsort_decode(obuf, olen / sample, sample);
+  ret = write_full(out, obuf, olen);
+
+done:
+  if (runs != NULL) {
+    for (uint32_t r = 0; r < k; r++) free(runs[r].buf);
+  }
+  free(runs);
+  free(tree);
+  free(key);
+  free(obuf);
+  return ret;
+}
+
+/**
+ * @brief Create and unlink the spill file in tmp_dir (or $TMPDIR, /tmp)
+ * @return File descriptor, or -1
+ */
+static int extsort_spill_open(const char * tmp_dir) {
+  char path[PATH_MAX];
+  int fd;
+
+  if (tmp_dir == NULL) tmp_dir = getenv("TMPDIR");
+  if (tmp_dir == NULL || tmp_dir[0] == '\0') tmp_dir = "/tmp";
+  if (snprintf(path, sizeof(path), "%s/c1m4_extsortXXXXXX", tmp_dir) >=
+      (int)sizeof(path)) {
+    return -1;
+  }
+  fd = mkstemp(path);
+  if (fd >= 0) unlink(path);
+  return fd;
+}
+
+int8_t extsort_file(const char * in_path, const char * out_path,
+                    capture_format_t format, size_t memory_bytes,
+                    const char * tmp_dir, extsort_stats_t * stats) {
+  extsort_stats_t local;
+  extsort_stats_t * st = stats != NULL ? stats : &local;
+  size_t sample = capture_sample_bytes(format);
+  size_t block_count, block_bytes;
+  uint64_t total, t0;
+  uint64_t * bounds = NULL;
+  uint8_t * block = NULL;
+  uint8_t * scratch = NULL;
+  uint32_t k = 0;
+  struct stat sb;
+  int in = -1, out = -1, spill = -1;
+  int8_t ret = -1;
+
+  my_memzero((uint8_t *)st, sizeof(*st));
+  if (sample == 0) return -1;
+  if (memory_bytes == 0) memory_bytes = EXTSORT_MEMORY_BYTES;
+
+  in = open(in_path, O_RDONLY);
+  if (in < 0) return -1;
+  if (fstat(in, &sb) != 0 || sb.st_size < 0) goto done;
+  total = (uint64_t)sb.st_size / sample;
+  st->samples = total;
+  st->bytes = total * sample;
+  posix_fadvise(in, 0, 0, POSIX_FADV_SEQUENTIAL);
+
+  /* Wider samples need a scratch array as large as the block */
+  block_count = memory_bytes / (sample == 1 ? 1 : 2 * sample);
+  if (block_count > UINT_MAX) block_count = UINT_MAX;
+  if (block_count < 1024) block_count = 1024;
+  if (block_count > total) block_count = total > 0 ? (size_t)total : 1;
+  block_bytes = block_count * sample;
+
+  block = (uint8_t *)malloc(block_bytes);
+  if (block == NULL) goto done;
+  if (sample == 1) {
+    ret = extsort_bytes(in, out_path, block, block_bytes, total, st);
+    goto done;
+  }
+  scratch = (uint8_t *)malloc(block_bytes);
+  if (scratch == NULL) goto done;
+
+  /* Run formation: one sorted run per block */
+  if (total > block_count) {
+    k = (uint32_t)((total + block_count - 1) / block_count);
+    bounds = (uint64_t *)malloc((k + 1) * sizeof(*bounds));
+    spill = extsort_spill_open(tmp_dir);
+    if (bounds == NULL || spill < 0) goto done;
+    bounds[0] = 0;
+  }
+  for (uint32_t r = 0; r == 0 || r < k; r++) {
+    uint64_t left = total - (uint64_t)r * block_count;
+    size_t count = left < block_count ? (size_t)left : block_count;
+
+    t0 = extsort_ns();
+    if (read_full(in, block, count * sample) != (ssize_t)(count * sample)) {
+      goto done;
+    }
+    st->read_ns += extsort_ns() - t0;
+
+    t0 = extsort_ns();
+    extsort_block(block, scratch, count, sample);
+    st->sort_ns += extsort_ns() - t0;
+
+    t0 = extsort_ns();
+    if (k == 0) {
+      /* Everything fit in one block: write the output directly */
+      extsort_decode(block, count, sample);
+      out = open(out_path, O_WRONLY | O_CREAT | O_TRUNC, 0666);
+      if (out < 0 || write_full(out, block, count * sample) != 0) goto done;
+    } else {
+      if (write_full(spill, block, count * sample) != 0) goto done;
+      bounds[r + 1] = bounds[r] + count * sample;
+    }
+    st->spill_ns += extsort_ns() - t0;
+  }
+  st->runs = k;
+  free(block);
+  free(scratch);
+  block = scratch = NULL;
+
+  if (k > 0) {
+    t0 = extsort_ns();
+    out = open(out_path, O_WRONLY | O_CREAT | O_TRUNC, 0666);
+    if (out < 0 ||
+        extsort_merge(spill, out, bounds, k, memory_bytes, sample) != 0) {
+      goto done;
+    }
+    st->merge_ns = extsort_ns() - t0;
+  }
+  ret = 0;
+
+done:
+  if (out >= 0 && close(out) != 0) ret = -1;
+  if (spill >= 0) close(spill);
+  close(in);
+  free(bounds);
+  free(block);
+  free(scratch);
+  return ret;
+}
+
+static unsigned long extsort_rate(uint64_t bytes, uint64_t ns) {
+  return ns ? (unsigned long)(bytes * 1000ULL / ns) : 0;
+}
+
+void print_extsort_stats(const extsort_stats_t * stats) {
+  PRINTF("  extsort: %llu samples, %u runs\n",
+         (unsigned long long)stats->samples, (unsigned)stats->runs);
+  PRINTF("    read   %10lu MB/s\n", extsort_rate(stats->bytes, stats->read_ns));
+  PRINTF("    sort   %10lu MB/s\n", extsort_rate(stats->bytes, stats->sort_ns));
+  PRINTF("    %-6s %10lu MB/s\n", stats->runs ? "spill" : "write",
+         extsort_rate(stats->bytes, stats->spill_ns));
+  if (stats->runs) {
+    PRINTF("    merge  %10lu MB/s\n",
+           extsort_rate(stats->bytes, stats->merge_ns));
+  }
+}
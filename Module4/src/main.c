@@ -2,7 +2,8 @@
  * @file main.c
  * @brief Application entry point switch for course1 demo
  *
- * Calls course1() when compiled with -DCOURSE1.
+ * Calls course1() when compiled with -DCOURSE1 and bench() when compiled
+ * with -DBENCH.
  *
  * This code was written as part of the Introduction to Embedded Systems
  * Software and Development Environments course (University of Colorado Boulder).
@@ -14,10 +15,14 @@
 
 #include "platform.h"
 #include "course1.h"
+#include "bench.h"
 
 int main(void) {
 #ifdef COURSE1
   course1();
+#endif
+#ifdef BENCH
+  bench();
 #endif
   return 0;
 }
@@ -18,12 +18,19 @@
  *  - get_value    : read a byte at an index
  *  - set_all      : fill a range with a value
  *  - clear_all    : zero a range
- *  - my_memmove   : safe move with overlap handling
- *  - my_memcopy   : simple copy (overlap undefined)
- *  - my_memset    : set memory to value
+ *  - set_bit / clear_bit / test_bit / toggle_bit : interrupt- and
+ *                  thread-safe single-bit access (bit-band on MSP432)
+ *  - count_bits / find_first_bit : word-wise bitset scans
+ *  - my_memmove   : block-wise move with overlap handling
+ *  - my_memcopy   : word/burst/vector copy (overlap undefined)
+ *  - my_memset    : set memory to value with wide stores
  *  - my_memzero   : zero out memory
- *  - my_reverse   : reverse byte order
- *  - reserve_words / free_words : dynamic allocation of 32-bit words
+ *  - my_memset16 / my_memset32 : fill typed arrays with a pattern
+ *  - my_memset_stream / my_memzero_stream : non-temporal fill (HOST)
+ *  - my_reverse   : reverse byte order (REV/bswap words, SSE shuffles)
+ *  - my_reverse16 / my_reverse32 : reverse 16/32-bit element order
+ *  - reserve_words / free_words : block pool allocation of 32-bit words,
+ *                                  heap fallback
  *
  * This code was written as part of the Introduction to Embedded Systems
  * Software and Development Environments course (University of Colorado Boulder).
@@ -34,10 +41,315 @@
  *****************************************************************************/
  
 #include "memory.h"
+#include "platform.h"
+#include "pool.h"
 #include <stdlib.h>
 #include <stdint.h>
 #include <stddef.h>
 
+#if defined (HOST) && defined (__AVX2__)
+#include <immintrin.h>
+#elif defined (HOST) && defined (__SSSE3__)
+#include <tmmintrin.h>
+#elif defined (HOST) && defined (__SSE2__)
+#include <emmintrin.h>
+#endif
+
+/* Word views of byte buffers (may_alias keeps them legal for any buffer) */
+typedef uint32_t __attribute__((__may_alias__)) mem_word_t;
+typedef uint32_t __attribute__((__may_alias__, __aligned__(1))) mem_uword_t;
+
+#define MEM_WORD_SIZE  (sizeof(uint32_t))
+#define MEM_WORD_MASK  ((uintptr_t)(MEM_WORD_SIZE - 1))
+
+/* Byte swap of a 32-bit word: REV on Cortex-M4, bswap on HOST */
+#if defined (MSP432)
+#define MEM_BSWAP32(x) __REV(x)
+#else
+#define MEM_BSWAP32(x) __builtin_bswap32(x)
+#endif
+
+/* Swap the two halfwords of a 32-bit word (a single ROR #16) */
+#define MEM_SWAP16X2(x) (((x) >> 16) | ((x) << 16))
+
+/* Destination alignment the block loops store with */
+#if defined (HOST) && defined (__AVX2__)
+#define MEM_ALIGN_MASK ((uintptr_t)31)
+#elif defined (HOST) && defined (__SSE2__)
+#define MEM_ALIGN_MASK ((uintptr_t)15)
+#else
+#define MEM_ALIGN_MASK MEM_WORD_MASK
+#endif
+
+/**
+ * @brief Copy the word/block body of a forward copy.
+ *
+ * The destination must already be aligned to MEM_ALIGN_MASK (block path) or
+ * to a word (word path). Each block is loaded completely before it is stored,
+ * so this is also safe for overlapping moves with dst below src.
+ *
+ * @param d      Destination pointer (aligned)
+ * @param s      Source pointer (any alignment)
+ * @param length Number of bytes available
+ * @return       Number of bytes copied; the tail is left to the caller
+ */
+static size_t copy_blocks_fwd(uint8_t * d, const uint8_t * s, size_t length) {
+  size_t done = 0;
+
+  if (length >= MEM_BLOCK_THRESHOLD) {
+#if defined (HOST) && defined (__AVX2__)
+    /* 4 x 32-byte vectors per iteration */
+    for (; length - done >= 128; done += 128) {
+      __m256i v0 = _mm256_loadu_si256((const __m256i *)(s + done));
+      __m256i v1 = _mm256_loadu_si256((const __m256i *)(s + done + 32));
+      __m256i v2 = _mm256_loadu_si256((const __m256i *)(s + done + 64));
+      __m256i v3 = _mm256_loadu_si256((const __m256i *)(s + done + 96));
+      _mm256_store_si256((__m256i *)(d + done), v0);
+      _mm256_store_si256((__m256i *)(d + done + 32), v1);
+      _mm256_store_si256((__m256i *)(d + done + 64), v2);
+      _mm256_store_si256((__m256i *)(d + done + 96), v3);
+    }
+#elif defined (HOST) && defined (__SSE2__)
+    /* 4 x 16-byte vectors per iteration */
+    for (; length - done >= 64; done += 64) {
+      __m128i v0 = _mm_loadu_si128((const __m128i *)(s + done));
+      __m128i v1 = _mm_loadu_si128((const __m128i *)(s + done + 16));
+      __m128i v2 = _mm_loadu_si128((const __m128i *)(s + done + 32));
+      __m128i v3 = _mm_loadu_si128((const __m128i *)(s + done + 48));
+      _mm_store_si128((__m128i *)(d + done), v0);
+      _mm_store_si128((__m128i *)(d + done + 16), v1);
+      _mm_store_si128((__m128i *)(d + done + 32), v2);
+      _mm_store_si128((__m128i *)(d + done + 48), v3);
+    }
+#elif defined (MSP432)
+    /* LDM/STM need an aligned source too: 4 words per burst */
+    if (((uintptr_t)s & MEM_WORD_MASK) == 0) {
+      const uint8_t * ps = s;
+      uint8_t * pd = d;
+      for (; length - done >= 16; done += 16) {
+        __ASM volatile ("ldmia %0!, {r3, r4, r5, r6}\n\t"
+                        "stmia %1!, {r3, r4, r5, r6}"
+                        : "+r" (ps), "+r" (pd)
+                        :
+                        : "r3", "r4", "r5", "r6", "memory");
+      }
+    }
+#endif
+  }
+
+  /* Remaining whole words; the source may be unaligned */
+  for (; length - done >= MEM_WORD_SIZE; done += MEM_WORD_SIZE) {
+    *(mem_word_t *)(d + done) = *(const mem_uword_t *)(s + done);
+  }
+  return done;
+}
+
+/**
+ * @brief Copy the word/block body of a backward copy.
+ *
+ * Mirror image of copy_blocks_fwd(): walks down from the end pointers, so it
+ * is safe for overlapping moves with dst above src.
+ *
+ * @param d      One past the last destination byte (aligned)
+ * @param s      One past the last source byte (any alignment)
+ * @param length Number of bytes available below the end pointers
+ * @return       Number of bytes copied; the head is left to the caller
+ */
+static size_t copy_blocks_bwd(uint8_t * d, const uint8_t * s, size_t length) {
+  size_t done = 0;
+
+  if (length >= MEM_BLOCK_THRESHOLD) {
+#if defined (HOST) && defined (__AVX2__)
+    for (; length - done >= 128; done += 128) {
+      __m256i v0 = _mm256_loadu_si256((const __m256i *)(s - done - 32));
+      __m256i v1 = _mm256_loadu_si256((const __m256i *)(s - done - 64));
+      __m256i v2 = _mm256_loadu_si256((const __m256i *)(s - done - 96));
+      __m256i v3 = _mm256_loadu_si256((const __m256i *)(s - done - 128));
+      _mm256_store_si256((__m256i *)(d - done - 32), v0);
+      _mm256_store_si256((__m256i *)(d - done - 64), v1);
+      _mm256_store_si256((__m256i *)(d - done - 96), v2);
+      _mm256_store_si256((__m256i *)(d - done - 128), v3);
+    }
+#elif defined (HOST) && defined (__SSE2__)
+    for (; length - done >= 64; done += 64) {
+      __m128i v0 = _mm_loadu_si128((const __m128i *)(s - done - 16));
+      __m128i v1 = _mm_loadu_si128((const __m128i *)(s - done - 32));
+      __m128i v2 = _mm_loadu_si128((const __m128i *)(s - done - 48));
+      __m128i v3 = _mm_loadu_si128((const __m128i *)(s - done - 64));
+      _mm_store_si128((__m128i *)(d - done - 16), v0);
+      _mm_store_si128((__m128i *)(d - done - 32), v1);
+      _mm_store_si128((__m128i *)(d - done - 48), v2);
+      _mm_store_si128((__m128i *)(d - done - 64), v3);
+    }
+#elif defined (MSP432)
+    if (((uintptr_t)s & MEM_WORD_MASK) == 0) {
+      const uint8_t * ps = s;
+      uint8_t * pd = d;
+      for (; length - done >= 16; done += 16) {
+        __ASM volatile ("ldmdb %0!, {r3, r4, r5, r6}\n\t"
+                        "stmdb %1!, {r3, r4, r5, r6}"
+                        : "+r" (ps), "+r" (pd)
+                        :
+                        : "r3", "r4", "r5", "r6", "memory");
+      }
+    }
+#endif
+  }
+
+  for (; length - done >= MEM_WORD_SIZE; done += MEM_WORD_SIZE) {
+    *(mem_word_t *)(d - done - MEM_WORD_SIZE) =
+      *(const mem_uword_t *)(s - done - MEM_WORD_SIZE);
+  }
+  return done;
+}
+
+/**
+ * @brief Fill engine: word/block stores of a replicated pattern, byte tail.
+ *
+ * @param d       Destination, word aligned unless length < MEM_WORD_THRESHOLD
+ * @param length  Number of bytes to fill
+ * @param pattern Fill word exactly as it must appear in memory at d
+ * @param stream  Non-zero to use non-temporal stores for the block body
+ *                (HOST SSE2/AVX2 only, ignored elsewhere)
+ */
+static void fill_fwd(uint8_t * d, size_t length, uint32_t pattern,
+                     uint8_t stream) {
+  size_t done = 0;
+
+  if (length >= MEM_WORD_THRESHOLD) {
+    if (length >= MEM_BLOCK_THRESHOLD) {
+      /* Word stores up to the block alignment */
+      while (((uintptr_t)(d + done) & MEM_ALIGN_MASK) != 0) {
+        *(mem_word_t *)(d + done) = pattern;
+        done += MEM_WORD_SIZE;
+      }
+#if defined (HOST) && defined (__AVX2__)
+      __m256i v = _mm256_set1_epi32((int)pattern);
+      if (stream) {
+        for (; length - done >= 128; done += 128) {
+          _mm256_stream_si256((__m256i *)(d + done), v);
+          _mm256_stream_si256((__m256i *)(d + done + 32), v);
+          _mm256_stream_si256((__m256i *)(d + done + 64), v);
+          _mm256_stream_si256((__m256i *)(d + done + 96), v);
+        }
+        _mm_sfence();
+      } else {
+        for (; length - done >= 128; done += 128) {
+          _mm256_store_si256((__m256i *)(d + done), v);
+          _mm256_store_si256((__m256i *)(d + done + 32), v);
+          _mm256_store_si256((__m256i *)(d + done + 64), v);
+          _mm256_store_si256((__m256i *)(d + done + 96), v);
+        }
+      }
+#elif defined (HOST) && defined (__SSE2__)
+      __m128i v = _mm_set1_epi32((int)pattern);
+      if (stream) {
+        for (; length - done >= 64; done += 64) {
+          _mm_stream_si128((__m128i *)(d + done), v);
+          _mm_stream_si128((__m128i *)(d + done + 16), v);
+          _mm_stream_si128((__m128i *)(d + done + 32), v);
+          _mm_stream_si128((__m128i *)(d + done + 48), v);
+        }
+        _mm_sfence();
+      } else {
+        for (; length - done >= 64; done += 64) {
+          _mm_store_si128((__m128i *)(d + done), v);
+          _mm_store_si128((__m128i *)(d + done + 16), v);
+          _mm_store_si128((__m128i *)(d + done + 32), v);
+          _mm_store_si128((__m128i *)(d + done + 48), v);
+        }
+      }
+#elif defined (MSP432)
+      /* STM bursts of 4 words */
+      uint32_t blocks = (uint32_t)((length - done) / 16);
+      if (blocks) {
+        uint8_t * pd = d + done;
+        done += (size_t)blocks * 16;
+        __ASM volatile ("mov r3, %2\n\t"
+                        "mov r4, %2\n\t"
+                        "mov r5, %2\n\t"
+                        "mov r6, %2\n"
+                        "1:\n\t"
+                        "stmia %0!, {r3, r4, r5, r6}\n\t"
+                        "subs %1, %1, #1\n\t"
+                        "bne 1b"
+                        : "+r" (pd), "+r" (blocks)
+                        : "r" (pattern)
+                        : "r3", "r4", "r5", "r6", "cc", "memory");
+      }
+#endif
+    }
+
+    for (; length - done >= MEM_WORD_SIZE; done += MEM_WORD_SIZE) {
+      *(mem_word_t *)(d + done) = pattern;
+    }
+  }
+
+  /* Tail (or the whole of a short fill), little-endian pattern phase */
+  for (; done < length; done++) {
+    *(d + done) = (uint8_t)(pattern >> (8 * (done & MEM_WORD_MASK)));
+  }
+}
+
+/**
+ * @brief Forward copy engine: aligned head, word/block body, byte tail.
+ *        Safe for disjoint regions and for overlaps with dst below src.
+ */
+static void copy_fwd(uint8_t * d, const uint8_t * s, size_t length) {
+  if (length >= MEM_WORD_THRESHOLD) {
+    uintptr_t mask = (length >= MEM_BLOCK_THRESHOLD) ? MEM_ALIGN_MASK
+                                                     : MEM_WORD_MASK;
+    size_t done;
+
+    /* Align the head so the body only does aligned stores */
+    while (((uintptr_t)d & mask) != 0) {
+      *d++ = *s++;
+      length--;
+    }
+
+    done = copy_blocks_fwd(d, s, length);
+    d += done;
+    s += done;
+    length -= done;
+  }
+
+  /* Tail (or the whole of a short copy) */
+  for (size_t i = 0; i < length; i++) {
+    *(d + i) = *(s + i);
+  }
+}
+
+/**
+ * @brief Backward copy engine: aligned tail, word/block body, byte head.
+ *        Safe for overlaps with dst above src.
+ */
+static void copy_bwd(uint8_t * dst, const uint8_t * src, size_t length) {
+  uint8_t * d = dst + length;
+  const uint8_t * s = src + length;
+
+  if (length >= MEM_WORD_THRESHOLD) {
+    uintptr_t mask = (length >= MEM_BLOCK_THRESHOLD) ? MEM_ALIGN_MASK
+                                                     : MEM_WORD_MASK;
+    size_t done;
+
+    /* Align the end so the body only does aligned stores */
+    while (((uintptr_t)d & mask) != 0) {
+      *--d = *--s;
+      length--;
+    }
+
+    done = copy_blocks_bwd(d, s, length);
+    d -= done;
+    s -= done;
+    length -= done;
+  }
+
+  /* Head (or the whole of a short move) */
+  while (length--) {
+    *--d = *--s;
+  }
+}
+
 /**
  * @brief Write a value into a memory buffer at a given index.
  * @param ptr   Pointer to start of buffer
@@ -88,6 +400,208 @@ void clear_all(char * ptr, unsigned int size) {
   set_all(ptr, 0, size);
 }
 
+#if defined (MSP432)
+/* SRAM bit-band: every bit of 0x20000000..0x200FFFFF has a word alias */
+#define MEM_BITBAND_SPAN ((uintptr_t)0x00100000)
+
+static inline uint8_t in_bitband(const uint8_t * byte) {
+  return ((uintptr_t)byte - SRAM_BASE) < MEM_BITBAND_SPAN;
+}
+
+static inline volatile uint32_t * bitband_alias(const uint8_t * byte,
+                                                uint32_t bit) {
+  return (volatile uint32_t *)(BITBAND_SRAM_BASE +
+                               ((uintptr_t)byte - SRAM_BASE) * 32u +
+                               bit * 4u);
+}
+
+static inline uint32_t bit_irq_save(void) {
+  uint32_t primask = __get_PRIMASK();
+  __disable_irq();
+  return primask;
+}
+#endif
+
+/* Index of the lowest set bit of a non-zero word */
+static inline uint32_t lowest_bit(uint32_t x) {
+#if defined (MSP432)
+  return __CLZ(__RBIT(x));
+#else
+  return (uint32_t)__builtin_ctz(x);
+#endif
+}
+
+static inline uint32_t popcount32(uint32_t x) {
+#if defined (HOST) && defined (__POPCNT__)
+  return (uint32_t)__builtin_popcount(x);
+#else
+  x = x - ((x >> 1) & 0x55555555u);
+  x = (x & 0x33333333u) + ((x >> 2) & 0x33333333u);
+  x = (x + (x >> 4)) & 0x0F0F0F0Fu;
+  return (x * 0x01010101u) >> 24;
+#endif
+}
+
+/**
+ * @brief Set one bit of a bitset.
+ * @param base Pointer to the bitset
+ * @param bit  Bit index
+ */
+void set_bit(uint8_t * base, size_t bit) {
+  uint8_t * byte = base + (bit >> 3);
+  uint8_t mask = (uint8_t)(1u << (bit & 7u));
+
+#if defined (MSP432)
+  if (in_bitband(byte)) {
+    *bitband_alias(byte, (uint32_t)(bit & 7u)) = 1u;
+  }
+  else {
+    uint32_t primask = bit_irq_save();
+    *byte |= mask;
+    __set_PRIMASK(primask);
+  }
+#else
+  __atomic_fetch_or(byte, mask, __ATOMIC_SEQ_CST);
+#endif
+}
+
+/**
+ * @brief Clear one bit of a bitset.
+ * @param base Pointer to the bitset
+ * @param bit  Bit index
+ */
+void clear_bit(uint8_t * base, size_t bit) {
+  uint8_t * byte = base + (bit >> 3);
+  uint8_t mask = (uint8_t)(1u << (bit & 7u));
+
+#if defined (MSP432)
+  if (in_bitband(byte)) {
+    *bitband_alias(byte, (uint32_t)(bit & 7u)) = 0u;
+  }
+  else {
+    uint32_t primask = bit_irq_save();
+    *byte &= (uint8_t)~mask;
+    __set_PRIMASK(primask);
+  }
+#else
+  __atomic_fetch_and(byte, (uint8_t)~mask, __ATOMIC_SEQ_CST);
+#endif
+}
+
+/**
+ * @brief Read one bit of a bitset.
+ * @param base Pointer to the bitset
+ * @param bit  Bit index
+ * @return 1 if the bit is set, 0 otherwise
+ */
+uint8_t test_bit(const uint8_t * base, size_t bit) {
+  const uint8_t * byte = base + (bit >> 3);
+
+#if defined (MSP432)
+  if (in_bitband(byte)) {
+    return (uint8_t)*bitband_alias(byte, (uint32_t)(bit & 7u));
+  }
+  return (uint8_t)((*(const volatile uint8_t *)byte >> (bit & 7u)) & 1u);
+#else
+  return (uint8_t)((__atomic_load_n(byte, __ATOMIC_SEQ_CST) >> (bit & 7u)) &
+                   1u);
+#endif
+}
+
+/**
+ * @brief Invert one bit of a bitset.
+ * @param base Pointer to the bitset
+ * @param bit  Bit index
+ * @return Previous value of the bit
+ */
+uint8_t toggle_bit(uint8_t * base, size_t bit) {
+  uint8_t * byte = base + (bit >> 3);
+  uint8_t mask = (uint8_t)(1u << (bit & 7u));
+  uint8_t old;
+
+#if defined (MSP432)
+  uint32_t primask = bit_irq_save();
+  if (in_bitband(byte)) {
+    volatile uint32_t * alias = bitband_alias(byte, (uint32_t)(bit & 7u));
+    old = (uint8_t)*alias;
+    *alias = old ^ 1u;
+  }
+  else {
+    old = (uint8_t)((*byte & mask) != 0);
+    *byte ^= mask;
+  }
+  __set_PRIMASK(primask);
+#else
+  old = (uint8_t)((__atomic_fetch_xor(byte, mask, __ATOMIC_SEQ_CST) & mask)
+                  != 0);
+#endif
+  return old;
+}
+
+/**
+ * @brief Count the set bits among the first nbits of a bitset.
+ * @param base  Pointer to the bitset
+ * @param nbits Number of bits to examine
+ * @return Number of set bits
+ */
+size_t count_bits(const uint8_t * base, size_t nbits) {
+  size_t bytes = nbits >> 3;
+  size_t count = 0;
+  size_t i = 0;
+
+  /* Head bytes up to word alignment, then whole words */
+  while (i < bytes && ((uintptr_t)(base + i) & MEM_WORD_MASK) != 0) {
+    count += popcount32(base[i++]);
+  }
+  for (; i + MEM_WORD_SIZE <= bytes; i += MEM_WORD_SIZE) {
+    count += popcount32((uint32_t)*(const mem_word_t *)(base + i));
+  }
+  for (; i < bytes; i++) {
+    count += popcount32(base[i]);
+  }
+  if (nbits & 7u) {
+    count += popcount32(base[bytes] & ((1u << (nbits & 7u)) - 1u));
+  }
+  return count;
+}
+
+/**
+ * @brief Find the lowest set bit among the first nbits of a bitset.
+ * @param base  Pointer to the bitset
+ * @param nbits Number of bits to examine
+ * @return Index of the first set bit, or -1 if none is set
+ */
+int32_t find_first_bit(const uint8_t * base, size_t nbits) {
+  size_t bytes = nbits >> 3;
+  size_t i = 0;
+
+  while (i < bytes && ((uintptr_t)(base + i) & MEM_WORD_MASK) != 0) {
+    if (base[i]) {
+      return (int32_t)(i * 8 + lowest_bit(base[i]));
+    }
+    i++;
+  }
+  /* Little-endian words keep bit n of byte k at bit 8k + n */
+  for (; i + MEM_WORD_SIZE <= bytes; i += MEM_WORD_SIZE) {
+    uint32_t w = (uint32_t)*(const mem_word_t *)(base + i);
+    if (w) {
+      return (int32_t)(i * 8 + lowest_bit(w));
+    }
+  }
+  for (; i < bytes; i++) {
+    if (base[i]) {
+      return (int32_t)(i * 8 + lowest_bit(base[i]));
+    }
+  }
+  if (nbits & 7u) {
+    uint32_t tail = base[bytes] & ((1u << (nbits & 7u)) - 1u);
+    if (tail) {
+      return (int32_t)(bytes * 8 + lowest_bit(tail));
+    }
+  }
+  return -1;
+}
+
 /**
  * @brief Move length bytes from src to dst, safe for overlapping regions.
  * @param src    Pointer to source memory
@@ -96,16 +610,18 @@ void clear_all(char * ptr, unsigned int size) {
  * @return       Pointer to dst
  */
 uint8_t * my_memmove(uint8_t * src, uint8_t * dst, size_t length) {
-  if (dst < src) {
-    /* Copy forward when dest is before src */
-    for (size_t i = 0; i < length; i++) {
-      *(dst + i) = *(src + i);
-    }
-  } else if (dst > src) {
-    /* Copy backward when dest overlaps src end */
-    for (size_t i = length; i > 0; i--) {
-      *(dst + i - 1) = *(src + i - 1);
-    }
+  uintptr_t s = (uintptr_t)src;
+  uintptr_t d = (uintptr_t)dst;
+
+  if (d + length <= s || s + length <= d) {
+    /* No overlap: straight to the non-overlapping copy */
+    return my_memcopy(src, dst, length);
+  } else if (d < s) {
+    /* Dest before src: forward blocks never clobber unread source */
+    copy_fwd(dst, src, length);
+  } else if (d > s) {
+    /* Dest overlaps src end: walk backward */
+    copy_bwd(dst, src, length);
   }
   return dst;
 }
@@ -118,9 +634,7 @@ uint8_t * my_memmove(uint8_t * src, uint8_t * dst, size_t length) {
  * @return       Pointer to dst
  */
 uint8_t * my_memcopy(uint8_t * src, uint8_t * dst, size_t length) {
-  for (size_t i = 0; i < length; i++) {
-    *(dst + i) = *(src + i);
-  }
+  copy_fwd(dst, src, length);
   return dst;
 }
 
@@ -132,9 +646,16 @@ uint8_t * my_memcopy(uint8_t * src, uint8_t * dst, size_t length) {
  * @return        Pointer to src
  */
 uint8_t * my_memset(uint8_t * src, size_t length, uint8_t value) {
-  for (size_t i = 0; i < length; i++) {
-    *(src + i) = value;
+  uint8_t * d = src;
+
+  if (length >= MEM_WORD_THRESHOLD) {
+    /* Align the head so the body only does aligned word stores */
+    while (((uintptr_t)d & MEM_WORD_MASK) != 0) {
+      *d++ = value;
+      length--;
+    }
   }
+  fill_fwd(d, length, value * 0x01010101UL, 0);
   return src;
 }
 
@@ -145,37 +666,236 @@ uint8_t * my_memset(uint8_t * src, size_t length, uint8_t value) {
  * @return       Pointer to src
  */
 uint8_t * my_memzero(uint8_t * src, size_t length) {
-  for (size_t i = 0; i < length; i++) {
-    *(src + i) = 0;
+  return my_memset(src, length, 0);
+}
+
+/**
+ * @brief Fill count 16-bit elements at dst with value.
+ * @param dst   Pointer to first element
+ * @param count Number of elements to set
+ * @param value Element value
+ * @return      Pointer to dst
+ */
+uint16_t * my_memset16(uint16_t * dst, size_t count, uint16_t value) {
+  uint8_t * d = (uint8_t *)dst;
+  size_t length = count * sizeof(uint16_t);
+
+  /* One element brings a 2-aligned pointer to a word boundary */
+  if (length && ((uintptr_t)d & MEM_WORD_MASK) != 0) {
+    *dst = value;
+    d += sizeof(uint16_t);
+    length -= sizeof(uint16_t);
   }
+  fill_fwd(d, length, value | ((uint32_t)value << 16), 0);
+  return dst;
+}
+
+/**
+ * @brief Fill count 32-bit elements at dst with value.
+ * @param dst   Pointer to first element
+ * @param count Number of elements to set
+ * @param value Element value
+ * @return      Pointer to dst
+ */
+uint32_t * my_memset32(uint32_t * dst, size_t count, uint32_t value) {
+  fill_fwd((uint8_t *)dst, count * sizeof(uint32_t), value, 0);
+  return dst;
+}
+
+/**
+ * @brief Fill length bytes at src with value, bypassing the cache.
+ *
+ * Buffers of MEM_STREAM_THRESHOLD bytes or more are written with
+ * non-temporal stores on HOST so they do not evict the working set. Smaller
+ * buffers, and every buffer on MSP432 (no data cache), use my_memset.
+ *
+ * @param src     Pointer to start of memory
+ * @param length  Number of bytes to set
+ * @param value   Value to set each byte to
+ * @return        Pointer to src
+ */
+uint8_t * my_memset_stream(uint8_t * src, size_t length, uint8_t value) {
+#if defined (HOST) && defined (__SSE2__)
+  uint8_t * d = src;
+
+  if (length < MEM_STREAM_THRESHOLD) {
+    return my_memset(src, length, value);
+  }
+  while (((uintptr_t)d & MEM_WORD_MASK) != 0) {
+    *d++ = value;
+    length--;
+  }
+  fill_fwd(d, length, value * 0x01010101UL, 1);
   return src;
+#else
+  return my_memset(src, length, value);
+#endif
 }
 
+/**
+ * @brief Zero out length bytes at src, bypassing the cache.
+ * @param src    Pointer to start of memory
+ * @param length Number of bytes to zero
+ * @return       Pointer to src
+ */
+uint8_t * my_memzero_stream(uint8_t * src, size_t length) {
+  return my_memset_stream(src, length, 0);
+}
+
+#if defined (HOST) && defined (__SSE2__)
+/**
+ * @brief Reverse the 16 bytes of a vector (PSHUFB with SSSE3, else SSE2
+ *        dword/word shuffles plus a byte swap inside each 16-bit lane)
+ */
+static __m128i reverse_bytes128(__m128i v) {
+#if defined (__SSSE3__)
+  const __m128i mask = _mm_set_epi8(0, 1, 2, 3, 4, 5, 6, 7,
+                                    8, 9, 10, 11, 12, 13, 14, 15);
+  return _mm_shuffle_epi8(v, mask);
+#else
+  v = _mm_shuffle_epi32(v, _MM_SHUFFLE(0, 1, 2, 3));
+  v = _mm_shufflelo_epi16(v, _MM_SHUFFLE(2, 3, 0, 1));
+  v = _mm_shufflehi_epi16(v, _MM_SHUFFLE(2, 3, 0, 1));
+  return _mm_or_si128(_mm_slli_epi16(v, 8), _mm_srli_epi16(v, 8));
+#endif
+}
+#endif
+
 /**
  * @brief Reverse the order of length bytes at src.
+ *
+ * Swaps 16-byte vectors (HOST) and then 32-bit words (byte-reversed with
+ * REV/bswap) from both ends, finishing the middle byte by byte. Any length
+ * is valid, including zero.
+ *
  * @param src    Pointer to start of memory
  * @param length Number of bytes to reverse
  * @return       Pointer to src
  */
 uint8_t * my_reverse(uint8_t * src, size_t length) {
-  size_t start = 0, end = length - 1;
-  while (start < end) {
-    uint8_t tmp = *(src + start);
-    *(src + start) = *(src + end);
-    *(src + end)   = tmp;
-    start++;
-    end--;
+  uint8_t * lo = src;
+  uint8_t * hi = src + length;   /* One past the last byte */
+
+#if defined (HOST) && defined (__SSE2__)
+  while (hi - lo >= 32) {
+    __m128i a = _mm_loadu_si128((const __m128i *)lo);
+    __m128i b = _mm_loadu_si128((const __m128i *)(hi - 16));
+    _mm_storeu_si128((__m128i *)lo, reverse_bytes128(b));
+    _mm_storeu_si128((__m128i *)(hi - 16), reverse_bytes128(a));
+    lo += 16;
+    hi -= 16;
+  }
+#endif
+
+  while (hi - lo >= 2 * (ptrdiff_t)MEM_WORD_SIZE) {
+    uint32_t a = *(const mem_uword_t *)lo;
+    uint32_t b = *(const mem_uword_t *)(hi - MEM_WORD_SIZE);
+    *(mem_uword_t *)lo = MEM_BSWAP32(b);
+    *(mem_uword_t *)(hi - MEM_WORD_SIZE) = MEM_BSWAP32(a);
+    lo += MEM_WORD_SIZE;
+    hi -= MEM_WORD_SIZE;
+  }
+
+  while (hi - lo >= 2) {
+    uint8_t tmp = *lo;
+    *lo++ = *--hi;
+    *hi = tmp;
+  }
+  return src;
+}
+
+/**
+ * @brief Reverse the order of count 16-bit elements at src.
+ * @param src   Pointer to first element
+ * @param count Number of elements to reverse
+ * @return      Pointer to src
+ */
+uint16_t * my_reverse16(uint16_t * src, size_t count) {
+  uint16_t * lo = src;
+  uint16_t * hi = src + count;
+
+#if defined (HOST) && defined (__SSE2__)
+  while (hi - lo >= 16) {
+    __m128i a = _mm_loadu_si128((const __m128i *)lo);
+    __m128i b = _mm_loadu_si128((const __m128i *)(hi - 8));
+    a = _mm_shuffle_epi32(a, _MM_SHUFFLE(0, 1, 2, 3));
+    a = _mm_shufflehi_epi16(_mm_shufflelo_epi16(a, _MM_SHUFFLE(2, 3, 0, 1)),
+                            _MM_SHUFFLE(2, 3, 0, 1));
+    b = _mm_shuffle_epi32(b, _MM_SHUFFLE(0, 1, 2, 3));
+    b = _mm_shufflehi_epi16(_mm_shufflelo_epi16(b, _MM_SHUFFLE(2, 3, 0, 1)),
+                            _MM_SHUFFLE(2, 3, 0, 1));
+    _mm_storeu_si128((__m128i *)lo, b);
+    _mm_storeu_si128((__m128i *)(hi - 8), a);
+    lo += 8;
+    hi -= 8;
+  }
+#endif
+
+  /* Element pairs from both ends; swapping halfwords reverses a pair */
+  while (hi - lo >= 4) {
+    uint32_t a = *(const mem_uword_t *)lo;
+    uint32_t b = *(const mem_uword_t *)(hi - 2);
+    *(mem_uword_t *)lo = MEM_SWAP16X2(b);
+    *(mem_uword_t *)(hi - 2) = MEM_SWAP16X2(a);
+    lo += 2;
+    hi -= 2;
+  }
+
+  while (hi - lo >= 2) {
+    uint16_t tmp = *lo;
+    *lo++ = *--hi;
+    *hi = tmp;
+  }
+  return src;
+}
+
+/**
+ * @brief Reverse the order of count 32-bit elements at src.
+ * @param src   Pointer to first element
+ * @param count Number of elements to reverse
+ * @return      Pointer to src
+ */
+uint32_t * my_reverse32(uint32_t * src, size_t count) {
+  uint32_t * lo = src;
+  uint32_t * hi = src + count;
+
+#if defined (HOST) && defined (__SSE2__)
+  while (hi - lo >= 8) {
+    __m128i a = _mm_loadu_si128((const __m128i *)lo);
+    __m128i b = _mm_loadu_si128((const __m128i *)(hi - 4));
+    _mm_storeu_si128((__m128i *)lo,
+                     _mm_shuffle_epi32(b, _MM_SHUFFLE(0, 1, 2, 3)));
+    _mm_storeu_si128((__m128i *)(hi - 4),
+                     _mm_shuffle_epi32(a, _MM_SHUFFLE(0, 1, 2, 3)));
+    lo += 4;
+    hi -= 4;
+  }
+#endif
+
+  while (hi - lo >= 2) {
+    uint32_t tmp = *lo;
+    *lo++ = *--hi;
+    *hi = tmp;
   }
   return src;
 }
 
 /**
  * @brief Dynamically allocate a buffer of length 32-bit words.
+ *
+ * Served in O(1) from the block pool; requests larger than a block, or made
+ * while the pool is exhausted, fall back to malloc.
+ *
  * @param length Number of 32-bit words to allocate
  * @return       Pointer to allocated buffer, or NULL if allocation fails
  */
 int32_t * reserve_words(size_t length) {
-  return (int32_t *) malloc(length * sizeof(int32_t));
+  int32_t * ptr = pool_alloc(length);
+
+  if (ptr == NULL) {
+    ptr = (int32_t *) malloc(length * sizeof(int32_t));
+  }
+  return ptr;
 }
 
 /**
@@ -183,6 +903,10 @@ int32_t * reserve_words(size_t length) {
  * @param src Pointer returned by reserve_words
  */
 void free_words(int32_t * src) {
-  free(src);
+  if (pool_owns(src)) {
+    pool_free(src);
+  } else {
+    free(src);
+  }
 }
 
@@ -0,0 +1,225 @@
+/*****************************************************************************
+ * @file mtpool.c
+ * @brief Implementation of the thread-safe block pool (HOST)
+ *
+ * The global free list is addressed by block index, so its head fits in one
+ * 64-bit word: the low half is index + 1 (0 = empty) and the high half is a
+ * tag incremented by every successful compare-and-swap. Blocks never handed
+ * out yet come from an atomic bump index, so no initialisation pass is
+ * needed. Thread caches are plain thread-local arrays; a pthread key
+ * destructor spills them back when a thread exits.
+ *
+ * This code was written as part of the Introduction to Embedded Systems
+ * Software and Development Environments course (University of Colorado Boulder).
+ *
+ * @author Timofei Alekseenko
+ * @date October 17, 2026
+ *
+ *****************************************************************************/
+
+#define _POSIX_C_SOURCE 200809L   /* pthread keys */
+
+#include "mtpool.h"
+#include <stdint.h>
+#include <stddef.h>
+#include <stdlib.h>
+#include <pthread.h>
+
+#define MTPOOL_EMPTY (0u)
+
+typedef union {
+  uint32_t next;                      /* Index + 1 of the next free block */
+  int32_t words[MTPOOL_BLOCK_WORDS];
+} mtpool_block_t;
+
+typedef struct {
+  uint32_t count;
+  uint32_t idx[MTPOOL_CACHE_SIZE];    /* Cached free block indices */
+} mtpool_cache_t;
+
+static mtpool_block_t mtpool_storage[MTPOOL_BLOCK_COUNT]
+  __attribute__((aligned(64)));
+
+/* Tagged head of the global free list: tag << 32 | (index + 1) */
+static uint64_t mtpool_head __attribute__((aligned(64))) = 0;
+static uint32_t mtpool_untouched __attribute__((aligned(64))) = 0;
+
+static uint32_t mtpool_outstanding = 0;
+static uint32_t mtpool_high_water = 0;
+static uint32_t mtpool_misses = 0;
+
+static __thread mtpool_cache_t mtpool_cache;
+static __thread uint8_t mtpool_registered = 0;
+static pthread_key_t mtpool_key;
+static pthread_once_t mtpool_key_once = PTHREAD_ONCE_INIT;
+
+static void mtpool_account(int32_t delta) {
+  uint32_t now = __atomic_add_fetch(&mtpool_outstanding, (uint32_t)delta,
+                                    __ATOMIC_RELAXED);
+  uint32_t peak = __atomic_load_n(&mtpool_high_water, __ATOMIC_RELAXED);
+
+  while (now > peak &&
+         !__atomic_compare_exchange_n(&mtpool_high_water, &peak, now, 1,
+                                      __ATOMIC_RELAXED, __ATOMIC_RELAXED)) {
+  }
+}
+
+/**
+ * @brief Pop one block from the global list
+ * @return Block index, or -1 if the list is empty
+ */
+static int64_t global_pop(void) {
+  uint64_t head = __atomic_load_n(&mtpool_head, __ATOMIC_ACQUIRE);
+  uint64_t next;
+
+  do {
+    uint32_t top = (uint32_t)head;
+    if (top == MTPOOL_EMPTY) {
+      return -1;
+    }
+    /* May read a stale link if another thread wins; the tag rejects it */
+    next = ((head >> 32) + 1) << 32 |
+           __atomic_load_n(&mtpool_storage[top - 1].next, __ATOMIC_RELAXED);
+  } while (!__atomic_compare_exchange_n(&mtpool_head, &head, next, 1,
+                                        __ATOMIC_ACQ_REL, __ATOMIC_ACQUIRE));
+  return (int64_t)(uint32_t)head - 1;
+}
+
+/**
+ * @brief Push a pre-linked chain first..last onto the global list in one CAS
+ */
+static void global_push_chain(uint32_t first, uint32_t last) {
+  uint64_t head = __atomic_load_n(&mtpool_head, __ATOMIC_RELAXED);
+  uint64_t next;
+
+  do {
+    __atomic_store_n(&mtpool_storage[last].next, (uint32_t)head,
+                     __ATOMIC_RELAXED);
+    next = ((head >> 32) + 1) << 32 | (first + 1);
+  } while (!__atomic_compare_exchange_n(&mtpool_head, &head, next, 1,
+                                        __ATOMIC_RELEASE, __ATOMIC_RELAXED));
+}
+
+/**
+ * @brief Move the newest count cached blocks to the global list
+ */
+static void cache_spill(mtpool_cache_t * cache, uint32_t count) {
+  uint32_t first, i;
+
+  if (count == 0) {
+    return;
+  }
+  first = cache->idx[cache->count - 1];
+  for (i = 1; i < count; i++) {
+    __atomic_store_n(&mtpool_storage[cache->idx[cache->count - i]].next,
+                     cache->idx[cache->count - i - 1] + 1, __ATOMIC_RELAXED);
+  }
+  global_push_chain(first, cache->idx[cache->count - count]);
+  cache->count -= count;
+  mtpool_account(-(int32_t)count);
+}
+
+static void mtpool_destructor(void * arg) {
+  cache_spill((mtpool_cache_t *)arg, ((mtpool_cache_t *)arg)->count);
+}
+
+static void mtpool_make_key(void) {
+  pthread_key_create(&mtpool_key, mtpool_destructor);
+}
+
+/**
+ * @brief Bind the thread's cache to mtpool_key on first use, so the
+ *        destructor spills it when the thread exits
+ */
+static void cache_register(mtpool_cache_t * cache) {
+  if (!mtpool_registered) {
+    pthread_once(&mtpool_key_once, mtpool_make_key);
+    pthread_setspecific(mtpool_key, cache);
+    mtpool_registered = 1;
+  }
+}
+
+/**
+ * @brief Refill an empty cache with up to half its capacity
+ */
+static void cache_refill(mtpool_cache_t * cache) {
+  uint32_t got = 0;
+
+  cache_register(cache);
+  while (got < MTPOOL_CACHE_SIZE / 2) {
+    int64_t idx = global_pop();
+    if (idx < 0) {
+      /* Global list empty: carve blocks that were never used. The counter
+         stops at MTPOOL_BLOCK_COUNT, so endless misses cannot wrap it */
+      uint32_t fresh = __atomic_load_n(&mtpool_untouched, __ATOMIC_RELAXED);
+      do {
+        if (fresh >= MTPOOL_BLOCK_COUNT) {
+          break;
+        }
+      } while (!__atomic_compare_exchange_n(&mtpool_untouched, &fresh,
+                                            fresh + 1, 1, __ATOMIC_RELAXED,
+                                            __ATOMIC_RELAXED));
+      if (fresh >= MTPOOL_BLOCK_COUNT) {
+        break;
+      }
+      idx = fresh;
+    }
+    cache->idx[cache->count++] = (uint32_t)idx;
+    got++;
+  }
+  if (got) {
+    mtpool_account((int32_t)got);
+  }
+}
+
+int32_t * mtpool_reserve_words(size_t length) {
+  mtpool_cache_t * cache = &mtpool_cache;
+
+  if (length <= MTPOOL_BLOCK_WORDS) {
+    if (cache->count == 0) {
+      cache_refill(cache);
+    }
+    if (cache->count) {
+      return mtpool_storage[cache->idx[--cache->count]].words;
+    }
+  }
+
+  __atomic_add_fetch(&mtpool_misses, 1, __ATOMIC_RELAXED);
+  return (int32_t *) malloc(length * sizeof(int32_t));
+}
+
+void mtpool_free_words(int32_t * src) {
+  mtpool_cache_t * cache = &mtpool_cache;
+
+  if (!mtpool_owns(src)) {
+    free(src);
+    return;
+  }
+  /* A thread may only ever free, e.g. a consumer of another's blocks */
+  cache_register(cache);
+  if (cache->count == MTPOOL_CACHE_SIZE) {
+    cache_spill(cache, MTPOOL_CACHE_SIZE / 2);
+  }
+  cache->idx[cache->count++] =
+    (uint32_t)((mtpool_block_t *)src - mtpool_storage);
+}
+
+uint8_t mtpool_owns(const int32_t * src) {
+  uintptr_t p = (uintptr_t)src;
+  uintptr_t base = (uintptr_t)mtpool_storage;
+
+  return (p >= base && p < base + sizeof(mtpool_storage) &&
+          (p - base) % sizeof(mtpool_block_t) == 0);
+}
+
+void mtpool_thread_flush(void) {
+  cache_spill(&mtpool_cache, mtpool_cache.count);
+}
+
+void mtpool_get_stats(mtpool_stats_t * stats) {
+  stats->block_words = MTPOOL_BLOCK_WORDS;
+  stats->block_count = MTPOOL_BLOCK_COUNT;
+  stats->outstanding = __atomic_load_n(&mtpool_outstanding, __ATOMIC_RELAXED);
+  stats->high_water = __atomic_load_n(&mtpool_high_water, __ATOMIC_RELAXED);
+  stats->misses = __atomic_load_n(&mtpool_misses, __ATOMIC_RELAXED);
+}
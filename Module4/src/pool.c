@@ -0,0 +1,95 @@
+/*****************************************************************************
+ * @file pool.c
+ * @brief Implementation of the fixed-size block pool
+ *
+ * Free blocks form an intrusive singly linked list (the link is stored in the
+ * block itself). Blocks never handed out yet are taken from a bump index, so
+ * the pool needs no O(n) initialisation and every operation is O(1).
+ *
+ * This code was written as part of the Introduction to Embedded Systems
+ * Software and Development Environments course (University of Colorado Boulder).
+ *
+ * @author Timofei Alekseenko
+ * @date October 17, 2026
+ *
+ *****************************************************************************/
+
+#include "pool.h"
+#include "platform.h"
+#include <stdint.h>
+#include <stddef.h>
+
+/* MSP432: dedicated (NOLOAD) linker section, see msp432p401r.lds */
+#if defined (MSP432)
+#define POOL_SECTION __attribute__((section(".pool")))
+#else
+#define POOL_SECTION
+#endif
+
+typedef union pool_block {
+  union pool_block * next;           /* Link while the block is free */
+  int32_t words[POOL_BLOCK_WORDS];
+} pool_block_t;
+
+static pool_block_t pool_storage[POOL_BLOCK_COUNT] POOL_SECTION;
+
+static pool_block_t * pool_free_list = NULL;
+static uint32_t pool_untouched = 0;  /* Blocks never allocated start here */
+static pool_stats_t pool_stats = {POOL_BLOCK_WORDS, POOL_BLOCK_COUNT,
+                                  0, 0, 0, 0};
+
+int32_t * pool_alloc(size_t length) {
+  pool_block_t * block;
+
+  if (length > POOL_BLOCK_WORDS) {
+    pool_stats.misses++;
+    return NULL;
+  }
+
+  if (pool_free_list != NULL) {
+    block = pool_free_list;
+    pool_free_list = block->next;
+  } else if (pool_untouched < POOL_BLOCK_COUNT) {
+    block = &pool_storage[pool_untouched++];
+  } else {
+    pool_stats.misses++;
+    return NULL;
+  }
+
+  pool_stats.allocs++;
+  if (++pool_stats.in_use > pool_stats.high_water) {
+    pool_stats.high_water = pool_stats.in_use;
+  }
+  return block->words;
+}
+
+void pool_free(int32_t * src) {
+  pool_block_t * block = (pool_block_t *)src;
+
+  block->next = pool_free_list;
+  pool_free_list = block;
+  pool_stats.in_use--;
+}
+
+uint8_t pool_owns(const int32_t * src) {
+  uintptr_t p = (uintptr_t)src;
+  uintptr_t base = (uintptr_t)pool_storage;
+
+  return (p >= base && p < base + sizeof(pool_storage) &&
+          (p - base) % sizeof(pool_block_t) == 0);
+}
+
+void pool_get_stats(pool_stats_t * stats) {
+  *stats = pool_stats;
+}
+
+void print_pool_stats(void) {
+#ifdef VERBOSE
+  PRINTF("\nPool (%u x %u words):\n", (unsigned)pool_stats.block_count,
+         (unsigned)pool_stats.block_words);
+  PRINTF("  In use: %u, high-water: %u\n", (unsigned)pool_stats.in_use,
+         (unsigned)pool_stats.high_water);
+  PRINTF("  Allocs: %u, misses (heap fallback): %u\n",
+         (unsigned)pool_stats.allocs, (unsigned)pool_stats.misses);
+#endif
+}
@@ -0,0 +1,48 @@
+/*****************************************************************************
+ * @file radix.c
+ * @brief Implementation of the radix sorts for 16-bit and 32-bit samples
+ *
+ * radix_template.h is expanded once per key type. On HOST the _mt
+ * variants run each phase (key range, bucket counts, scatter, bucket
+ * sorts) as a tpool job over 2 chunks per thread, or one task per bucket.
+ *
+ * This code was written as part of the Introduction to Embedded Systems
+ * Software and Development Environments course (University of Colorado Boulder).
+ *
+ * @author Timofei Alekseenko
+ * @date October 17, 2026
+ *
+ *****************************************************************************/
+
+#include "radix.h"
+#include "stats.h"
+#include "memory.h"
+#include <stdint.h>
+
+#if defined (HOST)
+#include "tpool.h"
+#include <stdlib.h>
+
+/* Two chunks per thread, at most */
+#define RADIX_MAX_CHUNKS (2 * TPOOL_MAX_THREADS)
+
+/* [begin, end) of chunk index when size samples are cut into chunks */
+static void chunk_bounds(unsigned int size, unsigned int chunks,
+                         uint32_t index, unsigned int *begin,
+                         unsigned int *end) {
+  *begin = (unsigned int)((uint64_t)size * index / chunks);
+  *end = (unsigned int)((uint64_t)size * (index + 1) / chunks);
+}
+#endif
+
+#define RADIX_SFX u16
+#define RADIX_T uint16_t
+#define RADIX_KEY_BITS 16
+#define RADIX_WIDE_BITS 8
+#include "radix_template.h"
+
+#define RADIX_SFX u32
+#define RADIX_T uint32_t
+#define RADIX_KEY_BITS 32
+#define RADIX_WIDE_BITS RADIX_DIGIT_BITS_U32
+#include "radix_template.h"
@@ -36,6 +36,9 @@
 
 #include <stdint.h>
 
+/* Top of SRAM_DATA, from the linker script */
+extern uint32_t __StackTop;
+
 /* Forward declaration of the default fault handlers. */
 extern void Reset_Handler(void);
 extern void NMI_Handler(void);
@@ -96,7 +99,7 @@ extern void PORT6_IRQHandler(void);
 /* the program if located at a start address other than 0.                            */
 void (* const interruptVectors[])(void) __attribute__ ((section (".intvecs"))) =
 {
-    (void (*)(void))((uint32_t)0x20004000),
+    (void (*)(void))&__StackTop,
                                             /* The initial stack pointer */
     &Reset_Handler,                         /* The reset handler         */
     &NMI_Handler,                           /* The NMI handler           */
@@ -13,8 +13,18 @@
  * @brief Implementation of statistical array analysis with optional debug print
  *
  * This file contains functions to analyze unsigned char arrays:
- * - Calculate statistics (max, min, mean, median)
- * - Sort arrays in descending order
+ * - Calculate statistics (max, min, mean, median); min, max and sum run
+ *   4 bytes per instruction on MSP432 (USUB8/SEL, USADA8) and 16/32 bytes
+ *   on HOST (PMAXUB/PMINUB/PSADBW), picked at build time
+ * - Variance and standard deviation (integer and Q8 fixed point), integer
+ *   square root, percentiles and binned histograms, all in integer math
+ * - On HOST, histograms of large arrays (and so median, percentiles and
+ *   compute_statistics) are counted in parallel on the tpool workers
+ * - Sort arrays in descending order (sorting networks for 8/16/32/40
+ *   elements, otherwise insertion sort, introsort or counting sort
+ *   depending on the size)
+ * - Top-k extraction and partial sorts for callers that only need the
+ *   largest few values
  * - Print formatted results (only when VERBOSE is defined)
  *
  * This code was written as part of the Introduction to Embedded Systems
@@ -26,7 +36,21 @@
  *****************************************************************************/
 
 #include "stats.h"
+#include "sort_network.h"
 #include "platform.h"
+#include "memory.h"
+#include <stdint.h>
+
+#if defined (HOST)
+#include "tpool.h"
+#include <stdlib.h>
+#endif
+
+#if defined (HOST) && defined (__AVX2__)
+#include <immintrin.h>
+#elif defined (HOST) && defined (__SSE2__)
+#include <emmintrin.h>
+#endif
 
 #define SIZE (40) // Size of the Data Set
 
@@ -55,14 +79,143 @@
 */
 
 /**
- * @brief Print statistics: max, min, mean, median
+ * @brief Print statistics: max, min, mean, median (one pass over the data)
  */
 void print_statistics(unsigned char *data, unsigned int size) {
+  stats_result_t result;
+
+  compute_statistics(data, size, &result);
+  print_stats_result(&result);
+}
+
+void print_stats_result(const stats_result_t *result) {
   PRINTF("\nStatistics:\n");
-  PRINTF("Maximum: %d\n", find_maximum(data, size));
-  PRINTF("Minimum: %d\n", find_minimum(data, size));
-  PRINTF("Mean: %d\n", find_mean(data, size));
-  PRINTF("Median: %d\n", find_median(data, size));
+  PRINTF("Maximum: %d\n", result->maximum);
+  PRINTF("Minimum: %d\n", result->minimum);
+  PRINTF("Mean: %d\n", result->mean);
+  PRINTF("Median: %d\n", result->median);
+}
+
+/**
+ * @brief Count each byte value; large HOST inputs spread the counts over
+ *        several tables so runs of equal bytes do not serialise on one
+ *        counter
+ */
+static void count_bytes(const unsigned char *data, unsigned int size,
+                        uint32_t counts[256]) {
+  my_memzero((uint8_t *)counts, 256 * sizeof(uint32_t));
+#if defined (HOST)
+  if (size >= 1024) {
+    uint32_t lanes[3][256] = {{0}};
+    unsigned int i = 0;
+
+    for (; i + 4 <= size; i += 4) {
+      counts[data[i]]++;
+      lanes[0][data[i + 1]]++;
+      lanes[1][data[i + 2]]++;
+      lanes[2][data[i + 3]]++;
+    }
+    for (; i < size; i++) counts[data[i]]++;
+    for (unsigned int v = 0; v < 256; v++) {
+      counts[v] += lanes[0][v] + lanes[1][v] + lanes[2][v];
+    }
+    return;
+  }
+#endif
+  for (unsigned int i = 0; i < size; i++) counts[data[i]]++;
+}
+
+#if defined (HOST)
+typedef struct {
+  const unsigned char *data;
+  unsigned int size;
+  unsigned int chunks;
+  uint32_t (*parts)[256];   /* One histogram per chunk */
+} histogram_job_t;
+
+static void histogram_chunk(void *arg, uint32_t index) {
+  histogram_job_t *job = (histogram_job_t *)arg;
+  unsigned int begin = (unsigned int)((uint64_t)job->size * index / job->chunks);
+  unsigned int end = (unsigned int)((uint64_t)job->size * (index + 1) /
+                                    job->chunks);
+
+  count_bytes(job->data + begin, end - begin, job->parts[index]);
+}
+#endif
+
+/**
+ * @brief Histogram of the whole array
+ *
+ * From STATS_PARALLEL_MIN bytes on, HOST splits the array into chunks
+ * counted on the thread pool and adds the partial histograms. Everything
+ * derived from the histogram (min, max, sum, median, ...) is therefore
+ * the same whichever way it was built.
+ */
+static void build_histogram(const unsigned char *data, unsigned int size,
+                            uint32_t counts[256]) {
+#if defined (HOST)
+  if (size >= STATS_PARALLEL_MIN && tpool_threads() > 1) {
+    histogram_job_t job;
+
+    /* Two chunks per thread, so a slow thread does not hold up the rest */
+    job.data = data;
+    job.size = size;
+    job.chunks = 2 * tpool_threads();
+    job.parts = (uint32_t (*)[256])malloc(job.chunks * sizeof(*job.parts));
+    if (job.parts != NULL) {
+      tpool_run(histogram_chunk, &job, job.chunks);
+      my_memcopy((uint8_t *)job.parts[0], (uint8_t *)counts,
+                 sizeof(job.parts[0]));
+      for (unsigned int c = 1; c < job.chunks; c++) {
+        for (unsigned int v = 0; v < 256; v++) counts[v] += job.parts[c][v];
+      }
+      free(job.parts);
+      return;
+    }
+  }
+#endif
+  count_bytes(data, size, counts);
+}
+
+/* k-th largest value of a histogram holding more than k samples */
+static unsigned char histogram_kth(const uint32_t counts[256], unsigned int k) {
+  unsigned int seen = 0;
+  int value;
+
+  for (value = 255; value > 0; value--) {
+    seen += counts[value];
+    if (seen > k) break;
+  }
+  return (unsigned char)value;
+}
+
+void compute_statistics(unsigned char *data, unsigned int size,
+                        stats_result_t *result) {
+  uint64_t sum = 0;
+  int value;
+
+  build_histogram(data, size, result->histogram);
+  result->count = size;
+  result->minimum = 0;
+  result->maximum = 0;
+  result->mean = 0;
+  result->median = 0;
+  result->sum = 0;
+  if (size == 0) return;
+
+  /* Everything else comes from the 256 bins, not from the data */
+  for (value = 0; value < 256; value++) {
+    sum += (uint64_t)result->histogram[value] * (unsigned int)value;
+  }
+  for (value = 0; result->histogram[value] == 0; value++) {
+  }
+  result->minimum = (unsigned char)value;
+  for (value = 255; result->histogram[value] == 0; value--) {
+  }
+  result->maximum = (unsigned char)value;
+  result->sum = sum;
+  result->mean = (unsigned char)(sum / size);
+  result->median = histogram_kth(result->histogram, size / 2);
 }
 
 /**
@@ -77,41 +230,835 @@ void print_array(unsigned char *data, unsigned int size) {
 #endif
 }
 
+/* Median = data[size / 2] of the descending sort, read off a histogram */
 unsigned char find_median(unsigned char *data, unsigned int size) {
-  sort_array(data, size); // Median requires sorting
-  return data[size / 2];
+  return find_kth(data, size, size / 2);
+}
+
+unsigned char find_kth(unsigned char *data, unsigned int size,
+                       unsigned int k) {
+  uint32_t counts[256];
+
+  if (size == 0) return 0;
+  if (k >= size) k = size - 1;
+  build_histogram(data, size, counts);
+  return histogram_kth(counts, k);
+}
+
+/*
+ * Nearest rank: the ceil(pct * size / 100)-th smallest value, returned as
+ * its descending index for find_kth (size > 0)
+ */
+static unsigned int percentile_k(unsigned int size, unsigned int pct) {
+  unsigned int rank;
+
+  if (pct > 100) pct = 100;
+  rank = (unsigned int)(((uint64_t)pct * size + 99) / 100);
+  if (rank == 0) rank = 1;
+  return size - rank;
+}
+
+unsigned char find_percentile(unsigned char *data, unsigned int size,
+                              unsigned int pct) {
+  if (size == 0) return 0;
+  return find_kth(data, size, percentile_k(size, pct));
+}
+
+void find_percentiles(unsigned char *data, unsigned int size,
+                      const unsigned int *pct, unsigned int count,
+                      unsigned char *out) {
+  uint32_t counts[256];
+
+  if (size == 0) {
+    my_memzero(out, count);
+    return;
+  }
+  build_histogram(data, size, counts);
+
+  /* counts[v] becomes the number of samples >= v, so each query is a
+     binary search for the largest v with more than k samples at or above */
+  for (int v = 254; v >= 0; v--) counts[v] += counts[v + 1];
+  for (unsigned int i = 0; i < count; i++) {
+    unsigned int k = percentile_k(size, pct[i]);
+    unsigned int lo = 0, hi = 255;
+    while (lo < hi) {
+      unsigned int mid = (lo + hi + 1) / 2;
+      if (counts[mid] > k) lo = mid; else hi = mid - 1;
+    }
+    out[i] = (unsigned char)lo;
+  }
+}
+
+void find_histogram(unsigned char *data, unsigned int size, uint32_t *bins,
+                    unsigned int bin_count) {
+  uint32_t counts[256];
+
+  if (bin_count == 0) return;
+  if (bin_count >= 256) {
+    build_histogram(data, size, bins);
+    return;
+  }
+  if (size < 512) {
+    /* Too few samples to pay for the 256 intermediate counts */
+    my_memzero((uint8_t *)bins, bin_count * sizeof(uint32_t));
+    for (unsigned int i = 0; i < size; i++) {
+      bins[(data[i] * bin_count) >> 8]++;
+    }
+    return;
+  }
+  /* Count per value, then fold the 256 counts into equal-width bins */
+  build_histogram(data, size, counts);
+  my_memzero((uint8_t *)bins, bin_count * sizeof(uint32_t));
+  for (unsigned int v = 0; v < 256; v++) {
+    bins[(v * bin_count) >> 8] += counts[v];
+  }
+}
+
+#if defined (HOST) && defined (__SSE2__)
+/* Horizontal max/min of 16 unsigned bytes */
+static inline unsigned char hmax_epu8(__m128i v) {
+  v = _mm_max_epu8(v, _mm_srli_si128(v, 8));
+  v = _mm_max_epu8(v, _mm_srli_si128(v, 4));
+  v = _mm_max_epu8(v, _mm_srli_si128(v, 2));
+  v = _mm_max_epu8(v, _mm_srli_si128(v, 1));
+  return (unsigned char)_mm_cvtsi128_si32(v);
+}
+
+static inline unsigned char hmin_epu8(__m128i v) {
+  v = _mm_min_epu8(v, _mm_srli_si128(v, 8));
+  v = _mm_min_epu8(v, _mm_srli_si128(v, 4));
+  v = _mm_min_epu8(v, _mm_srli_si128(v, 2));
+  v = _mm_min_epu8(v, _mm_srli_si128(v, 1));
+  return (unsigned char)_mm_cvtsi128_si32(v);
+}
+#endif
+
+#if defined (MSP432)
+/* Byte lanes of a word, for the final reduction */
+#define LANE(w, n) ((unsigned char)((w) >> (8 * (n))))
+
+/* Bytes before data + i reaches a word boundary */
+static inline unsigned int head_bytes(const unsigned char *data,
+                                      unsigned int size) {
+  unsigned int head = (unsigned int)(-(uintptr_t)data & 3u);
+  return head < size ? head : size;
+}
+#endif
+
+uint64_t find_sum(unsigned char *data, unsigned int size) {
+  uint64_t sum = 0;
+  unsigned int i = 0;
+
+#if defined (HOST) && defined (__AVX2__)
+  __m256i acc = _mm256_setzero_si256();
+  for (; i + 32 <= size; i += 32) {
+    __m256i v = _mm256_loadu_si256((const __m256i *)(data + i));
+    acc = _mm256_add_epi64(acc, _mm256_sad_epu8(v, _mm256_setzero_si256()));
+  }
+  {
+    __m128i half = _mm_add_epi64(_mm256_castsi256_si128(acc),
+                                 _mm256_extracti128_si256(acc, 1));
+    sum = (uint64_t)_mm_cvtsi128_si64(half) +
+          (uint64_t)_mm_cvtsi128_si64(_mm_unpackhi_epi64(half, half));
+  }
+#elif defined (HOST) && defined (__SSE2__)
+  __m128i acc = _mm_setzero_si128();
+  for (; i + 16 <= size; i += 16) {
+    __m128i v = _mm_loadu_si128((const __m128i *)(data + i));
+    acc = _mm_add_epi64(acc, _mm_sad_epu8(v, _mm_setzero_si128()));
+  }
+  sum = (uint64_t)_mm_cvtsi128_si64(acc) +
+        (uint64_t)_mm_cvtsi128_si64(_mm_unpackhi_epi64(acc, acc));
+#elif defined (MSP432)
+  for (unsigned int head = head_bytes(data, size); i < head; i++) {
+    sum += data[i];
+  }
+  while (i + 4 <= size) {
+    /* USADA8 against 0 adds 4 bytes; flush before 32 bits can overflow */
+    unsigned int end = size - ((size - i) & 3u);
+    uint32_t acc = 0;
+    if (end - i > (1u << 22)) end = i + (1u << 22);
+    for (; i < end; i += 4) {
+      acc = __USADA8(*(const uint32_t *)(data + i), 0, acc);
+    }
+    sum += acc;
+  }
+#endif
+  for (; i < size; i++) sum += data[i];
+  return sum;
 }
 
 unsigned char find_mean(unsigned char *data, unsigned int size) {
-  unsigned int sum = 0;
-  for (unsigned int i = 0; i < size; i++) sum += data[i];
-  return (unsigned char)(sum / size); // Automatic rounding down
+  if (size == 0) return 0;
+  return (unsigned char)(find_sum(data, size) / size); // Rounding down
 }
 
 unsigned char find_maximum(unsigned char *data, unsigned int size) {
-  unsigned char max = data[0];
-  for (unsigned int i = 1; i < size; i++) 
+  unsigned char max;
+  unsigned int i = 1;
+
+  if (size == 0) return 0;
+  max = data[0];
+#if defined (HOST) && defined (__AVX2__)
+  if (size >= 64) {
+    __m256i m0 = _mm256_setzero_si256(), m1 = m0;
+    for (i = 0; i + 64 <= size; i += 64) {
+      m0 = _mm256_max_epu8(m0, _mm256_loadu_si256((const __m256i *)(data + i)));
+      m1 = _mm256_max_epu8(m1,
+                           _mm256_loadu_si256((const __m256i *)(data + i + 32)));
+    }
+    m0 = _mm256_max_epu8(m0, m1);
+    max = hmax_epu8(_mm_max_epu8(_mm256_castsi256_si128(m0),
+                                 _mm256_extracti128_si256(m0, 1)));
+  }
+#elif defined (HOST) && defined (__SSE2__)
+  if (size >= 32) {
+    __m128i m0 = _mm_setzero_si128(), m1 = m0;
+    for (i = 0; i + 32 <= size; i += 32) {
+      m0 = _mm_max_epu8(m0, _mm_loadu_si128((const __m128i *)(data + i)));
+      m1 = _mm_max_epu8(m1, _mm_loadu_si128((const __m128i *)(data + i + 16)));
+    }
+    max = hmax_epu8(_mm_max_epu8(m0, m1));
+  }
+#elif defined (MSP432)
+  if (size >= 8) {
+    uint32_t m = 0;
+    for (i = head_bytes(data, size); i + 4 <= size; i += 4) {
+      uint32_t w = *(const uint32_t *)(data + i);
+      (void)__USUB8(w, m);      /* GE[n] = w.byte[n] >= m.byte[n] */
+      m = __SEL(w, m);
+    }
+    for (unsigned int n = 0; n < 4; n++) {
+      if (LANE(m, n) > max) max = LANE(m, n);
+    }
+    /* Head bytes were skipped by the word loop */
+    for (unsigned int h = 0; h < head_bytes(data, size); h++) {
+      if (data[h] > max) max = data[h];
+    }
+  }
+#endif
+  for (; i < size; i++)
     if (data[i] > max) max = data[i];
   return max;
 }
 
 unsigned char find_minimum(unsigned char *data, unsigned int size) {
-  unsigned char min = data[0];
-  for (unsigned int i = 1; i < size; i++) 
+  unsigned char min;
+  unsigned int i = 1;
+
+  if (size == 0) return 0;
+  min = data[0];
+#if defined (HOST) && defined (__AVX2__)
+  if (size >= 64) {
+    __m256i m0 = _mm256_set1_epi8((char)0xFF), m1 = m0;
+    for (i = 0; i + 64 <= size; i += 64) {
+      m0 = _mm256_min_epu8(m0, _mm256_loadu_si256((const __m256i *)(data + i)));
+      m1 = _mm256_min_epu8(m1,
+                           _mm256_loadu_si256((const __m256i *)(data + i + 32)));
+    }
+    m0 = _mm256_min_epu8(m0, m1);
+    min = hmin_epu8(_mm_min_epu8(_mm256_castsi256_si128(m0),
+                                 _mm256_extracti128_si256(m0, 1)));
+  }
+#elif defined (HOST) && defined (__SSE2__)
+  if (size >= 32) {
+    __m128i m0 = _mm_set1_epi8((char)0xFF), m1 = m0;
+    for (i = 0; i + 32 <= size; i += 32) {
+      m0 = _mm_min_epu8(m0, _mm_loadu_si128((const __m128i *)(data + i)));
+      m1 = _mm_min_epu8(m1, _mm_loadu_si128((const __m128i *)(data + i + 16)));
+    }
+    min = hmin_epu8(_mm_min_epu8(m0, m1));
+  }
+#elif defined (MSP432)
+  if (size >= 8) {
+    uint32_t m = 0xFFFFFFFFu;
+    for (i = head_bytes(data, size); i + 4 <= size; i += 4) {
+      uint32_t w = *(const uint32_t *)(data + i);
+      (void)__USUB8(w, m);      /* GE[n] = w.byte[n] >= m.byte[n] */
+      m = __SEL(m, w);
+    }
+    for (unsigned int n = 0; n < 4; n++) {
+      if (LANE(m, n) < min) min = LANE(m, n);
+    }
+    for (unsigned int h = 0; h < head_bytes(data, size); h++) {
+      if (data[h] < min) min = data[h];
+    }
+  }
+#endif
+  for (; i < size; i++)
     if (data[i] < min) min = data[i];
   return min;
 }
 
-/* Bubble sort in descending order */
+/* 128-bit product a * b as hi:lo, without a 128-bit type */
+static void mul_u64(uint64_t a, uint64_t b, uint64_t *hi, uint64_t *lo) {
+  uint64_t al = (uint32_t)a, ah = a >> 32;
+  uint64_t bl = (uint32_t)b, bh = b >> 32;
+  uint64_t ll = al * bl, lh = al * bh, hl = ah * bl, hh = ah * bh;
+  uint64_t mid = (ll >> 32) + (uint32_t)lh + (uint32_t)hl;
+
+  *lo = (mid << 32) | (uint32_t)ll;
+  *hi = hh + (lh >> 32) + (hl >> 32) + (mid >> 32);
+}
+
+/*
+ * Population variance of n samples from their sum and sum of squares,
+ * rounded down.
+ *
+ * With q = floor(mean) and r = sum - q * n, shifting the samples by q
+ * gives S = sum((x - q)^2) without overflow and
+ * variance = S / n - (r / n)^2, where the second term is below 1. So the
+ * result is floor(S / n), minus one when (S % n) * n < r * r. The
+ * intermediate products may wrap; S itself fits as long as n * variance
+ * does.
+ */
+static uint64_t variance_floor(uint64_t n, uint64_t sum, uint64_t sum_sq) {
+  uint64_t q, r, shifted, var, ah, al, bh, bl;
+
+  if (n == 0) return 0;
+  q = sum / n;
+  r = sum - q * n;
+  shifted = sum_sq - 2 * q * sum + q * q * n;
+  var = shifted / n;
+  mul_u64(shifted % n, n, &ah, &al);
+  mul_u64(r, r, &bh, &bl);
+  if (ah < bh || (ah == bh && al < bl)) var--;
+  return var;
+}
+
+uint32_t isqrt(uint64_t value) {
+  unsigned int shift;
+
+  if (value == 0) return 0;
+  /* Digit by digit from the highest even bit set; the masks keep each
+     step free of data-dependent branches */
+  if (value >> 32 == 0) {
+    uint32_t v = (uint32_t)value, root = 0, bit;
+
+    shift = (31u - (unsigned int)__builtin_clz(v)) & ~1u;
+    for (bit = 1u << shift; bit != 0; bit >>= 2) {
+      uint32_t trial = root + bit;
+      uint32_t take = -(uint32_t)(v >= trial);
+      v -= trial & take;
+      root = (root >> 1) + (bit & take);
+    }
+    return root;
+  } else {
+    uint64_t root = 0, bit;
+
+    shift = (63u - (unsigned int)__builtin_clzll(value)) & ~1u;
+    for (bit = 1ull << shift; bit != 0; bit >>= 2) {
+      uint64_t trial = root + bit;
+      uint64_t take = -(uint64_t)(value >= trial);
+      value -= trial & take;
+      root = (root >> 1) + (bit & take);
+    }
+    return (uint32_t)root;
+  }
+}
+
+uint64_t find_sum_squares(unsigned char *data, unsigned int size) {
+  uint64_t sum = 0;
+  unsigned int i = 0;
+
+#if defined (HOST) && defined (__SSE2__)
+  /* PMADDWD on zero-extended bytes: 4 squares per 32-bit lane per step */
+  while (i + 16 <= size) {
+    unsigned int end = size - ((size - i) & 15u);
+    __m128i acc = _mm_setzero_si128();
+    uint32_t lanes[4];
+
+    /* 2^13 steps of at most 4 * 255^2 stay below 2^31 */
+    if (end - i > (1u << 17)) end = i + (1u << 17);
+    for (; i < end; i += 16) {
+      __m128i v = _mm_loadu_si128((const __m128i *)(data + i));
+      __m128i lo = _mm_unpacklo_epi8(v, _mm_setzero_si128());
+      __m128i hi = _mm_unpackhi_epi8(v, _mm_setzero_si128());
+      acc = _mm_add_epi32(acc, _mm_madd_epi16(lo, lo));
+      acc = _mm_add_epi32(acc, _mm_madd_epi16(hi, hi));
+    }
+    _mm_storeu_si128((__m128i *)lanes, acc);
+    sum += (uint64_t)lanes[0] + lanes[1] + lanes[2] + lanes[3];
+  }
+#elif defined (MSP432)
+  for (unsigned int head = head_bytes(data, size); i < head; i++) {
+    sum += (uint32_t)data[i] * data[i];
+  }
+  while (i + 4 <= size) {
+    /* UXTB16 splits a word into two halfword pairs, SMLAD squares and
+       adds each pair; flush before 32 bits can overflow */
+    unsigned int end = size - ((size - i) & 3u);
+    uint32_t acc = 0;
+    if (end - i > (1u << 15)) end = i + (1u << 15);
+    for (; i < end; i += 4) {
+      uint32_t w = *(const uint32_t *)(data + i);
+      uint32_t even = __UXTB16(w), odd = __UXTB16(__ROR(w, 8));
+      acc = __SMLAD(even, even, acc);
+      acc = __SMLAD(odd, odd, acc);
+    }
+    sum += acc;
+  }
+#endif
+  for (; i < size; i++) sum += (uint32_t)data[i] * data[i];
+  return sum;
+}
+
+/*
+ * Fixed-point results are the variance of the samples scaled by 2^(bits/2),
+ * which is exact: scaling every sample by s scales the variance by s^2.
+ */
+static uint64_t array_variance(unsigned char *data, unsigned int size,
+                               unsigned int frac_bits) {
+  uint64_t sum = find_sum(data, size);
+  uint64_t sum_sq = find_sum_squares(data, size);
+
+  return variance_floor(size, sum << (frac_bits / 2), sum_sq << frac_bits);
+}
+
+uint32_t find_variance(unsigned char *data, unsigned int size) {
+  return (uint32_t)array_variance(data, size, 0);
+}
+
+uint32_t find_variance_q8(unsigned char *data, unsigned int size) {
+  return (uint32_t)array_variance(data, size, 8);
+}
+
+uint32_t find_stddev(unsigned char *data, unsigned int size) {
+  return isqrt(array_variance(data, size, 0));
+}
+
+uint32_t find_stddev_q8(unsigned char *data, unsigned int size) {
+  /* sqrt(var * 2^16) = stddev * 2^8 */
+  return isqrt(array_variance(data, size, 16));
+}
+
+static inline void swap_bytes(unsigned char *a, unsigned char *b) {
+  unsigned char temp = *a;
+  *a = *b;
+  *b = temp;
+}
+
+void sort_array_insertion(unsigned char *data, unsigned int size) {
+  for (unsigned int i = 1; i < size; i++) {
+    unsigned char value = data[i];
+    unsigned int j = i;
+    while (j > 0 && data[j - 1] < value) {
+      data[j] = data[j - 1];
+      j--;
+    }
+    data[j] = value;
+  }
+}
+
+/* Min-heap sift: leaves the smallest value at the root */
+static void sift_down_min(unsigned char *data, unsigned int root,
+                          unsigned int size) {
+  unsigned char value = data[root];
+
+  for (;;) {
+    unsigned int child = 2 * root + 1;
+    if (child >= size) break;
+    if (child + 1 < size && data[child + 1] < data[child]) child++;
+    if (data[child] >= value) break;
+    data[root] = data[child];
+    root = child;
+  }
+  data[root] = value;
+}
+
+/* Heapsort fallback: repeatedly move the minimum to the end */
+static void heap_sort_desc(unsigned char *data, unsigned int size) {
+  for (unsigned int i = size / 2; i > 0; i--) {
+    sift_down_min(data, i - 1, size);
+  }
+  for (unsigned int end = size - 1; end > 0; end--) {
+    swap_bytes(&data[0], &data[end]);
+    sift_down_min(data, 0, end);
+  }
+}
+
+static void intro_sort_desc(unsigned char *data, unsigned int size,
+                            unsigned int depth) {
+  while (size > SORT_INSERTION_MAX) {
+    unsigned int mid = (size - 1) / 2;
+    unsigned int i, j;
+    unsigned char pivot;
+
+    if (depth == 0) {
+      heap_sort_desc(data, size);
+      return;
+    }
+    depth--;
+
+    /* Median of three, ordered so the ends act as sentinels */
+    if (data[mid] > data[0]) swap_bytes(&data[mid], &data[0]);
+    if (data[size - 1] > data[0]) swap_bytes(&data[size - 1], &data[0]);
+    if (data[size - 1] > data[mid]) swap_bytes(&data[size - 1], &data[mid]);
+    pivot = data[mid];
+
+    /* Hoare partition: [0, j] >= pivot >= [j + 1, size) */
+    i = 0;
+    j = size - 1;
+    for (;;) {
+      while (data[i] > pivot) i++;
+      while (data[j] < pivot) j--;
+      if (i >= j) break;
+      swap_bytes(&data[i], &data[j]);
+      i++;
+      j--;
+    }
+
+    /* Recurse into the smaller half, loop on the larger */
+    if (j + 1 < size - j - 1) {
+      intro_sort_desc(data, j + 1, depth);
+      data += j + 1;
+      size -= j + 1;
+    } else {
+      intro_sort_desc(data + j + 1, size - j - 1, depth);
+      size = j + 1;
+    }
+  }
+  sort_array_insertion(data, size);
+}
+
+void sort_array_intro(unsigned char *data, unsigned int size) {
+  unsigned int depth = 0;
+
+  for (unsigned int n = size; n > 1; n >>= 1) depth += 2;
+  intro_sort_desc(data, size, depth);
+}
+
+void sort_array_counting(unsigned char *data, unsigned int size) {
+  unsigned int counts[256] = {0};
+  unsigned int pos = 0;
+
+  for (unsigned int i = 0; i < size; i++) counts[data[i]]++;
+  for (int value = 255; value >= 0; value--) {
+    my_memset(data + pos, counts[value], (uint8_t)value);
+    pos += counts[value];
+  }
+}
+
+/*
+ * Compare-exchange v[i] and v[j], larger first: the mask is all ones when
+ * v[i] < v[j] (the difference wraps), and then both move by the difference
+ */
+#define SORT_NETWORK_SWAP(i, j) {                                      \
+    uint32_t d = v[i] - v[j];                                          \
+    d &= (uint32_t)0 - (d >> 31);                                      \
+    v[i] -= d;                                                         \
+    v[j] += d;                                                         \
+  }
+
+/*
+ * One function per network. The comparator sequence is fixed, so the time
+ * does not depend on the data; with optimisation only the 8- and 16-element
+ * v stay in registers on Cortex-M4, the 32- and 40-element ones (and every
+ * v at -O0) live on the stack
+ */
+#define SORT_NETWORK_DEFINE(n)                                         \
+static void sort_network_##n(unsigned char *data) {                    \
+  uint32_t v[n];                                                       \
+  for (unsigned int i = 0; i < n; i++) v[i] = data[i];                 \
+  SORT_NETWORK_##n(SORT_NETWORK_SWAP)                                  \
+  for (unsigned int i = 0; i < n; i++) data[i] = (unsigned char)v[i];  \
+}
+
+SORT_NETWORK_DEFINE(8)
+SORT_NETWORK_DEFINE(16)
+SORT_NETWORK_DEFINE(32)
+SORT_NETWORK_DEFINE(40)
+
+int8_t sort_array_network(unsigned char *data, unsigned int size) {
+  switch (size) {
+    case 8:  sort_network_8(data);  return 0;
+    case 16: sort_network_16(data); return 0;
+    case 32: sort_network_32(data); return 0;
+    case 40: sort_network_40(data); return 0;
+    default: return -1;
+  }
+}
+
+/* Descending order; the algorithm is picked by size */
+#if defined (HOST)
+typedef struct {
+  unsigned char *data;
+  unsigned int size;
+  unsigned int chunks;
+  uint32_t counts[256];
+} counting_job_t;
+
+/* Write one slice of the sorted array straight from the histogram */
+static void counting_fill(void *arg, uint32_t index) {
+  counting_job_t *job = (counting_job_t *)arg;
+  unsigned int begin = (unsigned int)((uint64_t)job->size * index / job->chunks);
+  unsigned int end = (unsigned int)((uint64_t)job->size * (index + 1) /
+                                    job->chunks);
+  unsigned int pos = 0;
+
+  for (int value = 255; value >= 0 && pos < end; value--) {
+    unsigned int next = pos + job->counts[value];
+    unsigned int lo = pos > begin ? pos : begin;
+    unsigned int hi = next < end ? next : end;
+
+    if (lo < hi) my_memset(job->data + lo, hi - lo, (uint8_t)value);
+    pos = next;
+  }
+}
+
+/**
+ * @brief Counting sort on the tpool: the histogram is built in parallel
+ *        (from STATS_PARALLEL_MIN bytes), then each task fills an equal
+ *        slice of the output
+ */
+static void sort_array_counting_mt(unsigned char *data, unsigned int size) {
+  counting_job_t job;
+
+  job.data = data;
+  job.size = size;
+  job.chunks = 2 * tpool_threads();
+  build_histogram(data, size, job.counts);
+  tpool_run(counting_fill, &job, job.chunks);
+}
+#endif
+
 void sort_array(unsigned char *data, unsigned int size) {
-  for (unsigned int i = 0; i < size - 1; i++) {
-    for (unsigned int j = 0; j < size - i - 1; j++) {
-      if (data[j] < data[j + 1]) {
-        unsigned char temp = data[j];
-        data[j] = data[j + 1];
-        data[j + 1] = temp;
+  if (SORT_NETWORKS && sort_array_network(data, size) == 0) {
+    return;
+  }
+  if (size <= SORT_INSERTION_MAX) {
+    sort_array_insertion(data, size);
+  } else if (size < SORT_COUNTING_MIN) {
+    sort_array_intro(data, size);
+#if defined (HOST)
+  } else if (size >= SORT_PARALLEL_MIN && tpool_threads() > 1) {
+    sort_array_counting_mt(data, size);
+#endif
+  } else {
+    sort_array_counting(data, size);
+  }
+}
+
+/*
+ * Keep the k largest values of data in the min-heap heap (size > k > 0).
+ * A sample only enters when it beats the root, the smallest value kept.
+ */
+static void top_k_heap(const unsigned char *data, unsigned int size,
+                       unsigned char *heap, unsigned int k) {
+  unsigned int i = k;
+
+  my_memcopy((uint8_t *)data, heap, k);
+  for (unsigned int j = k / 2; j > 0; j--) {
+    sift_down_min(heap, j - 1, k);
+  }
+#if defined (HOST) && defined (__SSE2__)
+  for (; i + 16 <= size && heap[0] < 255; i += 16) {
+    __m128i v = _mm_loadu_si128((const __m128i *)(data + i));
+    __m128i root = _mm_set1_epi8((char)heap[0]);
+
+    /* max(v, root) == root in every lane: nothing here beats the root */
+    if (_mm_movemask_epi8(_mm_cmpeq_epi8(_mm_max_epu8(v, root), root)) ==
+        0xFFFF) {
+      continue;
+    }
+    for (unsigned int j = i; j < i + 16; j++) {
+      if (data[j] > heap[0]) {
+        heap[0] = data[j];
+        sift_down_min(heap, 0, k);
       }
     }
   }
+#endif
+  /* Once the root is 255 no sample can get in */
+  for (; i < size && heap[0] < 255; i++) {
+    if (data[i] > heap[0]) {
+      heap[0] = data[i];
+      sift_down_min(heap, 0, k);
+    }
+  }
+}
+
+unsigned int find_top_k(unsigned char *data, unsigned int size,
+                        unsigned int k, unsigned char *out) {
+  if (k > size) k = size;
+  if (k == 0) return 0;
+
+  if (k == size) {
+    my_memcopy(data, out, k);
+    sort_array(out, k);
+  } else if (k <= TOPK_HEAP_MAX || size / k >= TOPK_HEAP_RATIO) {
+    top_k_heap(data, size, out, k);
+    heap_sort_desc(out, k);
+  } else {
+    uint32_t counts[256];
+    unsigned int pos = 0;
+
+    build_histogram(data, size, counts);
+    for (int value = 255; pos < k; value--) {
+      unsigned int n = counts[value] < k - pos ? counts[value] : k - pos;
+      my_memset(out + pos, n, (uint8_t)value);
+      pos += n;
+    }
+  }
+  return k;
+}
+
+/*
+ * Swap every value above pivot, and the first ties copies of pivot, to the
+ * front: k values in all, in no particular order
+ */
+static void gather_top_k(unsigned char *data, unsigned int size,
+                         unsigned char pivot, unsigned int ties,
+                         unsigned int k) {
+  unsigned int front = 0, i = 0;
+
+#if defined (HOST) && defined (__SSE2__)
+  if (pivot > 0) {
+    __m128i below = _mm_set1_epi8((char)(pivot - 1));
+    for (; i + 16 <= size && front < k; i += 16) {
+      __m128i v = _mm_loadu_si128((const __m128i *)(data + i));
+
+      /* Skip blocks that are all below the pivot */
+      if (_mm_movemask_epi8(_mm_cmpeq_epi8(_mm_max_epu8(v, below), below)) ==
+          0xFFFF) {
+        continue;
+      }
+      for (unsigned int j = i; j < i + 16 && front < k; j++) {
+        if (data[j] > pivot || (data[j] == pivot && ties > 0)) {
+          if (data[j] == pivot) ties--;
+          swap_bytes(&data[j], &data[front++]);
+        }
+      }
+    }
+  }
+#endif
+  for (; front < k; i++) {
+    if (data[i] > pivot || (data[i] == pivot && ties > 0)) {
+      if (data[i] == pivot) ties--;
+      swap_bytes(&data[i], &data[front++]);
+    }
+  }
+}
+
+void sort_array_partial(unsigned char *data, unsigned int size,
+                        unsigned int k) {
+  unsigned int ties = 0;
+
+  if (k > size) k = size;
+  if (k == 0) return;
+  if (size <= SORT_INSERTION_MAX) {
+    sort_array_insertion(data, size);
+    return;
+  }
+
+  /* Same choice as find_top_k, with the heap capped at 256 bytes */
+  if (k <= TOPK_HEAP_MAX ||
+      (k <= 256 && size / k >= TOPK_HEAP_RATIO)) {
+    unsigned char top[TOPK_HEAP_MAX > 256 ? TOPK_HEAP_MAX : 256];
+
+    top_k_heap(data, size, top, k);
+    heap_sort_desc(top, k);
+    while (ties < k && top[k - 1 - ties] == top[k - 1]) ties++;
+    gather_top_k(data, size, top[k - 1], ties, k);
+    my_memcopy(top, data, k);
+  } else {
+    uint32_t counts[256];
+    unsigned int pos = 0;
+    int pivot;
+
+    /* The k-th largest value; pos values lie above it */
+    build_histogram(data, size, counts);
+    for (pivot = 255; pos + counts[pivot] < k; pivot--) pos += counts[pivot];
+    gather_top_k(data, size, (unsigned char)pivot, k - pos, k);
+
+    /* The front holds those k values in some order: rewrite it sorted */
+    pos = 0;
+    for (int value = 255; value > pivot; value--) {
+      my_memset(data + pos, counts[value], (uint8_t)value);
+      pos += counts[value];
+    }
+    my_memset(data + pos, k - pos, (uint8_t)pivot);
+  }
+}
+
+void stats_stream_init(stats_stream_t *stream, uint8_t *window,
+                       unsigned int window_size) {
+  my_memzero((uint8_t *)stream, sizeof(*stream));
+  stream->minimum = 255;
+  if (window != NULL && window_size > 0) {
+    stream->window = window;
+    stream->window_size = window_size;
+  }
 }
 
+/* Fenwick update: value v lives at 1-based index v + 1 */
+static void tree_add(uint32_t tree[256], unsigned int value, int32_t delta) {
+  for (unsigned int i = value + 1; i <= 256; i += i & (0u - i)) {
+    tree[i - 1] += (uint32_t)delta;
+  }
+}
+
+/* Smallest value with more than rank samples at or below it */
+static unsigned char tree_select(const uint32_t tree[256], uint32_t rank) {
+  unsigned int pos = 0;
+
+  for (unsigned int step = 128; step > 0; step >>= 1) {
+    if (pos + step <= 256 && tree[pos + step - 1] <= rank) {
+      pos += step;
+      rank -= tree[pos - 1];
+    }
+  }
+  return (unsigned char)pos;
+}
+
+void stats_stream_push(stats_stream_t *stream, unsigned char sample) {
+  stream->count++;
+  stream->sum += sample;
+  stream->sum_sq += (uint32_t)sample * sample;
+  if (sample < stream->minimum) stream->minimum = sample;
+  if (sample > stream->maximum) stream->maximum = sample;
+
+  if (stream->window != NULL) {
+    if (stream->window_fill == stream->window_size) {
+      tree_add(stream->tree, stream->window[stream->window_head], -1);
+    } else {
+      stream->window_fill++;
+    }
+    stream->window[stream->window_head] = sample;
+    tree_add(stream->tree, sample, 1);
+    if (++stream->window_head == stream->window_size) {
+      stream->window_head = 0;
+    }
+  }
+}
+
+void stats_stream_push_block(stats_stream_t *stream, unsigned char *data,
+                             unsigned int size) {
+  for (unsigned int i = 0; i < size; i++) {
+    stats_stream_push(stream, data[i]);
+  }
+}
+
+unsigned char stats_stream_min(const stats_stream_t *stream) {
+  return stream->count ? stream->minimum : 0;
+}
+
+unsigned char stats_stream_max(const stats_stream_t *stream) {
+  return stream->maximum;
+}
+
+unsigned char stats_stream_mean(const stats_stream_t *stream) {
+  return stream->count ? (unsigned char)(stream->sum / stream->count) : 0;
+}
+
+uint32_t stats_stream_variance(const stats_stream_t *stream) {
+  return (uint32_t)variance_floor(stream->count, stream->sum, stream->sum_sq);
+}
+
+unsigned char stats_stream_median(const stats_stream_t *stream) {
+  uint32_t n = stream->window_fill;
+
+  if (n == 0) return 0;
+  /* k = n / 2 in descending order is rank n - 1 - n / 2 ascending */
+  return tree_select(stream->tree, n - 1 - n / 2);
+}
@@ -0,0 +1,434 @@
+/*****************************************************************************
+ * @file stats_typed.c
+ * @brief Statistics and sorting for 16-bit, 32-bit and float samples
+ *
+ * Each sample type defines its min/max/sum kernels here and then expands
+ * stats_template.h for the rest of the API:
+ * - u16/i16: MSP432 compares two halfwords per instruction (USUB16/SSUB16
+ *   and SEL) and sums them with one SMLALD dual MAC into a 64-bit
+ *   accumulator; HOST uses SSE2 PMAXSW/PMINSW and PMADDWD, 8 per step
+ * - i32/f32: SSE2 on HOST, 4 per step; plain loops on MSP432, which has
+ *   no SIMD for 32-bit lanes
+ * Unsigned halfwords go through the signed instructions with the top bit
+ * flipped, which maps 0..65535 onto -32768..32767 in order.
+ *
+ * This code was written as part of the Introduction to Embedded Systems
+ * Software and Development Environments course (University of Colorado Boulder).
+ *
+ * @author Timofei Alekseenko
+ * @date October 17, 2026
+ *
+ *****************************************************************************/
+
+#include "stats_typed.h"
+#include "stats.h"
+#include "platform.h"
+#include "memory.h"
+#include <stdint.h>
+
+#if defined (HOST)
+#include "tpool.h"
+#include <stdlib.h>
+#endif
+
+#if defined (HOST) && defined (__SSE2__)
+#include <emmintrin.h>
+#endif
+
+/* Mean of integer samples, rounded towards minus infinity */
+static inline int64_t floor_div(int64_t sum, unsigned int size) {
+  int64_t q = sum / (int64_t)size;
+  if (q * (int64_t)size > sum) q--;
+  return q;
+}
+
+#if defined (HOST) && defined (__SSE2__)
+/* Horizontal max/min of 8 signed halfwords */
+static inline int16_t hmax_epi16(__m128i v) {
+  v = _mm_max_epi16(v, _mm_srli_si128(v, 8));
+  v = _mm_max_epi16(v, _mm_srli_si128(v, 4));
+  v = _mm_max_epi16(v, _mm_srli_si128(v, 2));
+  return (int16_t)_mm_cvtsi128_si32(v);
+}
+
+static inline int16_t hmin_epi16(__m128i v) {
+  v = _mm_min_epi16(v, _mm_srli_si128(v, 8));
+  v = _mm_min_epi16(v, _mm_srli_si128(v, 4));
+  v = _mm_min_epi16(v, _mm_srli_si128(v, 2));
+  return (int16_t)_mm_cvtsi128_si32(v);
+}
+
+/* Sum of 4 signed words */
+static inline int64_t hsum_epi32(__m128i v) {
+  int32_t lanes[4];
+  _mm_storeu_si128((__m128i *)lanes, v);
+  return (int64_t)lanes[0] + lanes[1] + lanes[2] + lanes[3];
+}
+
+/**
+ * @brief Sums halfwords with PMADDWD, flipping each top bit by flip
+ *
+ * Each 32-bit lane gains at most 2 * 32768 per step, so lanes are folded
+ * into the 64-bit total every 8192 steps. Consumes a multiple of 8.
+ */
+static unsigned int sum_epi16(const int16_t *data, unsigned int size,
+                              int16_t flip, int64_t *sum) {
+  const __m128i ones = _mm_set1_epi16(1);
+  const __m128i bias = _mm_set1_epi16(flip);
+  unsigned int i = 0;
+
+  while (i + 8 <= size) {
+    unsigned int end = size - ((size - i) & 7u);
+    __m128i acc = _mm_setzero_si128();
+    if (end - i > (8u << 13)) end = i + (8u << 13);
+    for (; i < end; i += 8) {
+      __m128i v = _mm_loadu_si128((const __m128i *)(data + i));
+      acc = _mm_add_epi32(acc, _mm_madd_epi16(_mm_xor_si128(v, bias), ones));
+    }
+    *sum += hsum_epi32(acc);
+  }
+  return i;
+}
+#endif
+
+#if defined (MSP432)
+/* Signed halfword lanes of a word, for the final reduction */
+#define LO16(w) ((int16_t)(w))
+#define HI16(w) ((int16_t)((w) >> 16))
+
+/**
+ * @brief Sums halfword pairs with SMLALD, flipping each top bit by flip
+ *
+ * SMLALD multiplies both halves by 1 and adds them to a 64-bit
+ * accumulator, so the sum cannot overflow. An unaligned first halfword is
+ * added on its own; consumes everything but an odd last halfword.
+ */
+static unsigned int sum_pairs16(const uint16_t *data, unsigned int size,
+                                uint16_t flip, int64_t *sum) {
+  uint32_t flip2 = ((uint32_t)flip << 16) | flip;
+  uint64_t acc = 0;
+  unsigned int i = 0;
+
+  if (size > 0 && ((uintptr_t)data & 2u)) {
+    *sum += (int16_t)(data[0] ^ flip);
+    i = 1;
+  }
+  for (; i + 2 <= size; i += 2) {
+    acc = __SMLALD(*(const uint32_t *)(data + i) ^ flip2, 0x00010001u, acc);
+  }
+  *sum += (int64_t)acc;
+  return i;
+}
+#endif
+
+/*
+ * uint16_t
+ */
+
+static unsigned int sum_kernel_u16(const uint16_t *data, unsigned int size,
+                                   uint64_t *sum) {
+  unsigned int i = 0;
+#if (defined (HOST) && defined (__SSE2__)) || defined (MSP432)
+  int64_t biased = 0;
+
+#if defined (MSP432)
+  i = sum_pairs16(data, size, 0x8000, &biased);
+#else
+  i = sum_epi16((const int16_t *)data, size, (int16_t)0x8000, &biased);
+#endif
+  /* Every consumed sample was lowered by 32768 */
+  *sum += (uint64_t)biased + 32768u * (uint64_t)i;
+#else
+  (void)data; (void)size; (void)sum;
+#endif
+  return i;
+}
+
+static unsigned int max_kernel_u16(const uint16_t *data, unsigned int size,
+                                   uint16_t *best) {
+  unsigned int i = 0;
+#if defined (HOST) && defined (__SSE2__)
+  const __m128i bias = _mm_set1_epi16((int16_t)0x8000);
+  __m128i m = _mm_set1_epi16((int16_t)0x8000);
+  for (; i + 8 <= size; i += 8) {
+    __m128i v = _mm_loadu_si128((const __m128i *)(data + i));
+    m = _mm_max_epi16(m, _mm_xor_si128(v, bias));
+  }
+  if (i > 0) {
+    uint16_t top = (uint16_t)hmax_epi16(m) ^ 0x8000u;
+    if (top > *best) *best = top;
+  }
+#elif defined (MSP432)
+  uint32_t m = 0;
+  if ((uintptr_t)data & 2u) i = 1;      /* data[0] is already in *best */
+  for (; i + 2 <= size; i += 2) {
+    uint32_t w = *(const uint32_t *)(data + i);
+    (void)__USUB16(w, m);               /* GE set per half where w >= m */
+    m = __SEL(w, m);
+  }
+  if ((uint16_t)m > *best) *best = (uint16_t)m;
+  if ((uint16_t)(m >> 16) > *best) *best = (uint16_t)(m >> 16);
+#else
+  (void)data; (void)size; (void)best;
+#endif
+  return i;
+}
+
+static unsigned int min_kernel_u16(const uint16_t *data, unsigned int size,
+                                   uint16_t *best) {
+  unsigned int i = 0;
+#if defined (HOST) && defined (__SSE2__)
+  const __m128i bias = _mm_set1_epi16((int16_t)0x8000);
+  __m128i m = _mm_set1_epi16(0x7FFF);
+  for (; i + 8 <= size; i += 8) {
+    __m128i v = _mm_loadu_si128((const __m128i *)(data + i));
+    m = _mm_min_epi16(m, _mm_xor_si128(v, bias));
+  }
+  if (i > 0) {
+    uint16_t low = (uint16_t)hmin_epi16(m) ^ 0x8000u;
+    if (low < *best) *best = low;
+  }
+#elif defined (MSP432)
+  uint32_t m = 0xFFFFFFFFu;
+  if ((uintptr_t)data & 2u) i = 1;
+  for (; i + 2 <= size; i += 2) {
+    uint32_t w = *(const uint32_t *)(data + i);
+    (void)__USUB16(w, m);
+    m = __SEL(m, w);
+  }
+  if ((uint16_t)m < *best) *best = (uint16_t)m;
+  if ((uint16_t)(m >> 16) < *best) *best = (uint16_t)(m >> 16);
+#else
+  (void)data; (void)size; (void)best;
+#endif
+  return i;
+}
+
+#define STATS_SFX u16
+#define STATS_T uint16_t
+#define STATS_SUM_T uint64_t
+#define STATS_MEAN(sum, size) ((uint16_t)((sum) / (size)))
+#define STATS_PRINT_FMT "%u"
+#define STATS_PRINT_T unsigned int
+#include "stats_template.h"
+
+/*
+ * int16_t
+ */
+
+static unsigned int sum_kernel_i16(const int16_t *data, unsigned int size,
+                                   int64_t *sum) {
+#if defined (MSP432)
+  return sum_pairs16((const uint16_t *)data, size, 0, sum);
+#elif defined (HOST) && defined (__SSE2__)
+  return sum_epi16(data, size, 0, sum);
+#else
+  (void)data; (void)size; (void)sum;
+  return 0;
+#endif
+}
+
+static unsigned int max_kernel_i16(const int16_t *data, unsigned int size,
+                                   int16_t *best) {
+  unsigned int i = 0;
+#if defined (HOST) && defined (__SSE2__)
+  __m128i m = _mm_set1_epi16(INT16_MIN);
+  for (; i + 8 <= size; i += 8) {
+    m = _mm_max_epi16(m, _mm_loadu_si128((const __m128i *)(data + i)));
+  }
+  if (i > 0 && hmax_epi16(m) > *best) *best = hmax_epi16(m);
+#elif defined (MSP432)
+  uint32_t m = 0x80008000u;
+  if ((uintptr_t)data & 2u) i = 1;
+  for (; i + 2 <= size; i += 2) {
+    uint32_t w = *(const uint32_t *)(data + i);
+    (void)__SSUB16(w, m);               /* GE set per half where w >= m */
+    m = __SEL(w, m);
+  }
+  if (LO16(m) > *best) *best = LO16(m);
+  if (HI16(m) > *best) *best = HI16(m);
+#else
+  (void)data; (void)size; (void)best;
+#endif
+  return i;
+}
+
+static unsigned int min_kernel_i16(const int16_t *data, unsigned int size,
+                                   int16_t *best) {
+  unsigned int i = 0;
+#if defined (HOST) && defined (__SSE2__)
+  __m128i m = _mm_set1_epi16(INT16_MAX);
+  for (; i + 8 <= size; i += 8) {
+    m = _mm_min_epi16(m, _mm_loadu_si128((const __m128i *)(data + i)));
+  }
+  if (i > 0 && hmin_epi16(m) < *best) *best = hmin_epi16(m);
+#elif defined (MSP432)
+  uint32_t m = 0x7FFF7FFFu;
+  if ((uintptr_t)data & 2u) i = 1;
+  for (; i + 2 <= size; i += 2) {
+    uint32_t w = *(const uint32_t *)(data + i);
+    (void)__SSUB16(w, m);
+    m = __SEL(m, w);
+  }
+  if (LO16(m) < *best) *best = LO16(m);
+  if (HI16(m) < *best) *best = HI16(m);
+#else
+  (void)data; (void)size; (void)best;
+#endif
+  return i;
+}
+
+#define STATS_SFX i16
+#define STATS_T int16_t
+#define STATS_SUM_T int64_t
+#define STATS_MEAN(sum, size) ((int16_t)floor_div((sum), (size)))
+#define STATS_PRINT_FMT "%d"
+#define STATS_PRINT_T int
+#include "stats_template.h"
+
+/*
+ * int32_t
+ */
+
+static unsigned int sum_kernel_i32(const int32_t *data, unsigned int size,
+                                   int64_t *sum) {
+  unsigned int i = 0;
+#if defined (HOST) && defined (__SSE2__)
+  /* Sign-extend each word to 64 bits and add as two 2-lane vectors */
+  __m128i lo = _mm_setzero_si128(), hi = _mm_setzero_si128();
+  for (; i + 4 <= size; i += 4) {
+    __m128i v = _mm_loadu_si128((const __m128i *)(data + i));
+    __m128i sign = _mm_srai_epi32(v, 31);
+    lo = _mm_add_epi64(lo, _mm_unpacklo_epi32(v, sign));
+    hi = _mm_add_epi64(hi, _mm_unpackhi_epi32(v, sign));
+  }
+  lo = _mm_add_epi64(lo, hi);
+  *sum += (int64_t)_mm_cvtsi128_si64(lo) +
+          (int64_t)_mm_cvtsi128_si64(_mm_unpackhi_epi64(lo, lo));
+#else
+  (void)data; (void)size; (void)sum;
+#endif
+  return i;
+}
+
+#if defined (HOST) && defined (__SSE2__)
+/* SSE2 has no PMAXSD: pick per lane with a compare mask */
+static inline __m128i select_epi32(__m128i mask, __m128i a, __m128i b) {
+  return _mm_or_si128(_mm_and_si128(mask, a), _mm_andnot_si128(mask, b));
+}
+
+static inline int32_t hreduce_epi32(__m128i v, int max) {
+  int32_t lanes[4], best;
+  _mm_storeu_si128((__m128i *)lanes, v);
+  best = lanes[0];
+  for (unsigned int i = 1; i < 4; i++) {
+    if (max ? lanes[i] > best : lanes[i] < best) best = lanes[i];
+  }
+  return best;
+}
+#endif
+
+static unsigned int max_kernel_i32(const int32_t *data, unsigned int size,
+                                   int32_t *best) {
+  unsigned int i = 0;
+#if defined (HOST) && defined (__SSE2__)
+  __m128i m = _mm_set1_epi32(INT32_MIN);
+  for (; i + 4 <= size; i += 4) {
+    __m128i v = _mm_loadu_si128((const __m128i *)(data + i));
+    m = select_epi32(_mm_cmpgt_epi32(v, m), v, m);
+  }
+  if (i > 0 && hreduce_epi32(m, 1) > *best) *best = hreduce_epi32(m, 1);
+#else
+  (void)data; (void)size; (void)best;
+#endif
+  return i;
+}
+
+static unsigned int min_kernel_i32(const int32_t *data, unsigned int size,
+                                   int32_t *best) {
+  unsigned int i = 0;
+#if defined (HOST) && defined (__SSE2__)
+  __m128i m = _mm_set1_epi32(INT32_MAX);
+  for (; i + 4 <= size; i += 4) {
+    __m128i v = _mm_loadu_si128((const __m128i *)(data + i));
+    m = select_epi32(_mm_cmpgt_epi32(m, v), v, m);
+  }
+  if (i > 0 && hreduce_epi32(m, 0) < *best) *best = hreduce_epi32(m, 0);
+#else
+  (void)data; (void)size; (void)best;
+#endif
+  return i;
+}
+
+#define STATS_SFX i32
+#define STATS_T int32_t
+#define STATS_SUM_T int64_t
+#define STATS_MEAN(sum, size) ((int32_t)floor_div((sum), (size)))
+#define STATS_PRINT_FMT "%ld"
+#define STATS_PRINT_T long
+#include "stats_template.h"
+
+/*
+ * float
+ */
+
+static unsigned int sum_kernel_f32(const float *data, unsigned int size,
+                                   double *sum) {
+  unsigned int i = 0;
+#if defined (HOST) && defined (__SSE2__)
+  /* Widen to double before adding so long sums keep their precision */
+  __m128d lo = _mm_setzero_pd(), hi = _mm_setzero_pd();
+  for (; i + 4 <= size; i += 4) {
+    __m128 v = _mm_loadu_ps(data + i);
+    lo = _mm_add_pd(lo, _mm_cvtps_pd(v));
+    hi = _mm_add_pd(hi, _mm_cvtps_pd(_mm_movehl_ps(v, v)));
+  }
+  lo = _mm_add_pd(lo, hi);
+  *sum += _mm_cvtsd_f64(lo) + _mm_cvtsd_f64(_mm_unpackhi_pd(lo, lo));
+#else
+  (void)data; (void)size; (void)sum;
+#endif
+  return i;
+}
+
+static unsigned int max_kernel_f32(const float *data, unsigned int size,
+                                   float *best) {
+  unsigned int i = 0;
+#if defined (HOST) && defined (__SSE2__)
+  __m128 m = _mm_set1_ps(*best);
+  for (; i + 4 <= size; i += 4) {
+    m = _mm_max_ps(m, _mm_loadu_ps(data + i));
+  }
+  m = _mm_max_ps(m, _mm_movehl_ps(m, m));
+  m = _mm_max_ss(m, _mm_shuffle_ps(m, m, 1));
+  *best = _mm_cvtss_f32(m);
+#else
+  (void)data; (void)size; (void)best;
+#endif
+  return i;
+}
+
+static unsigned int min_kernel_f32(const float *data, unsigned int size,
+                                   float *best) {
+  unsigned int i = 0;
+#if defined (HOST) && defined (__SSE2__)
+  __m128 m = _mm_set1_ps(*best);
+  for (; i + 4 <= size; i += 4) {
+    m = _mm_min_ps(m, _mm_loadu_ps(data + i));
+  }
+  m = _mm_min_ps(m, _mm_movehl_ps(m, m));
+  m = _mm_min_ss(m, _mm_shuffle_ps(m, m, 1));
+  *best = _mm_cvtss_f32(m);
+#else
+  (void)data; (void)size; (void)best;
+#endif
+  return i;
+}
+
+#define STATS_SFX f32
+#define STATS_T float
+#define STATS_SUM_T double
+#define STATS_MEAN(sum, size) ((float)((sum) / (size)))
+#define STATS_PRINT_FMT "%f"
+#define STATS_PRINT_T double
+#include "stats_template.h"
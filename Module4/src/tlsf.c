@@ -0,0 +1,347 @@
+/*****************************************************************************
+ * @file tlsf.c
+ * @brief Implementation of the Two-Level Segregated Fit allocator
+ *
+ * Every block starts with a header holding the previous physical block and
+ * the payload size; the two low bits of the size flag "this block is free"
+ * and "previous block is free". Free blocks keep their list links in the
+ * payload. A zero-size used sentinel closes the region so coalescing never
+ * runs off the end.
+ *
+ * This code was written as part of the Introduction to Embedded Systems
+ * Software and Development Environments course (University of Colorado Boulder).
+ *
+ * @author Timofei Alekseenko
+ * @date October 17, 2026
+ *
+ *****************************************************************************/
+
+#include "tlsf.h"
+#include "platform.h"
+#include <stdint.h>
+#include <stddef.h>
+
+#define TLSF_ALIGN_LOG2   (3)
+#define TLSF_ALIGN        ((size_t)1 << TLSF_ALIGN_LOG2)
+#define TLSF_SL_LOG2      (4)
+#define TLSF_SL_COUNT     (1u << TLSF_SL_LOG2)
+#define TLSF_FL_SHIFT     (TLSF_SL_LOG2 + TLSF_ALIGN_LOG2)
+#define TLSF_FL_MAX       (24)   /* Largest block just under 16 MiB */
+#define TLSF_FL_COUNT     (TLSF_FL_MAX - TLSF_FL_SHIFT + 1)
+#define TLSF_SMALL_BLOCK  ((size_t)1 << TLSF_FL_SHIFT)
+
+#define TLSF_FREE_BIT       ((size_t)1)
+#define TLSF_PREV_FREE_BIT  ((size_t)2)
+#define TLSF_FLAG_MASK      (TLSF_FREE_BIT | TLSF_PREV_FREE_BIT)
+
+typedef struct tlsf_block {
+  struct tlsf_block * prev_phys;  /* Previous block in memory */
+  size_t size;                    /* Payload bytes | flag bits */
+  struct tlsf_block * next_free;  /* Free list links (payload of free blocks) */
+  struct tlsf_block * prev_free;
+} tlsf_block_t;
+
+#define TLSF_OVERHEAD     (offsetof(tlsf_block_t, next_free))
+#define TLSF_BLOCK_MIN    (sizeof(tlsf_block_t) - TLSF_OVERHEAD)
+#define TLSF_BLOCK_MAX    (((size_t)1 << TLSF_FL_MAX) - TLSF_ALIGN)
+
+/* Default region: linker heap on MSP432, static stand-in on HOST */
+#if defined (MSP432)
+extern uint8_t __heap_start__[];
+extern uint8_t __HeapLimit[];
+#define TLSF_REGION_START ((void *)__heap_start__)
+#define TLSF_REGION_BYTES ((size_t)(__HeapLimit - __heap_start__))
+#else
+static uint64_t tlsf_host_region[TLSF_HOST_HEAP_BYTES / sizeof(uint64_t)];
+#define TLSF_REGION_START ((void *)tlsf_host_region)
+#define TLSF_REGION_BYTES (sizeof(tlsf_host_region))
+#endif
+
+static uint32_t tlsf_fl_bitmap;
+static uint32_t tlsf_sl_bitmap[TLSF_FL_COUNT];
+static tlsf_block_t * tlsf_bins[TLSF_FL_COUNT][TLSF_SL_COUNT];
+static uint8_t tlsf_ready = 0;
+static tlsf_stats_t tlsf_stats;
+
+/* Highest and lowest set bit (x != 0) */
+static inline uint32_t tlsf_fls(uint32_t x) {
+#if defined (MSP432)
+  return 31u - __CLZ(x);
+#else
+  return 31u - (uint32_t)__builtin_clz(x);
+#endif
+}
+
+static inline uint32_t tlsf_ffs(uint32_t x) {
+#if defined (MSP432)
+  return __CLZ(__RBIT(x));
+#else
+  return (uint32_t)__builtin_ctz(x);
+#endif
+}
+
+static inline size_t block_size(const tlsf_block_t * block) {
+  return block->size & ~TLSF_FLAG_MASK;
+}
+
+static inline uint8_t * block_payload(tlsf_block_t * block) {
+  return (uint8_t *)block + TLSF_OVERHEAD;
+}
+
+static inline tlsf_block_t * block_from_payload(void * ptr) {
+  return (tlsf_block_t *)((uint8_t *)ptr - TLSF_OVERHEAD);
+}
+
+static inline tlsf_block_t * block_next(tlsf_block_t * block) {
+  return (tlsf_block_t *)(block_payload(block) + block_size(block));
+}
+
+/**
+ * @brief Bin of a block of the given size (round down: where it is filed)
+ */
+static void mapping_insert(size_t size, uint32_t * fl, uint32_t * sl) {
+  if (size < TLSF_SMALL_BLOCK) {
+    *fl = 0;
+    *sl = (uint32_t)(size / (TLSF_SMALL_BLOCK / TLSF_SL_COUNT));
+  } else {
+    uint32_t f = tlsf_fls((uint32_t)size);
+    *sl = (uint32_t)(size >> (f - TLSF_SL_LOG2)) ^ TLSF_SL_COUNT;
+    *fl = f - (TLSF_FL_SHIFT - 1);
+  }
+}
+
+/**
+ * @brief Bin to search for a request (round up: any block there fits)
+ */
+static void mapping_search(size_t size, uint32_t * fl, uint32_t * sl) {
+  if (size >= TLSF_SMALL_BLOCK) {
+    size += ((size_t)1 << (tlsf_fls((uint32_t)size) - TLSF_SL_LOG2)) - 1;
+  }
+  mapping_insert(size, fl, sl);
+}
+
+static void insert_free_block(tlsf_block_t * block) {
+  uint32_t fl, sl;
+
+  mapping_insert(block_size(block), &fl, &sl);
+  block->prev_free = NULL;
+  block->next_free = tlsf_bins[fl][sl];
+  if (block->next_free) {
+    block->next_free->prev_free = block;
+  }
+  tlsf_bins[fl][sl] = block;
+  tlsf_fl_bitmap |= 1u << fl;
+  tlsf_sl_bitmap[fl] |= 1u << sl;
+
+  tlsf_stats.free_blocks++;
+  tlsf_stats.free_bytes += (uint32_t)block_size(block);
+}
+
+static void remove_free_block(tlsf_block_t * block) {
+  uint32_t fl, sl;
+
+  mapping_insert(block_size(block), &fl, &sl);
+  if (block->prev_free) {
+    block->prev_free->next_free = block->next_free;
+  } else {
+    tlsf_bins[fl][sl] = block->next_free;
+    if (!tlsf_bins[fl][sl]) {
+      tlsf_sl_bitmap[fl] &= ~(1u << sl);
+      if (!tlsf_sl_bitmap[fl]) {
+        tlsf_fl_bitmap &= ~(1u << fl);
+      }
+    }
+  }
+  if (block->next_free) {
+    block->next_free->prev_free = block->prev_free;
+  }
+
+  tlsf_stats.free_blocks--;
+  tlsf_stats.free_bytes -= (uint32_t)block_size(block);
+}
+
+/**
+ * @brief First non-empty bin at or above (fl, sl), via the bitmaps
+ */
+static tlsf_block_t * search_suitable_block(uint32_t fl, uint32_t sl) {
+  uint32_t sl_map;
+
+  if (fl >= TLSF_FL_COUNT) {
+    return NULL;
+  }
+  sl_map = tlsf_sl_bitmap[fl] & (~0u << sl);
+  if (!sl_map) {
+    uint32_t fl_map = (fl + 1 < 32) ? (tlsf_fl_bitmap & (~0u << (fl + 1))) : 0;
+    if (!fl_map) {
+      return NULL;
+    }
+    fl = tlsf_ffs(fl_map);
+    sl_map = tlsf_sl_bitmap[fl];
+  }
+  return tlsf_bins[fl][tlsf_ffs(sl_map)];
+}
+
+int8_t tlsf_init(void * mem, size_t bytes) {
+  uintptr_t start = ((uintptr_t)mem + TLSF_ALIGN - 1) & ~(uintptr_t)(TLSF_ALIGN - 1);
+  uintptr_t end = ((uintptr_t)mem + bytes) & ~(uintptr_t)(TLSF_ALIGN - 1);
+  tlsf_block_t * block;
+  tlsf_block_t * sentinel;
+  size_t size;
+
+  for (uint32_t fl = 0; fl < TLSF_FL_COUNT; fl++) {
+    tlsf_sl_bitmap[fl] = 0;
+    for (uint32_t sl = 0; sl < TLSF_SL_COUNT; sl++) {
+      tlsf_bins[fl][sl] = NULL;
+    }
+  }
+  tlsf_fl_bitmap = 0;
+  tlsf_stats = (tlsf_stats_t){0};
+  tlsf_ready = 1;
+
+  /* One free block spanning the region, then the sentinel header */
+  if (end <= start || end - start < 2 * TLSF_OVERHEAD + TLSF_BLOCK_MIN) {
+    return -1;
+  }
+  size = (size_t)(end - start) - 2 * TLSF_OVERHEAD;
+  if (size > TLSF_BLOCK_MAX) {
+    size = TLSF_BLOCK_MAX;
+  }
+
+  block = (tlsf_block_t *)start;
+  block->prev_phys = NULL;
+  block->size = size | TLSF_FREE_BIT;
+
+  sentinel = block_next(block);
+  sentinel->prev_phys = block;
+  sentinel->size = TLSF_PREV_FREE_BIT;
+
+  tlsf_stats.total_bytes = (uint32_t)size;
+  insert_free_block(block);
+  return 0;
+}
+
+void * tlsf_alloc(size_t size) {
+  tlsf_block_t * block;
+  tlsf_block_t * next;
+  uint32_t fl, sl;
+  size_t adjust;
+
+  if (!tlsf_ready) {
+    tlsf_init(TLSF_REGION_START, TLSF_REGION_BYTES);
+  }
+
+  if (size > TLSF_BLOCK_MAX) {
+    tlsf_stats.failures++;
+    return NULL;
+  }
+  adjust = (size + TLSF_ALIGN - 1) & ~(TLSF_ALIGN - 1);
+  if (adjust < TLSF_BLOCK_MIN) {
+    adjust = TLSF_BLOCK_MIN;
+  }
+
+  mapping_search(adjust, &fl, &sl);
+  block = search_suitable_block(fl, sl);
+  if (!block) {
+    tlsf_stats.failures++;
+    return NULL;
+  }
+  remove_free_block(block);
+
+  /* Split off the remainder when it can hold a free block of its own */
+  next = block_next(block);
+  if (block_size(block) >= adjust + sizeof(tlsf_block_t)) {
+    tlsf_block_t * rest = (tlsf_block_t *)(block_payload(block) + adjust);
+
+    rest->prev_phys = block;
+    rest->size = (block_size(block) - adjust - TLSF_OVERHEAD) | TLSF_FREE_BIT;
+    block->size = adjust | (block->size & TLSF_FLAG_MASK);
+    next->prev_phys = rest;
+    insert_free_block(rest);
+  } else {
+    next->size &= ~TLSF_PREV_FREE_BIT;
+  }
+  block->size &= ~TLSF_FREE_BIT;
+
+  tlsf_stats.used_bytes += (uint32_t)block_size(block);
+  if (tlsf_stats.used_bytes > tlsf_stats.high_water) {
+    tlsf_stats.high_water = tlsf_stats.used_bytes;
+  }
+  return block_payload(block);
+}
+
+void tlsf_free(void * ptr) {
+  tlsf_block_t * block;
+  tlsf_block_t * next;
+
+  if (!ptr) {
+    return;
+  }
+  block = block_from_payload(ptr);
+  tlsf_stats.used_bytes -= (uint32_t)block_size(block);
+
+  /* Merge with the previous block */
+  if (block->size & TLSF_PREV_FREE_BIT) {
+    tlsf_block_t * prev = block->prev_phys;
+    remove_free_block(prev);
+    prev->size += block_size(block) + TLSF_OVERHEAD;
+    block = prev;
+  }
+
+  /* Merge with the next block */
+  next = block_next(block);
+  if (next->size & TLSF_FREE_BIT) {
+    remove_free_block(next);
+    block->size += block_size(next) + TLSF_OVERHEAD;
+    next = block_next(block);
+  }
+
+  block->size |= TLSF_FREE_BIT;
+  next->prev_phys = block;
+  next->size |= TLSF_PREV_FREE_BIT;
+  insert_free_block(block);
+}
+
+int32_t * tlsf_reserve_words(size_t length) {
+  return (int32_t *)tlsf_alloc(length * sizeof(int32_t));
+}
+
+void tlsf_free_words(int32_t * src) {
+  tlsf_free(src);
+}
+
+void tlsf_get_stats(tlsf_stats_t * stats) {
+  if (!tlsf_ready) {
+    tlsf_init(TLSF_REGION_START, TLSF_REGION_BYTES);
+  }
+
+  tlsf_stats.largest_free = 0;
+  if (tlsf_fl_bitmap) {
+    /* The largest block is somewhere in the highest non-empty bin */
+    uint32_t fl = tlsf_fls(tlsf_fl_bitmap);
+    uint32_t sl = tlsf_fls(tlsf_sl_bitmap[fl]);
+    for (tlsf_block_t * b = tlsf_bins[fl][sl]; b; b = b->next_free) {
+      if (block_size(b) > tlsf_stats.largest_free) {
+        tlsf_stats.largest_free = (uint32_t)block_size(b);
+      }
+    }
+  }
+  tlsf_stats.fragmentation_pct = tlsf_stats.free_bytes ?
+    100u - (uint32_t)((100ULL * tlsf_stats.largest_free) / tlsf_stats.free_bytes) : 0;
+
+  *stats = tlsf_stats;
+}
+
+void print_tlsf_stats(void) {
+#ifdef VERBOSE
+  tlsf_stats_t s;
+
+  tlsf_get_stats(&s);
+  PRINTF("\nTLSF heap (%u bytes):\n", (unsigned)s.total_bytes);
+  PRINTF("  Used: %u, free: %u, high-water: %u\n", (unsigned)s.used_bytes,
+         (unsigned)s.free_bytes, (unsigned)s.high_water);
+  PRINTF("  Free blocks: %u, largest: %u, fragmentation: %u%%\n",
+         (unsigned)s.free_blocks, (unsigned)s.largest_free,
+         (unsigned)s.fragmentation_pct);
+  PRINTF("  Failed requests: %u\n", (unsigned)s.failures);
+#endif
+}
@@ -0,0 +1,216 @@
+/*****************************************************************************
+ * @file tpool.c
+ * @brief Implementation of the worker thread pool (HOST)
+ *
+ * Workers sleep on a condition variable until a job is published under the
+ * pool lock with a new generation number. Every participant then claims
+ * task indices with an atomic fetch-and-add until they run out, and workers
+ * report back through a done counter the caller waits on. A second lock
+ * serialises jobs, so only one is published at a time.
+ *
+ * This code was written as part of the Introduction to Embedded Systems
+ * Software and Development Environments course (University of Colorado Boulder).
+ *
+ * @author Timofei Alekseenko
+ * @date October 17, 2026
+ *
+ *****************************************************************************/
+
+#define _POSIX_C_SOURCE 200809L   /* sysconf, pthread condition variables */
+
+#include "tpool.h"
+#include <stdint.h>
+#include <stddef.h>
+#include <unistd.h>
+#include <pthread.h>
+
+typedef struct {
+  tpool_task_t task;
+  void * arg;
+  uint32_t count;
+  uint32_t next;            /* Next unclaimed index (atomic) */
+} tpool_job_t;
+
+static pthread_mutex_t tpool_lock = PTHREAD_MUTEX_INITIALIZER;
+static pthread_mutex_t tpool_run_lock = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t tpool_work = PTHREAD_COND_INITIALIZER;
+static pthread_cond_t tpool_done = PTHREAD_COND_INITIALIZER;
+static pthread_t tpool_workers[TPOOL_MAX_THREADS - 1];
+
+static tpool_job_t tpool_job;
+static uint32_t tpool_generation = 0;   /* Bumped per published job */
+static uint32_t tpool_base = 0;         /* Generation when workers started */
+static uint32_t tpool_finished = 0;     /* Workers done with this job */
+static uint32_t tpool_worker_count = 0;
+static uint32_t tpool_published = 0;    /* Threads incl. caller, 0: not
+                                           started (atomic) */
+static uint8_t tpool_started = 0;
+static uint8_t tpool_stopping = 0;
+
+/* Set in pool threads and while a caller runs tasks: nested jobs go serial */
+static __thread uint8_t tpool_inside = 0;
+
+/**
+ * @brief Claim and run task indices until the job has none left
+ */
+static void tpool_drain(tpool_job_t * job) {
+  for (;;) {
+    uint32_t i = __atomic_fetch_add(&job->next, 1, __ATOMIC_RELAXED);
+    if (i >= job->count) {
+      break;
+    }
+    job->task(job->arg, i);
+  }
+}
+
+static void * tpool_worker(void * unused) {
+  uint32_t seen;
+
+  (void)unused;
+  tpool_inside = 1;
+  pthread_mutex_lock(&tpool_lock);
+  /* Not tpool_generation: a job may already be out by the time we run */
+  seen = tpool_base;
+  for (;;) {
+    while (tpool_generation == seen && !tpool_stopping) {
+      pthread_cond_wait(&tpool_work, &tpool_lock);
+    }
+    if (tpool_stopping) {
+      break;
+    }
+    seen = tpool_generation;
+    pthread_mutex_unlock(&tpool_lock);
+
+    tpool_drain(&tpool_job);
+
+    pthread_mutex_lock(&tpool_lock);
+    if (++tpool_finished == tpool_worker_count) {
+      pthread_cond_signal(&tpool_done);
+    }
+  }
+  pthread_mutex_unlock(&tpool_lock);
+  return NULL;
+}
+
+/* Caller holds tpool_run_lock */
+static void tpool_stop_locked(void) {
+  uint32_t workers;
+
+  pthread_mutex_lock(&tpool_lock);
+  tpool_stopping = 1;
+  workers = tpool_worker_count;
+  pthread_cond_broadcast(&tpool_work);
+  pthread_mutex_unlock(&tpool_lock);
+
+  for (uint32_t i = 0; i < workers; i++) {
+    pthread_join(tpool_workers[i], NULL);
+  }
+  __atomic_store_n(&tpool_published, 0, __ATOMIC_RELEASE);
+  tpool_worker_count = 0;
+  tpool_stopping = 0;
+  tpool_started = 0;
+}
+
+/* Caller holds tpool_run_lock */
+static int8_t tpool_start_locked(uint32_t threads) {
+  if (threads == 0) {
+    long cpus = sysconf(_SC_NPROCESSORS_ONLN);
+    threads = cpus > 0 ? (uint32_t)cpus : 1;
+  }
+  if (threads > TPOOL_MAX_THREADS) {
+    threads = TPOOL_MAX_THREADS;
+  }
+
+  tpool_started = 1;
+  tpool_base = tpool_generation;
+  while (tpool_worker_count + 1 < threads) {
+    if (pthread_create(&tpool_workers[tpool_worker_count], NULL,
+                       tpool_worker, NULL) != 0) {
+      break;
+    }
+    tpool_worker_count++;
+  }
+  __atomic_store_n(&tpool_published, tpool_worker_count + 1, __ATOMIC_RELEASE);
+  return (threads > 1 && tpool_worker_count == 0) ? -1 : 0;
+}
+
+int8_t tpool_init(uint32_t threads) {
+  int8_t status;
+
+  pthread_mutex_lock(&tpool_run_lock);
+  if (tpool_started) {
+    tpool_stop_locked();
+  }
+  status = tpool_start_locked(threads);
+  pthread_mutex_unlock(&tpool_run_lock);
+  return status;
+}
+
+uint32_t tpool_threads(void) {
+  uint32_t threads;
+
+  /* Inside a task tpool_run_lock may be held and nested jobs run serially;
+     otherwise a started pool answers without the lock */
+  if (tpool_inside) {
+    return 1;
+  }
+  threads = __atomic_load_n(&tpool_published, __ATOMIC_ACQUIRE);
+  if (threads != 0) {
+    return threads;
+  }
+
+  pthread_mutex_lock(&tpool_run_lock);
+  if (!tpool_started) {
+    tpool_start_locked(0);
+  }
+  threads = tpool_worker_count + 1;
+  pthread_mutex_unlock(&tpool_run_lock);
+  return threads;
+}
+
+void tpool_run(tpool_task_t task, void * arg, uint32_t count) {
+  if (count == 0) {
+    return;
+  }
+  if (tpool_inside || count == 1) {
+    for (uint32_t i = 0; i < count; i++) {
+      task(arg, i);
+    }
+    return;
+  }
+
+  pthread_mutex_lock(&tpool_run_lock);
+  if (!tpool_started) {
+    tpool_start_locked(0);
+  }
+
+  pthread_mutex_lock(&tpool_lock);
+  tpool_job.task = task;
+  tpool_job.arg = arg;
+  tpool_job.count = count;
+  tpool_job.next = 0;
+  tpool_finished = 0;
+  tpool_generation++;
+  pthread_cond_broadcast(&tpool_work);
+  pthread_mutex_unlock(&tpool_lock);
+
+  /* The caller works too, then waits for the workers to check in */
+  tpool_inside = 1;
+  tpool_drain(&tpool_job);
+  tpool_inside = 0;
+
+  pthread_mutex_lock(&tpool_lock);
+  while (tpool_finished < tpool_worker_count) {
+    pthread_cond_wait(&tpool_done, &tpool_lock);
+  }
+  pthread_mutex_unlock(&tpool_lock);
+  pthread_mutex_unlock(&tpool_run_lock);
+}
+
+void tpool_shutdown(void) {
+  pthread_mutex_lock(&tpool_run_lock);
+  if (tpool_started) {
+    tpool_stop_locked();
+  }
+  pthread_mutex_unlock(&tpool_run_lock);
+}